@@ -90,6 +90,13 @@ namespace dynamo
      */
     virtual void applyBC(Vector  &pos, const double& dt) const = 0;
 
+    /*! \brief Returns true if the applyBC functions may be called
+        concurrently from several threads.
+
+	\sa Interaction::concurrentEvents
+     */
+    virtual bool concurrentEvents() const { return false; }
+
     /*! \brief Stream the boundary conditions forward in time.*/
     virtual void update(const double&) {};
 
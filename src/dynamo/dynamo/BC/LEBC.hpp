@@ -42,6 +42,9 @@ namespace dynamo {
 
     virtual void operator<<(const magnet::xml::Node&);
 
+    //! The sheared images are not cleared for parallel prediction.
+    virtual bool concurrentEvents() const { return false; }
+
     virtual void applyBC(Vector&) const; 
 
     virtual void applyBC(Vector&, Vector&) const;
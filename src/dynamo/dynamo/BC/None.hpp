@@ -31,6 +31,8 @@ namespace dynamo {
     BCNone(const dynamo::Simulation*);
   
     virtual ~BCNone();
+
+    virtual bool concurrentEvents() const { return true; }
     
     virtual void applyBC(Vector&)const;
 
@@ -30,6 +30,8 @@ namespace dynamo {
   public:
     BCPeriodic(const dynamo::Simulation*);
 
+    virtual bool concurrentEvents() const { return true; }
+
     virtual void applyBC(Vector &) const;
   
     virtual void applyBC(Vector &, Vector &) const;
@@ -0,0 +1,237 @@
+/*  dynamo:- Event driven molecular dynamics simulator 
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <dynamo/binaryConfig.hpp>
+#include <magnet/exception.hpp>
+#include <fstream>
+#include <cstring>
+
+namespace dynamo {
+  namespace {
+    const char binaryConfigMagic[8] = {'D', 'Y', 'N', 'A', 'M', 'O', 'B', 'C'};
+    const uint64_t binaryConfigVersion = 1;
+
+    struct BinaryConfigHeader
+    {
+      char magic[8];
+      uint64_t version;
+      uint64_t xmlOffset;
+      uint64_t xmlSize;
+    };
+
+    static_assert(sizeof(BinaryConfigHeader) == 32, "Unexpected padding in the binary config header");
+
+    //The arrays are stored in the native byte order, which must be
+    //little-endian.
+    void checkHostByteOrder()
+    {
+      const uint16_t probe = 1;
+      if (*reinterpret_cast<const uint8_t*>(&probe) != 1)
+	M_throw() << "Binary configuration files are only supported on little-endian hosts";
+    }
+
+    uint64_t alignOffset(uint64_t offset)
+    { return (offset + 7) & ~uint64_t(7); }
+
+    void writePadding(std::ostream& os)
+    {
+      const char zeros[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+      os.write(zeros, alignOffset(os.tellp()) - uint64_t(os.tellp()));
+    }
+  }
+
+  bool 
+  isBinaryConfigFile(const std::string& fileName)
+  {
+    return (fileName.size() >= 5) 
+      && (std::string(fileName.end() - 5, fileName.end()) == ".dbin");
+  }
+
+  BinaryConfigReader::BinaryConfigReader(const std::string& fileName)
+  {
+    checkHostByteOrder();
+
+    try {
+      _file.open(fileName);
+    } catch (std::exception& err)
+      {
+	M_throw() << "Failed to map the binary config file " << fileName << "\n" << err.what();
+      }
+
+    if (_file.size() < sizeof(BinaryConfigHeader))
+      M_throw() << "The binary config file " << fileName << " is truncated";
+
+    BinaryConfigHeader header;
+    std::memcpy(&header, _file.data(), sizeof(header));
+
+    if (std::memcmp(header.magic, binaryConfigMagic, sizeof(binaryConfigMagic)))
+      M_throw() << fileName << " is not a binary config file";
+
+    if (header.version != binaryConfigVersion)
+      M_throw() << "The binary config file " << fileName << " has an unsupported version (" 
+		<< header.version << ")";
+
+    if ((header.xmlOffset > _file.size()) || (header.xmlSize > _file.size() - header.xmlOffset))
+      M_throw() << "The binary config file " << fileName << " is truncated";
+
+    _xmlOffset = header.xmlOffset;
+    _xmlSize = header.xmlSize;
+  }
+
+  std::string
+  BinaryConfigReader::getXMLData() const
+  { return std::string(_file.data() + _xmlOffset, _xmlSize); }
+
+  const char* 
+  BinaryConfigReader::getArray(const magnet::xml::Node& particleData, const std::string& tag, const std::string& name,
+			       const std::string& type, size_t typeSize, size_t components) const
+  {
+    const uint64_t N = particleData.getAttribute("N").as<uint64_t>();
+    
+    for (magnet::xml::Node node = particleData.fastGetNode(tag.c_str()); node.valid(); ++node)
+      if (node.getAttribute("Name").getValue() == name)
+	{
+	  if (node.getAttribute("Type").getValue() != type)
+	    M_throw() << "The binary config array \"" << name << "\" has type " << node.getAttribute("Type").getValue()
+		      << ", expected " << type;
+
+	  if (node.getAttribute("Components").as<size_t>() != components)
+	    M_throw() << "The binary config array \"" << name << "\" has " << node.getAttribute("Components").as<size_t>() 
+		      << " components, expected " << components;
+
+	  const uint64_t offset = node.getAttribute("Offset").as<uint64_t>();
+	  const uint64_t size = N * components * typeSize;
+	  if ((offset % 8) || (offset > _file.size()) || (size > _file.size() - offset))
+	    M_throw() << "The binary config array \"" << name << "\" lies outside the file";
+	  
+	  return _file.data() + offset;
+	}
+
+    return NULL;
+  }
+
+  BinaryConfigWriter::BinaryConfigWriter(shared_ptr<const Dynamics::ParticleSnapshot> snapshot):
+    _snapshot(snapshot),
+    _xmlOffset(sizeof(BinaryConfigHeader))
+  {
+    addArray("Array", "Position", "Float64", sizeof(double), NDIM);
+    addArray("Array", "Velocity", "Float64", sizeof(double), NDIM);
+    addArray("Array", "Static", "UInt8", sizeof(uint8_t), 1);
+
+    if (!_snapshot->orientationData.empty())
+      {
+	addArray("Array", "Orientation", "Float64", sizeof(double), 4);
+	addArray("Array", "AngularVelocity", "Float64", sizeof(double), NDIM);
+      }
+
+    for (const auto& property : _snapshot->properties)
+      addArray("PropertyArray", property.first, "Float64", sizeof(double), 1);
+  }
+
+  void
+  BinaryConfigWriter::addArray(const std::string& tag, const std::string& name, const std::string& type, 
+			       size_t typeSize, size_t components)
+  {
+    Array array = {tag, name, type, components, _xmlOffset, _snapshot->particles.size() * components * typeSize};
+    _arrays.push_back(array);
+    _xmlOffset = alignOffset(array.offset + array.size);
+  }
+
+  void 
+  BinaryConfigWriter::outputXML(magnet::xml::XmlStream& XML) const
+  {
+    XML << magnet::xml::tag("ParticleData")
+	<< magnet::xml::attr("Format") << "Binary"
+	<< magnet::xml::attr("N") << _snapshot->particles.size();
+  
+    if (!_snapshot->orientationData.empty())
+      XML << magnet::xml::attr("OrientationData") << "Y";
+
+    for (const Array& array : _arrays)
+      XML << magnet::xml::tag(array.tag)
+	  << magnet::xml::attr("Name") << array.name
+	  << magnet::xml::attr("Type") << array.type
+	  << magnet::xml::attr("Components") << array.components
+	  << magnet::xml::attr("Offset") << array.offset
+	  << magnet::xml::endtag(array.tag);
+
+    XML << magnet::xml::endtag("ParticleData");
+  }
+
+  void 
+  BinaryConfigWriter::write(const std::string& fileName, const std::string& xmlData) const
+  {
+    checkHostByteOrder();
+
+    std::ofstream os(fileName.c_str(), std::ios::binary | std::ios::trunc);
+    if (!os)
+      M_throw() << "Failed to open " << fileName << " for writing";
+
+    BinaryConfigHeader header;
+    std::memcpy(header.magic, binaryConfigMagic, sizeof(binaryConfigMagic));
+    header.version = binaryConfigVersion;
+    header.xmlOffset = _xmlOffset;
+    header.xmlSize = xmlData.size();
+    os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    const Dynamics::ParticleSnapshot& snapshot = *_snapshot;
+    const size_t N = snapshot.particles.size();
+
+    //The arrays are written in the order they were added in the
+    //constructor.
+    for (size_t i(0); i < N; ++i)
+      os.write(reinterpret_cast<const char*>(&snapshot.particles[i].getPosition()[0]), NDIM * sizeof(double));
+    writePadding(os);
+
+    for (size_t i(0); i < N; ++i)
+      os.write(reinterpret_cast<const char*>(&snapshot.particles[i].getVelocity()[0]), NDIM * sizeof(double));
+    writePadding(os);
+
+    for (size_t i(0); i < N; ++i)
+      os.put(!snapshot.particles[i].testState(Particle::DYNAMIC));
+    writePadding(os);
+
+    if (!snapshot.orientationData.empty())
+      {
+	for (size_t i(0); i < N; ++i)
+	  {
+	    const Quaternion& q = snapshot.orientationData[i].orientation;
+	    const double data[4] = {q.imaginary()[0], q.imaginary()[1], q.imaginary()[2], q.real()};
+	    os.write(reinterpret_cast<const char*>(data), sizeof(data));
+	  }
+	writePadding(os);
+
+	for (size_t i(0); i < N; ++i)
+	  os.write(reinterpret_cast<const char*>(&snapshot.orientationData[i].angularVelocity[0]), NDIM * sizeof(double));
+	writePadding(os);
+      }
+
+    for (const auto& property : snapshot.properties)
+      {
+	os.write(reinterpret_cast<const char*>(property.second.data()), N * sizeof(double));
+	writePadding(os);
+      }
+
+    if (uint64_t(os.tellp()) != _xmlOffset)
+      M_throw() << "Binary config layout mismatch while writing " << fileName;
+
+    os.write(xmlData.data(), xmlData.size());
+
+    if (!os)
+      M_throw() << "Failed to write the binary config file " << fileName;
+  }
+}
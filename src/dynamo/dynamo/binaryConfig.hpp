@@ -0,0 +1,127 @@
+/*  dynamo:- Event driven molecular dynamics simulator 
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <dynamo/dynamics/dynamics.hpp>
+#include <magnet/xmlreader.hpp>
+#include <magnet/xmlwriter.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace dynamo {
+  /*! \brief Test if a file name has the extension of the binary
+      configuration format (".dbin").
+   */
+  bool isBinaryConfigFile(const std::string& fileName);
+
+  /*! \brief Reads a configuration file in the binary format.
+
+    A binary configuration holds the same information as the XML
+    configuration file, but the per-particle data (positions,
+    velocities, orientations and the values of per-particle
+    Property-s) are stored as raw little-endian arrays. The file is
+    laid out as a fixed size header, followed by the arrays (each
+    aligned to 8 bytes), and finally the XML metadata. The metadata is
+    a complete XML configuration, except the ParticleData tag
+    contains a directory of the arrays in place of the Pt tags:
+
+    \code
+    <ParticleData Format="Binary" N="1000">
+      <Array Name="Position" Type="Float64" Components="3" Offset="32"/>
+      ...
+      <PropertyArray Name="D" Type="Float64" Components="1" Offset="..."/>
+    </ParticleData>
+    \endcode
+
+    The file is memory mapped, so the arrays are read directly from
+    the page cache without any parsing. The returned arrays are only
+    valid while the reader exists.
+   */
+  class BinaryConfigReader
+  {
+  public:
+    BinaryConfigReader(const std::string& fileName);
+
+    //! \brief Returns a copy of the XML metadata.
+    std::string getXMLData() const;
+
+    /*! \brief Returns an array of doubles described in the
+        ParticleData tag, or NULL if it is not present.
+	
+	\param particleData The ParticleData tag of the metadata.
+	\param tag The tag name of the array (Array or PropertyArray).
+	\param name The Name attribute of the array.
+	\param components The expected number of values per particle.
+     */
+    const double* getFloat64Array(const magnet::xml::Node& particleData, const std::string& tag, 
+				  const std::string& name, size_t components) const
+    { return reinterpret_cast<const double*>(getArray(particleData, tag, name, "Float64", sizeof(double), components)); }
+
+    //! \brief Returns an array of bytes (see getFloat64Array()).
+    const uint8_t* getUInt8Array(const magnet::xml::Node& particleData, const std::string& tag, 
+				 const std::string& name, size_t components) const
+    { return reinterpret_cast<const uint8_t*>(getArray(particleData, tag, name, "UInt8", sizeof(uint8_t), components)); }
+
+  private:
+    const char* getArray(const magnet::xml::Node& particleData, const std::string& tag, const std::string& name, 
+			 const std::string& type, size_t typeSize, size_t components) const;
+
+    boost::iostreams::mapped_file_source _file;
+    uint64_t _xmlOffset;
+    uint64_t _xmlSize;
+  };
+
+  /*! \brief Writes a configuration file in the binary format.
+
+    The layout of the arrays is determined on construction, so the
+    array directory can be written into the XML metadata (using
+    outputXML()) before the file itself is written (using write()).
+    
+    \sa BinaryConfigReader
+   */
+  class BinaryConfigWriter
+  {
+  public:
+    BinaryConfigWriter(shared_ptr<const Dynamics::ParticleSnapshot> snapshot);
+
+    //! \brief Write the ParticleData tag, containing the array directory.
+    void outputXML(magnet::xml::XmlStream& XML) const;
+
+    //! \brief Write the binary file, with the passed XML metadata.
+    void write(const std::string& fileName, const std::string& xmlData) const;
+
+  private:
+    struct Array
+    {
+      std::string tag;
+      std::string name;
+      std::string type;
+      size_t components;
+      uint64_t offset;
+      uint64_t size;
+    };
+
+    void addArray(const std::string& tag, const std::string& name, const std::string& type, 
+		  size_t typeSize, size_t components);
+
+    shared_ptr<const Dynamics::ParticleSnapshot> _snapshot;
+    std::vector<Array> _arrays;
+    uint64_t _xmlOffset;
+  };
+}
@@ -19,6 +19,7 @@
 #include <dynamo/coordinator/engine/replexer.hpp>
 #include <dynamo/inputplugins/compression.hpp>
 #include <dynamo/systems/tHalt.hpp>
+#include <dynamo/systems/snapshot.hpp>
 #include <dynamo/systems/visualizer.hpp>
 #include <limits>
 
@@ -50,6 +51,7 @@ namespace dynamo {
        "Sets the system time inbetween saving snapshots of the system.")
       ("snapshot-events", boost::program_options::value<size_t>(),
        "Sets the event count inbetween saving snapshots of the system.")
+      ("async-snapshots", "Format, compress and write the snapshots on a background thread while the simulation continues.")
       ;
   
     opts.add(simopts);
@@ -98,6 +100,11 @@ namespace dynamo {
     else
       Sim.eventPrintInterval = vm["events"].as<size_t>();
     
+    //The replica exchange engine runs each Simulation in the
+    //ThreadPool, so they cannot use it themselves
+    if (dynamic_cast<const EReplicaExchangeSimulation*>(this) == NULL)
+      Sim.threadPool = &threads;
+
     if (vm.count("sim-end-time") && (dynamic_cast<const EReplicaExchangeSimulation*>(this) == NULL))
       Sim.systems.push_back(shared_ptr<System>(new SystHalt(&Sim, vm["sim-end-time"].as<double>(), "SystemStopEvent")));
 
@@ -115,4 +122,11 @@ namespace dynamo {
       //Just add the bare minimum outputplugin
       Sim.addOutputPlugin("Misc");
   }
+
+  shared_ptr<System> 
+  Engine::configureSnapshot(SysSnapshot* snapshot) const
+  {
+    snapshot->setAsync(vm.count("async-snapshots"));
+    return shared_ptr<System>(snapshot);
+  }
 }
@@ -26,6 +26,8 @@
 namespace magnet { namespace thread { class ThreadPool; } }
 
 namespace dynamo {
+  class SysSnapshot;
+
   /*! \brief An engine to control/manipulate one or more Simulation's.
    *
    * Engine is a virtual base class interface for many different
@@ -128,6 +130,11 @@ namespace dynamo {
      */
     virtual void postSimInit(Simulation&) {}
 
+    /*! \brief Applies the common snapshot options to a newly created
+     * SysSnapshot, ready to be added to a Simulation.
+     */
+    shared_ptr<System> configureSnapshot(SysSnapshot* snapshot) const;
+
     /*! \brief A reference to the Coordinators parsed command line variables.
      */
     const boost::program_options::variables_map& vm;
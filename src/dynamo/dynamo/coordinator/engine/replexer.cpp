@@ -81,10 +81,10 @@ namespace dynamo {
 		 vm["config-file"].as<std::vector<std::string> >()[i]);
 
 	if (vm.count("snapshot"))
-	  Simulations[i].systems.push_back(shared_ptr<System>(new SysSnapshot(&(Simulations[i]), vm["snapshot"].as<double>(), "SnapshotEvent", "ID%ID.%COUNT", !vm.count("unwrapped"))));
+	  Simulations[i].systems.push_back(configureSnapshot(new SysSnapshot(&(Simulations[i]), vm["snapshot"].as<double>(), "SnapshotEvent", "ID%ID.%COUNT", !vm.count("unwrapped"))));
 
 	if (vm.count("snapshot-events"))
-	  Simulations[i].systems.push_back(shared_ptr<System>(new SysSnapshot(&(Simulations[i]), vm["snapshot-events"].as<size_t>(), "SnapshotEventTimer", "%COUNTe", !vm.count("unwrapped"))));
+	  Simulations[i].systems.push_back(configureSnapshot(new SysSnapshot(&(Simulations[i]), vm["snapshot-events"].as<size_t>(), "SnapshotEventTimer", "%COUNTe", !vm.count("unwrapped"))));
 
 	Simulations[i].initialise();
 
@@ -333,6 +333,10 @@ namespace dynamo {
   void
   EReplicaExchangeSimulation::outputData()
   {
+    //Report any failed snapshot before the final output
+    for (size_t i = 0; i < nSims; ++i)
+      Simulations[i].waitForBackgroundWrites();
+
     {
       std::fstream replexof("replex.dat",std::ios::out | std::ios::trunc);
     
@@ -99,10 +99,10 @@ namespace dynamo {
     setupSim(simulation, vm["config-file"].as<std::vector<std::string> >()[0]);
 
     if (vm.count("snapshot"))
-      simulation.systems.push_back(shared_ptr<System>(new SysSnapshot(&simulation, vm["snapshot"].as<double>(), "SnapshotTimer", "%COUNT", !vm.count("unwrapped"))));
+      simulation.systems.push_back(configureSnapshot(new SysSnapshot(&simulation, vm["snapshot"].as<double>(), "SnapshotTimer", "%COUNT", !vm.count("unwrapped"))));
 
     if (vm.count("snapshot-events"))
-      simulation.systems.push_back(shared_ptr<System>(new SysSnapshot(&simulation, vm["snapshot-events"].as<size_t>(), "SnapshotEventTimer", "%COUNTe", !vm.count("unwrapped"))));
+      simulation.systems.push_back(configureSnapshot(new SysSnapshot(&simulation, vm["snapshot-events"].as<size_t>(), "SnapshotEventTimer", "%COUNTe", !vm.count("unwrapped"))));
 
     simulation.initialise();
 
@@ -116,6 +116,8 @@ namespace dynamo {
   void
   ESingleSimulation::outputData()
   {
+    //Report any failed snapshot before the final output
+    simulation.waitForBackgroundWrites();
     simulation.outputData(outputFormat.c_str());
   }
 
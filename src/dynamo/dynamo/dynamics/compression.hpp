@@ -33,6 +33,8 @@ namespace dynamo {
   public:
     DynCompression(dynamo::Simulation*, double);
     virtual double SphereSphereInRoot(const Particle& p1, const Particle& p2, double d) const;
+    virtual void SphereSphereInRoots(const Particle& p1, const size_t* ids, const double* d, size_t N, double* dt) const
+    { Dynamics::SphereSphereInRoots(p1, ids, d, N, dt); }
     virtual double SphereSphereOutRoot(const Particle& p1, const Particle& p2, double d) const;  
     virtual std::pair<bool, double> getOffcentreSpheresCollision(const double offset1, const double diameter1, const double offset2, const double diameter2, const Particle& p1, const Particle& p2, double t_max, double maxdist) const;
     virtual double sphereOverlap(const Particle& p1, const Particle& p2, const double& d) const;
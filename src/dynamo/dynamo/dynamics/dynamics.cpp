@@ -21,6 +21,8 @@
 #include <dynamo/NparticleEventData.hpp>
 #include <dynamo/units/units.hpp>
 #include <dynamo/BC/LEBC.hpp>
+#include <dynamo/binaryConfig.hpp>
+#include <dynamo/streamingConfig.hpp>
 #include <magnet/xmlwriter.hpp>
 #include <magnet/xmlreader.hpp>
 #include <cstring>
@@ -101,46 +103,107 @@ namespace dynamo {
 					 double t_max, double maxdist) const
   { M_throw() << "Not implemented for this Dynamics."; }
 
+  void
+  Dynamics::SphereSphereInRoots(const Particle& p1, const size_t* ids, const double* d, size_t N, double* dt) const
+  {
+    for (size_t i(0); i < N; ++i)
+      dt[i] = SphereSphereInRoot(p1, Sim->particles[ids[i]], d[i]);
+  }
+
   double 
   Dynamics::getPBCSentinelTime(const Particle&, const double&) const
   { M_throw() << "Not implemented for this Dynamics."; }
 
-  void 
-  Dynamics::loadParticleXMLData(const magnet::xml::Node& XML)
+  void
+  Dynamics::loadParticleBinaryData(const BinaryConfigReader& file, const magnet::xml::Node& particleData)
   {
-    dout << "Loading Particle Data" << std::endl;
+    dout << "Loading Binary Particle Data" << std::endl;
 
-    bool outofsequence = false;  
-  
-    for (magnet::xml::Node node = XML.getNode("ParticleData").fastGetNode("Pt"); 
-	 node.valid(); ++node)
+    const size_t N = particleData.getAttribute("N").as<size_t>();
+    const double* positions = file.getFloat64Array(particleData, "Array", "Position", NDIM);
+    const double* velocities = file.getFloat64Array(particleData, "Array", "Velocity", NDIM);
+    const uint8_t* isStatic = file.getUInt8Array(particleData, "Array", "Static", 1);
+
+    if (!positions || !velocities)
+      M_throw() << "The binary config file is missing the particle positions or velocities";
+
+    Sim->species.invalidateCache();
+    Sim->particles.reserve(N);
+    for (size_t i(0); i < N; ++i)
       {
-	if (!node.hasAttribute("ID")
-	    || node.getAttribute("ID").as<size_t>() != Sim->particles.size())
-	  outofsequence = true;
-      
-	Particle part(node, Sim->particles.size());
-	part.getVelocity() *= Sim->units.unitVelocity();
-	part.getPosition() *= Sim->units.unitLength();
+	Vector pos, vel;
+	for (size_t iDim(0); iDim < NDIM; ++iDim)
+	  {
+	    pos[iDim] = positions[NDIM * i + iDim];
+	    vel[iDim] = velocities[NDIM * i + iDim];
+	  }
+
+	Particle part(pos * Sim->units.unitLength(), vel * Sim->units.unitVelocity(), i);
+	if (isStatic && isStatic[i])
+	  part.clearState(Particle::DYNAMIC);
 	Sim->particles.push_back(part);
       }
 
-    if (outofsequence)
+    dout << "Particle count " << Sim->N() << std::endl;
+
+    if (particleData.hasAttribute("OrientationData"))
+      {
+	const double* orientations = file.getFloat64Array(particleData, "Array", "Orientation", 4);
+	const double* angularVelocities = file.getFloat64Array(particleData, "Array", "AngularVelocity", NDIM);
+	if (!orientations || !angularVelocities)
+	  M_throw() << "The binary config file is missing the orientation data";
+
+	orientationData.resize(N);
+	for (size_t i(0); i < N; ++i)
+	  {
+	    const double* q = orientations + 4 * i;
+	    orientationData[i].orientation = Quaternion(q[3], q[0], q[1], q[2]);
+	    for (size_t iDim(0); iDim < NDIM; ++iDim)
+	      orientationData[i].angularVelocity[iDim] = angularVelocities[NDIM * i + iDim];
+
+	    //Makes the vector a unit vector
+	    orientationData[i].orientation.normalise();
+	    if (orientationData[i].orientation.nrm() == 0)
+	      M_throw() << "Particle " << i << " has an invalid zero orientation quaternion";
+	  }
+      }
+  }
+
+  void
+  Dynamics::loadParticleStreamData(StreamingConfigReader& file, const magnet::xml::Node& particleData)
+  {
+    dout << "Loading Streamed Particle Data" << std::endl;
+
+    if (file.particlesOutOfSequence())
       dout << "Particle ID's out of sequence!\n"
 	   << "This can result in incorrect capture map loads etc.\n"
 	   << "Erase any capture maps in the configuration file so they are regenerated." << std::endl;
 
+    Sim->species.invalidateCache();
+    Sim->particles.swap(file.getParticles());
+    for (Particle& part : Sim->particles)
+      {
+	part.getVelocity() *= Sim->units.unitVelocity();
+	part.getPosition() *= Sim->units.unitLength();
+      }
+
     dout << "Particle count " << Sim->N() << std::endl;
 
-    if (XML.getNode("ParticleData").hasAttribute("OrientationData"))
+    if (particleData.hasAttribute("OrientationData"))
       {
+	const double* orientations = file.getFloat64Array("U", 4);
+	const double* angularVelocities = file.getFloat64Array("O", NDIM);
+	if (!orientations || !angularVelocities)
+	  M_throw() << "The orientation (U) or angular velocity (O) is missing for some particles";
+
 	orientationData.resize(Sim->N());
-	size_t i(0);
-	for (magnet::xml::Node node = XML.getNode("ParticleData").fastGetNode("Pt"); node.valid(); ++node, ++i)
+	for (size_t i(0); i < Sim->N(); ++i)
 	  {
-	    orientationData[i].orientation << node.getNode("U");
-	    orientationData[i].angularVelocity << node.getNode("O");
-      
+	    const double* q = orientations + 4 * i;
+	    orientationData[i].orientation = Quaternion(q[3], q[0], q[1], q[2]);
+	    for (size_t iDim(0); iDim < NDIM; ++iDim)
+	      orientationData[i].angularVelocity[iDim] = angularVelocities[NDIM * i + iDim];
+
 	    //Makes the vector a unit vector
 	    orientationData[i].orientation.normalise();
 	    if (orientationData[i].orientation.nrm() == 0)
@@ -149,28 +212,56 @@ namespace dynamo {
       }
   }
 
-  void 
-  Dynamics::outputParticleXMLData(magnet::xml::XmlStream& XML, bool applyBC) const
+  shared_ptr<Dynamics::ParticleSnapshot>
+  Dynamics::getParticleSnapshot(bool applyBC) const
   {
-    XML << magnet::xml::tag("ParticleData");
-  
-    if (hasOrientationData())
-      XML << magnet::xml::attr("OrientationData") << "Y";
+    shared_ptr<ParticleSnapshot> snapshot(new ParticleSnapshot);
+    snapshot->particles.reserve(Sim->N());
 
-    for (size_t i = 0; i < Sim->N(); ++i)
+    //The particles are written out in the order of their original
+    //IDs, so that any reordering is invisible in the output
+    std::vector<size_t> internalIDs(Sim->N());
+    for (size_t externalID = 0; externalID < Sim->N(); ++externalID)
       {
-	Particle tmp(Sim->particles[i]);
+	const size_t i = internalIDs[externalID] = Sim->getInternalID(externalID);
+	const Particle& part = Sim->particles[i];
+	Particle tmp(part.getPosition(), part.getVelocity(), externalID);
+	if (!part.testState(Particle::DYNAMIC))
+	  tmp.clearState(Particle::DYNAMIC);
+
 	if (applyBC) 
 	  Sim->BCs->applyBC(tmp.getPosition(), tmp.getVelocity());
       
 	tmp.getVelocity() *= (1.0 / Sim->units.unitVelocity());
 	tmp.getPosition() *= (1.0 / Sim->units.unitLength());
-      
-	XML << magnet::xml::tag("Pt");
-	Sim->_properties.outputParticleXMLData(XML, i);
-	XML << tmp;
+	snapshot->particles.push_back(tmp);
 
 	if (hasOrientationData())
+	  snapshot->orientationData.push_back(orientationData[i]);
+      }
+
+    snapshot->properties = Sim->_properties.getParticleDataSnapshot(internalIDs);
+    return snapshot;
+  }
+
+  void 
+  Dynamics::ParticleSnapshot::outputXML(magnet::xml::XmlStream& XML) const
+  {
+    XML << magnet::xml::tag("ParticleData");
+  
+    if (!orientationData.empty())
+      XML << magnet::xml::attr("OrientationData") << "Y";
+
+    for (size_t i = 0; i < particles.size(); ++i)
+      {
+	XML << magnet::xml::tag("Pt");
+
+	for (const auto& property : properties)
+	  XML << magnet::xml::attr(property.first) << property.second[i];
+
+	XML << particles[i];
+
+	if (!orientationData.empty())
 	  XML << magnet::xml::tag("O")
 	      << orientationData[i].angularVelocity
 	      << magnet::xml::endtag("O")
@@ -213,8 +304,27 @@ namespace dynamo {
   {
     double sumEnergy(0);
 
-    for (const Particle& part : Sim->particles)
-      sumEnergy += getParticleKineticEnergy(part);
+    //The peculiar velocities are required for Lees-Edwards BCs
+    if (std::dynamic_pointer_cast<BCLeesEdwards>(Sim->BCs))
+      {
+	for (const Particle& part : Sim->particles)
+	  sumEnergy += getParticleKineticEnergy(part);
+	return sumEnergy;
+      }
+
+    _particleArrays.gatherVelocities(Sim->particles);
+    _particleArrays.gatherMasses(*Sim);
+    for (size_t iDim(0); iDim < NDIM; ++iDim)
+      sumEnergy += _particleArrays.kineticTensor(iDim, iDim);
+    sumEnergy *= 0.5;
+
+    if (hasOrientationData())
+      for (const Particle& part : Sim->particles)
+	{
+	  const double I = Sim->species(part)->getScalarMomentOfInertia(part.getID());
+	  if (!std::isinf(I))
+	    sumEnergy += 0.5 * I * orientationData[part.getID()].angularVelocity.nrm2();
+	}
 
     return sumEnergy;
   }
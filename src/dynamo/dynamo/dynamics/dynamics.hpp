@@ -19,6 +19,7 @@
 #include <dynamo/base.hpp>
 #include <dynamo/eventtypes.hpp>
 #include <dynamo/particle.hpp>
+#include <dynamo/particleArrays.hpp>
 #include <dynamo/simulation.hpp>
 #include <magnet/math/quaternion.hpp>
 
@@ -30,6 +31,8 @@ namespace dynamo {
   class NEventData;
   class IntEvent;
   class Event;
+  class BinaryConfigReader;
+  class StreamingConfigReader;
 
   /*! \brief Provides the primitivve event-detection and processing
    routines for all events.
@@ -75,26 +78,77 @@ namespace dynamo {
   
     virtual void initialise();
 
+    /*! \brief Returns true if the event prediction functions (the
+        root finders and overlap tests) may be called concurrently
+        from several threads.
+
+	\sa Interaction::concurrentEvents
+     */
+    virtual bool concurrentEvents() const { return false; }
+
     /*! \brief Called when a replica exchange move is being performed on the system.
      
       \param oDynamics the Dynamics of the other system in the exchange move.
      */
     virtual void replicaExchange(Dynamics& oDynamics) {}
 
-    /*! \brief Parses the XML data to see if it can load XML particle
-      data or if it needs to decode the binary data. Then loads the
-      particle data.
+    /*! \brief Loads the particle data from the arrays of a binary
+      configuration file.
      
-      \param XML The root xml::Node of the xml::Document which has the ParticleData tag within.
+      \param file The binary configuration file.
+      \param particleData The ParticleData xml::Node of the file's metadata.
+      \sa BinaryConfigReader
      */
-    virtual void loadParticleXMLData(const magnet::xml::Node& XML);
+    virtual void loadParticleBinaryData(const BinaryConfigReader& file, const magnet::xml::Node& particleData);
+
+    /*! \brief Loads the particle data parsed from an XML
+      configuration file as it was read.
+
+      The particles are moved out of the reader.
+     
+      \param file The reader of the configuration file.
+      \param particleData The (emptied) ParticleData xml::Node of the file.
+      \sa StreamingConfigReader
+     */
+    virtual void loadParticleStreamData(StreamingConfigReader& file, const magnet::xml::Node& particleData);
   
+    /*! \brief A copy of the particle data, exactly as it is written
+      to a configuration file.
+
+      This allows the configuration to be written out while the
+      simulation continues (see Simulation::writeXMLfile).
+     */
+    struct ParticleSnapshot
+    {
+      //! \brief The particles in order of their external IDs, in the output units.
+      std::vector<Particle> particles;
+      //! \brief The per-particle Property values, in the same order.
+      std::vector<std::pair<std::string, std::vector<double> > > properties;
+      //! \brief The orientation data in the same order, if present.
+      std::vector<rotData> orientationData;
+
+      void outputXML(magnet::xml::XmlStream& XML) const;
+    };
+
+    /*! \brief Copy the particle data for output.
+      \param applyBC Wether to apply the boundary conditions to the final particle positions.
+     */
+    shared_ptr<ParticleSnapshot> getParticleSnapshot(bool applyBC) const;
+
     /*! \brief Writes the XML particle data, either the base64 header or
       the entire XML form.
       \param XML The XMLStream to write the configuration data to.
       \param applyBC Wether to apply the boundary conditions to the final particle positions before writing them out.
      */
-    void outputParticleXMLData(magnet::xml::XmlStream& XML, bool applyBC) const;
+    void outputParticleXMLData(magnet::xml::XmlStream& XML, bool applyBC) const
+    { getParticleSnapshot(applyBC)->outputXML(XML); }
+
+    /*! \brief Permutes any per-particle data held by the Dynamics
+      after the particles have been reordered.
+      \sa Simulation::reorderParticles()
+     */
+    virtual void particlesReordered(const std::vector<size_t>& order)
+    { reorderParticleData(orientationData, order); }
 
     /*! \brief Returns the degrees of freedom per particle.
      */
@@ -158,6 +212,22 @@ namespace dynamo {
      */
     virtual double SphereSphereInRoot(const IDRange& p1, const IDRange& p2, double d) const = 0;
 
+    /*! \brief Determines if and when a particle will intersect with
+      each of a batch of other particles.
+
+      This is the batched form of
+      SphereSphereInRoot(const Particle&, const Particle&, double),
+      used to predict all of the events of a particle and its
+      neighbours at once. The default implementation calls
+      SphereSphereInRoot for each pairing.
+
+      \param ids The IDs of the \a N other particles.
+      \param d The interaction diameter of each pairing.
+      \param dt Output array for the time of each event, or HUGE_VAL
+      if there is no event.
+     */
+    virtual void SphereSphereInRoots(const Particle& p1, const size_t* ids, const double* d, size_t N, double* dt) const;
+
     /*! \brief Determines if and when two spheres will stop intersecting.
      
       \param pd Some precomputed data about the event that is cached by
@@ -593,11 +663,7 @@ namespace dynamo {
     {
       //May as well take this opportunity to reset the streaming
       //Note: the Replexing coordinator RELIES on this behaviour!
-      for (Particle& part : Sim->particles)
-	{
-	  streamParticle(part, part.getPecTime() + partPecTime);
-	  part.getPecTime() = 0;
-	}
+      streamAllParticles();
 
       partPecTime = 0;
       streamCount = 0;
@@ -754,6 +820,24 @@ namespace dynamo {
     /*! \brief Moves the particles data along in time. */
     virtual void streamParticle(Particle& part, const double& dt) const = 0;
 
+    /*! \brief Streams every particle up to the current time and
+        zeroes its peculiar time.
+
+	Dynamics may override this with a bulk implementation using
+	\ref _particleArrays.
+     */
+    virtual void streamAllParticles() const
+    {
+      for (Particle& part : Sim->particles)
+	{
+	  streamParticle(part, part.getPecTime() + partPecTime);
+	  part.getPecTime() = 0;
+	}
+    }
+
+    //! \brief Storage reused by the bulk passes over the particles.
+    mutable ParticleArrays _particleArrays;
+
     mutable std::vector<rotData> orientationData;
   };
 }
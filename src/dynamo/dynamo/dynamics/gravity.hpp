@@ -32,9 +32,12 @@ namespace dynamo {
     const Vector& getGravityVector() const { return g; }
     virtual double SphereSphereInRoot(const Particle& p1, const Particle& p2, double d) const;
     virtual double SphereSphereInRoot(const IDRange& p1, const IDRange& p2, double d) const;
+    virtual void SphereSphereInRoots(const Particle& p1, const size_t* ids, const double* d, size_t N, double* dt) const
+    { Dynamics::SphereSphereInRoots(p1, ids, d, N, dt); }
     virtual double SphereSphereOutRoot(const Particle& p1, const Particle& p2, double d) const;
     virtual double SphereSphereOutRoot(const IDRange& p1, const IDRange& p2, double d) const;
     virtual void streamParticle(Particle&, const double&) const;
+    virtual void streamAllParticles() const { Dynamics::streamAllParticles(); }
     virtual double getSquareCellCollision2(const Particle&, const Vector &, const Vector &) const;
     virtual int getSquareCellCollision3(const Particle&, const Vector &, const Vector &) const;
     virtual std::pair<bool,double> getPointPlateCollision(const Particle& np1, const Vector& nrw0, const Vector& nhat, const double& Delta, const double& Omega, const double& Sigma, const double& t, bool) const;
@@ -49,6 +52,13 @@ namespace dynamo {
     virtual ParticleEventData runPlaneEvent(Particle&, const Vector &, const double&, double) const;
 
     void setGravityVector(Vector newg) {g = newg;}
+
+    virtual void particlesReordered(const std::vector<size_t>& order)
+    {
+      DynNewtonian::particlesReordered(order);
+      reorderParticleData(_tcList, order);
+    }
+
   protected:
     double elasticV;
     Vector g;
@@ -21,6 +21,8 @@
 #include <dynamo/2particleEventData.hpp>
 #include <dynamo/NparticleEventData.hpp>
 #include <dynamo/BC/BC.hpp>
+#include <dynamo/BC/PBC.hpp>
+#include <dynamo/BC/None.hpp>
 #include <dynamo/simulation.hpp>
 #include <dynamo/species/species.hpp>
 #include <dynamo/schedulers/sorters/event.hpp>
@@ -30,6 +32,7 @@
 #include <magnet/intersection/ray_triangle.hpp>
 #include <magnet/intersection/ray_rod.hpp>
 #include <magnet/intersection/ray_sphere.hpp>
+#include <magnet/intersection/ray_spheres.hpp>
 #include <magnet/intersection/ray_plane.hpp>
 #include <magnet/intersection/ray_cube.hpp>
 #include <magnet/intersection/line_line.hpp>
@@ -37,6 +40,8 @@
 #include <magnet/intersection/overlapfuncs/oscillatingplate.hpp>
 #include <magnet/math/matrix.hpp>
 #include <magnet/xmlwriter.hpp>
+#include <typeinfo>
+#include <cmath>
 
 namespace dynamo {
   double
@@ -67,6 +72,36 @@ namespace dynamo {
     return magnet::intersection::ray_sphere(r12, v12, d);
   }
 
+  void
+  DynNewtonian::SphereSphereInRoots(const Particle& p1, const size_t* ids, const double* d, size_t N, double* dt) const
+  {
+    //The kernel can only take the minimum image for plain periodic
+    //boundary conditions, anything else (e.g., Lees-Edwards) must
+    //use the boundary condition class for each pairing.
+    const BoundaryCondition& BC = *Sim->BCs;
+    const bool periodic = (typeid(BC) == typeid(BCPeriodic));
+    if (!periodic && (typeid(BC) != typeid(BCNone)))
+      return Dynamics::SphereSphereInRoots(p1, ids, d, N, dt);
+
+    double L[NDIM];
+    for (size_t iDim(0); iDim < NDIM; ++iDim)
+      L[iDim] = Sim->primaryCellSize[iDim];
+
+    //The storage is per thread, as events may be predicted
+    //concurrently (see Scheduler::rebuildList)
+    static thread_local ParticleArrays pairArrays;
+    pairArrays.gatherSeparations(Sim->particles, p1, ids, N);
+    const double* r[NDIM];
+    const double* v[NDIM];
+    for (size_t iDim(0); iDim < NDIM; ++iDim)
+      {
+	r[iDim] = pairArrays.pos[iDim].data();
+	v[iDim] = pairArrays.vel[iDim].data();
+      }
+
+    magnet::intersection::ray_spheres(r, v, d, periodic ? L : nullptr, N, dt);
+  }
+
   double
   DynNewtonian::SphereSphereInRoot(const IDRange& p1, const IDRange& p2, double d) const
   {
@@ -147,6 +182,34 @@ namespace dynamo {
       }
   }
 
+  void
+  DynNewtonian::streamAllParticles() const
+  {
+    //The orientations are streamed individually
+    if (hasOrientationData())
+      return Dynamics::streamAllParticles();
+
+    //The particles are streamed in blocks which fit in the cache,
+    //using the structure of arrays layout so that the loops
+    //vectorise.
+    const size_t blockSize = 1024;
+    const double delay = partPecTime;
+    for (size_t begin(0); begin < Sim->N(); begin += blockSize)
+      {
+	_particleArrays.gather(Sim->particles, begin, std::min(begin + blockSize, Sim->N()));
+	const size_t n = _particleArrays.size();
+	const double* const pecTime = _particleArrays.pecTime.data();
+	for (size_t iDim(0); iDim < NDIM; ++iDim)
+	  {
+	    double* const pos = _particleArrays.pos[iDim].data();
+	    const double* const vel = _particleArrays.vel[iDim].data();
+	    for (size_t i(0); i < n; ++i)
+	      pos[i] += vel[i] * (pecTime[i] + delay);
+	  }
+	_particleArrays.scatterPositions(Sim->particles, begin);
+      }
+  }
+
   double 
   DynNewtonian::getPlaneEvent(const Particle& part, const Vector& wallLoc, const Vector& wallNorm, double diameter) const
   {
@@ -34,14 +34,18 @@ namespace dynamo {
   public:
     DynNewtonian(dynamo::Simulation*);
 
+    virtual bool concurrentEvents() const { return true; }
+
     virtual double SphereSphereInRoot(const Particle& p1, const Particle& p2, double d) const;
     virtual double SphereSphereInRoot(const IDRange& p1, const IDRange& p2, double d) const;
+    virtual void SphereSphereInRoots(const Particle& p1, const size_t* ids, const double* d, size_t N, double* dt) const;
     virtual double SphereSphereOutRoot(const Particle& p1, const Particle& p2, double d) const;
     virtual double SphereSphereOutRoot(const IDRange& p1, const IDRange& p2, double d) const;  
     virtual double sphereOverlap(const Particle& p1, const Particle& p2, const double& d) const;
     virtual double CubeCubeInRoot(const Particle& p1, const Particle& p2, double d) const;
     virtual bool cubeOverlap(const Particle& p1, const Particle& p2, const double d) const;
     virtual void streamParticle(Particle&, const double&) const;
+    virtual void streamAllParticles() const;
     virtual double getSquareCellCollision2(const Particle&, const Vector &, const Vector &) const;
     virtual int getSquareCellCollision3(const Particle&, const Vector &, const Vector &) const;
     virtual std::pair<bool,double> getPointPlateCollision(const Particle& np1, const Vector& nrw0, const Vector& nhat, const double& Delta, const double& Omega, const double& Sigma, const double& t, bool) const;
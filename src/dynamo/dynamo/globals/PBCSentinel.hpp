@@ -44,6 +44,8 @@ namespace dynamo {
 
     virtual GlobalEvent getEvent(const Particle &) const;
 
+    virtual bool concurrentEvents() const { return true; }
+
     virtual void runEvent(Particle&, const double) const;
 
     virtual void initialise(size_t);
@@ -95,16 +95,16 @@ namespace dynamo {
 
     if (verbose)
       {
-	Vector cellPos = calcPosition(partCellData[part.getID()], part);
+	Vector cellPos = calcPosition(partCellData[part.getID()].cell, part);
 	Vector relpos = part.getPosition() - cellPos;
 	Sim->BCs->applyBC(relpos);
 	derr 
-	  << "Calculating event for particle " << part.getID() << " in Cell " << magnet::math::MortonNumber<3>(partCellData[part.getID()]).toString()
+	  << "Calculating event for particle " << part.getID() << " in Cell " << magnet::math::MortonNumber<3>(partCellData[part.getID()].cell).toString()
 	  << "\nParticle pos = " << part.getPosition().toString()
 	  << "\nCell pos = " << cellPos.toString()
 	  << "\nRelpos = " << relpos.toString()
 	  << "\nCell size = " << cellDimension.toString()
-	  << "\nTime = " << Sim->dynamics->getSquareCellCollision2(part, calcPosition(partCellData[part.getID()], part),
+	  << "\nTime = " << Sim->dynamics->getSquareCellCollision2(part, calcPosition(partCellData[part.getID()].cell, part),
 								   cellDimension) - Sim->dynamics->getParticleDelay(part)
 	  << "\nDelay = " << Sim->dynamics->getParticleDelay(part)
 	  << std::endl;
@@ -114,7 +114,7 @@ namespace dynamo {
 		       Sim->dynamics->
 		       getSquareCellCollision2
 		       (part, 
-			calcPosition(partCellData[part.getID()], part), 
+			calcPosition(partCellData[part.getID()].cell, part), 
 			cellDimension)
 		       -Sim->dynamics->getParticleDelay(part),
 		       CELL, *this);
@@ -129,9 +129,7 @@ namespace dynamo {
     //expect the particle to be up to date.
     Sim->dynamics->updateParticle(part);
 
-    std::unordered_map<size_t, size_t>::iterator it = partCellData.find(part.getID());
-
-    const size_t oldCell(it->second);
+    const size_t oldCell(partCellData[part.getID()].cell);
 
     size_t endCell;
 
@@ -168,7 +166,7 @@ namespace dynamo {
       endCell = dendCell.getMortonNum();
     }
 
-    removeFromCellwIt(part.getID(), it);
+    removeFromCell(part.getID());
     addToCell(part.getID(), endCell);
 
     //Get rid of the virtual event we're running, an updated event is
@@ -197,7 +195,7 @@ namespace dynamo {
 	  {
 	    newNBCell[dim1] %= cellCount[dim1];
 	    
-	    for (const size_t& next : list[newNBCell.getMortonNum()])
+	    for (const size_t& next : getCellContents(newNBCell.getMortonNum()))
 	      _sigNewNeighbour(part, next);
 	  
 	    ++newNBCell[dim1];
@@ -240,7 +238,7 @@ namespace dynamo {
 
     reinitialise();
 
-    dout << "Neighbourlist contains " << partCellData.size() 
+    dout << "Neighbourlist contains " << range->size() 
 	 << " particle entries"
 	 << std::endl;
   }
@@ -281,8 +279,9 @@ namespace dynamo {
   void
   GCells::addCells(double maxdiam)
   {
-    list.clear();
-    partCellData.clear();
+    _cells.clear();
+    _cellArena.clear();
+    _arenaGarbage = 0;
     NCells = 1;
 
     for (size_t iDim = 0; iDim < NDIM; iDim++)
@@ -306,7 +305,7 @@ namespace dynamo {
     magnet::math::MortonNumber<3> coords(cellCount[0], cellCount[1], cellCount[2]);
     size_t sizeReq = coords.getMortonNum();
 
-    list.resize(sizeReq); //Empty Cells created!
+    _cells.resize(sizeReq); //Empty Cells created!
 
     dout << "Cells <x,y,z> " << cellCount[0] << ","
 	 << cellCount[1] << "," << cellCount[2]
@@ -338,16 +337,40 @@ namespace dynamo {
     //Required so particles find the right owning cell
     Sim->dynamics->updateAllParticles();
   
-    ////Add all the particles 
+    //Count the particles in each cell, so the arena can be laid out
+    //in Morton order with room for each cell to grow
+    std::vector<size_t> particleCells;
+    particleCells.reserve(range->size());
     for (const size_t& id : *range)
       {
 	Particle& p = Sim->particles[id];
 	Sim->dynamics->updateParticle(p); 
-	addToCell(id);
+	particleCells.push_back(getCellID(p.getPosition()).getMortonNum());
+	++_cells[particleCells.back()].capacity;
+      }
+
+    size_t arenaSize = 0;
+    for (CellSegment& cell : _cells)
+      {
+	cell.begin = arenaSize;
+	cell.capacity = std::max(2 * cell.capacity, size_t(2));
+	arenaSize += cell.capacity;
+      }
+    _cellArena.resize(arenaSize);
+
+    partCellData.clear();
+    CellEntry emptyEntry = {NO_CELL, 0};
+    partCellData.resize(Sim->N(), emptyEntry);
+
+    ////Add all the particles 
+    std::vector<size_t>::const_iterator cellIt = particleCells.begin();
+    for (const size_t& id : *range)
+      {
+	Particle& p = Sim->particles[id];
+	addToCell(id, *cellIt++);
 	if (verbose)
 	  {
-	    std::unordered_map<size_t, size_t>::iterator it = partCellData.find(id);
-	    magnet::math::MortonNumber<3> currentCell(it->second);
+	    magnet::math::MortonNumber<3> currentCell(partCellData[id].cell);
 	    
 	    magnet::math::MortonNumber<3> estCell(getCellID(Sim->particles[ID].getPosition()));
 	  
@@ -364,7 +387,7 @@ namespace dynamo {
 		 << "," << currentCell[1].getRealValue()
 		 << "," << currentCell[2].getRealValue()
 		 << ">"
-		 << "\nParticle is at this distance " << Vector(p.getPosition() - calcPosition(it->second, p)).toString() << " from the cell origin"
+		 << "\nParticle is at this distance " << Vector(p.getPosition() - calcPosition(partCellData[id].cell, p)).toString() << " from the cell origin"
 		 << "\nParticle position  " << p.getPosition().toString()	
 		 << "\nParticle wrapped distance  " << wrapped_pos.toString()	
 		 << "\nParticle relative position  " << origin_pos.toString()
@@ -376,10 +399,49 @@ namespace dynamo {
 	  }
       }
 
-    dout << "Cell loading " << float(partCellData.size()) / NCells 
+    dout << "Cell loading " << float(range->size()) / NCells 
 	 << std::endl;
   }
 
+  void
+  GCells::growCell(size_t cellID) const
+  {
+    if (_arenaGarbage > _cellArena.size() / 2)
+      compactArena();
+
+    CellSegment& cell = _cells[cellID];
+    const size_t newBegin = _cellArena.size();
+    const size_t newCapacity = std::max(2 * cell.capacity, size_t(4));
+    _cellArena.resize(newBegin + newCapacity);
+    std::copy(_cellArena.begin() + cell.begin, 
+	      _cellArena.begin() + cell.begin + cell.size,
+	      _cellArena.begin() + newBegin);
+
+    _arenaGarbage += cell.capacity;
+    cell.begin = newBegin;
+    cell.capacity = newCapacity;
+  }
+
+  void
+  GCells::compactArena() const
+  {
+    //Rebuild the arena in Morton order, the slots of the particles
+    //are unchanged
+    _arenaScratch.resize(_cellArena.size() - _arenaGarbage);
+    size_t arenaSize = 0;
+    for (CellSegment& cell : _cells)
+      {
+	std::copy(_cellArena.begin() + cell.begin, 
+		  _cellArena.begin() + cell.begin + cell.size,
+		  _arenaScratch.begin() + arenaSize);
+	cell.begin = arenaSize;
+	arenaSize += cell.capacity;
+      }
+    
+    std::swap(_cellArena, _arenaScratch);
+    _arenaGarbage = 0;
+  }
+
   magnet::math::MortonNumber<3>
   GCells::getCellID(Vector pos) const
   {
@@ -421,7 +483,7 @@ namespace dynamo {
 	      {
 		coords[2] = (zero_coords[2] + z) % cellCount[2];
 
-		const std::vector<size_t>& nlist = list[coords.getMortonNum()];
+		const CellContents nlist = getCellContents(coords.getMortonNum());
 		retlist.insert(retlist.end(), nlist.begin(), nlist.end());
 	      }
 	  }
@@ -430,7 +492,7 @@ namespace dynamo {
   
   void
   GCells::getParticleNeighbours(const Particle& part, std::vector<size_t>& retlist) const {
-    getParticleNeighbours(partCellData[part.getID()], retlist);
+    getParticleNeighbours(partCellData[part.getID()].cell, retlist);
   }
 
   void
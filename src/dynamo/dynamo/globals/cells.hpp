@@ -19,8 +19,8 @@
 #include <dynamo/globals/neighbourList.hpp>
 #include <dynamo/particle.hpp>
 #include <magnet/math/morton_number.hpp>
-#include <unordered_map>
 #include <vector>
+#include <limits>
 
 namespace dynamo {
   /*! \brief A regular cell neighbour list implementation.
@@ -39,11 +39,14 @@ namespace dynamo {
     distance from the cells border. This helps remove "rattling"
     events where particles rapidly pass between two cells.
 
-    The second property is that the contents of each cell is stored as
-    a std::vector. In theory, a linked list is far more memory
-    efficient however, the vector is much more cache friendly and can
-    boost performance by 50% in cases where the cell has multiple
-    particles inside of it.
+    The second property is that the contents of each cell are stored
+    contiguously. In theory, a linked list is far more memory
+    efficient however, contiguous storage is much more cache friendly
+    and can boost performance by 50% in cases where the cell has
+    multiple particles inside of it. All cells share one flat arena,
+    and the cell and slot of each particle are held in a dense array
+    indexed by the particle ID, so a cell transition is O(1) and does
+    not allocate.
    */
   class GCells: public GNeighbourList
   {
@@ -55,6 +58,8 @@ namespace dynamo {
 
     virtual GlobalEvent getEvent(const Particle &) const;
 
+    virtual bool concurrentEvents() const { return true; }
+
     virtual void runEvent(Particle&, const double) const;
 
     virtual void initialise(size_t);
@@ -87,15 +92,62 @@ namespace dynamo {
     size_t NCells;
     size_t overlink;
 
-    //! \brief The list of particles in each cell.
-    mutable std::vector<std::vector<size_t> > list;
+    //! \brief The location of a particle in the cell storage.
+    struct CellEntry
+    {
+      size_t cell;
+      size_t slot;
+    };
+
+    //! \brief The segment of the \ref _cellArena holding a cell.
+    struct CellSegment
+    {
+      size_t begin;
+      size_t size;
+      size_t capacity;
+    };
+
+    //! \brief A view of the IDs of the particles in a cell.
+    struct CellContents
+    {
+      const size_t* _begin;
+      const size_t* _end;
+      const size_t* begin() const { return _begin; }
+      const size_t* end() const { return _end; }
+    };
+
+    //! \brief The marker for particles which are not in a cell.
+    static const size_t NO_CELL = std::numeric_limits<size_t>::max();
 
-    /*! \brief The cell for a given particle.
-      
-      This container is an unordered map, so we only store the linked
-      list for the particles actually inserted into this neighborlist.
+    //! \brief The segment of the arena used by each cell.
+    mutable std::vector<CellSegment> _cells;
+
+    //! \brief The contents of every cell, stored contiguously.
+    mutable std::vector<size_t> _cellArena;
+
+    //! \brief Scratch space used to compact the arena.
+    mutable std::vector<size_t> _arenaScratch;
+
+    //! \brief The number of arena entries abandoned by growing cells.
+    mutable size_t _arenaGarbage;
+
+    /*! \brief The cell and slot of each particle, indexed by the
+        particle ID.
      */
-    mutable std::unordered_map<size_t, size_t> partCellData;
+    mutable std::vector<CellEntry> partCellData;
+
+    inline CellContents getCellContents(size_t cellID) const
+    {
+      const size_t* start = _cellArena.data() + _cells[cellID].begin;
+      CellContents retval = {start, start + _cells[cellID].size};
+      return retval;
+    }
+
+    //! \brief Moves a cell to the end of the arena with more capacity.
+    void growCell(size_t cellID) const;
+
+    //! \brief Removes the abandoned entries from the arena.
+    void compactArena() const;
 
     GCells(const GCells&);
 
@@ -115,38 +167,30 @@ namespace dynamo {
 
     inline void addToCell(size_t ID, size_t cellID) const
     {
-      list[cellID].push_back(ID);
-      partCellData[ID] = cellID;
+      if (_cells[cellID].size == _cells[cellID].capacity)
+	growCell(cellID);
+
+      CellSegment& cell = _cells[cellID];
+      _cellArena[cell.begin + cell.size] = ID;
+      partCellData[ID].cell = cellID;
+      partCellData[ID].slot = cell.size;
+      ++cell.size;
     }
   
     inline void removeFromCell(size_t ID) const
-    { removeFromCellwIt(ID, partCellData.find(ID)); }
-
-    inline void removeFromCellwIt(size_t ID, std::unordered_map<size_t, size_t>::iterator it) const
     {
+      CellEntry& entry = partCellData[ID];
 #ifdef DYNAMO_DEBUG
-    if (it == partCellData.end())
-      M_throw() << "Could not find the particle's cell data";
-#endif
-      const size_t cellID = it->second;
-      //Erase the cell data
-      partCellData.erase(it);
-
-      std::vector<std::vector<size_t> >::iterator listIt = list.begin() + cellID;
-#ifdef DYNAMO_DEBUG
-    if (listIt == list.end())
-      M_throw() << "Could not find the particle's cell data";
-#endif
-
-      std::vector<size_t>::iterator pit = std::find(listIt->begin(), listIt->end(), ID);      
-
-#ifdef DYNAMO_DEBUG
-      if (pit == listIt->end())
+      if (entry.cell == NO_CELL)
 	M_throw() << "Removing a particle (ID=" << ID << ") which is not in a cell";
 #endif
-
-      *pit = listIt->back();
-      listIt->pop_back();
+      //Move the last particle of the cell into the vacated slot
+      CellSegment& cell = _cells[entry.cell];
+      const size_t lastID = _cellArena[cell.begin + cell.size - 1];
+      _cellArena[cell.begin + entry.slot] = lastID;
+      partCellData[lastID].slot = entry.slot;
+      --cell.size;
+      entry.cell = NO_CELL;
     }
   };
 }
@@ -68,7 +68,7 @@ namespace dynamo {
     return GlobalEvent(part,
 		       Sim->dynamics->
 		       getSquareCellCollision2
-		       (part, calcPosition(partCellData[part.getID()]), 
+		       (part, calcPosition(partCellData[part.getID()].cell), 
 			cellDimension)
 		       - Sim->dynamics->getParticleDelay(part),
 		       CELL, *this);
@@ -79,7 +79,7 @@ namespace dynamo {
   {
     Sim->dynamics->updateParticle(part);
 
-    size_t oldCell(partCellData[part.getID()]);
+    size_t oldCell(partCellData[part.getID()].cell);
     magnet::math::MortonNumber<3> oldCellCoords(oldCell);
     Vector oldCellPosition(calcPosition(oldCellCoords));
 
@@ -236,7 +236,7 @@ namespace dynamo {
 	      {
 		newNBCell[dim1] %= cellCount[dim1];
   
-		for (const size_t& next : list[newNBCell.getMortonNum()])
+		for (const size_t& next : getCellContents(newNBCell.getMortonNum()))
 		  _sigNewNeighbour(part, next);
 	  
 		++newNBCell[dim1];
@@ -276,7 +276,7 @@ namespace dynamo {
 
   void
   GCellsShearing::getParticleNeighbours(const Particle& part, std::vector<size_t>& retlist) const {
-    getParticleNeighbours(magnet::math::MortonNumber<3>(partCellData[part.getID()]), retlist);
+    getParticleNeighbours(magnet::math::MortonNumber<3>(partCellData[part.getID()].cell), retlist);
   }
 
   void
@@ -295,7 +295,7 @@ namespace dynamo {
   
   void
   GCellsShearing::getAdditionalLEParticleNeighbourhood(const Particle& part, std::vector<size_t>& retlist) const {
-    return getAdditionalLEParticleNeighbourhood(magnet::math::MortonNumber<3>(partCellData[part.getID()]), retlist);
+    return getAdditionalLEParticleNeighbourhood(magnet::math::MortonNumber<3>(partCellData[part.getID()].cell), retlist);
   }
 
   void
@@ -319,7 +319,7 @@ namespace dynamo {
 
 	for (size_t j(0); j < cellCount[0]; ++j)
 	  {
-	    const std::vector<size_t>& nbs(list[cellCoords.getMortonNum()]);
+	    const CellContents nbs = getCellContents(cellCoords.getMortonNum());
 	    retlist.insert(retlist.end(), nbs.begin(), nbs.end());
 	    ++cellCoords[0];
 	  }
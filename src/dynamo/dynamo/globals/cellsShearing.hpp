@@ -33,6 +33,10 @@ namespace dynamo {
   
     virtual GlobalEvent getEvent(const Particle &) const;
 
+    //! The Lees-Edwards neighbourhood is not cleared for parallel
+    //! prediction.
+    virtual bool concurrentEvents() const { return false; }
+
     virtual void runEvent(Particle&, const double) const;
 
     virtual void getParticleNeighbours(const Particle&, std::vector<size_t>&) const;
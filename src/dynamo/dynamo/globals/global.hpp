@@ -56,6 +56,13 @@ namespace dynamo {
      */
     virtual GlobalEvent getEvent(const Particle &) const = 0;
 
+    /*! \brief Returns true if getEvent may be called concurrently
+     * from several threads.
+     *
+     * \sa Interaction::concurrentEvents
+     */
+    virtual bool concurrentEvents() const { return false; }
+
     /*! \brief Executes the event for a particle.
      * 
      * \param p The particle which is about to undergo an interaction.
@@ -93,6 +100,10 @@ namespace dynamo {
     /*! \brief Returns the unique ID number of this Global.
      */
     inline const size_t& getID() const { return ID; }
+
+    /*! \brief Returns the IDRange of particles this Global acts on.
+     */
+    const shared_ptr<IDRange>& getRange() const { return range; }
   
   protected:
     /*! \brief Writes out an XML representation of the Global
@@ -69,6 +69,8 @@ namespace dynamo {
     
     void markAsUsedInScheduler() { isUsedInScheduler = true; }
 
+    bool usedInScheduler() const { return isUsedInScheduler; }
+
     void setCellOverlap(bool overlap) 
     {
       if (overlap)
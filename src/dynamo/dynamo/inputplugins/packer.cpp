@@ -114,6 +114,47 @@ namespace dynamo {
     return retval;
   }
 
+  po::options_description
+  IPPacker::getPackerParameters()
+  {
+    po::options_description retval("Packer parameters");
+
+    retval.add_options()
+      ("b1", "boolean option one.")
+      ("b2", "boolean option two.")
+      ("i1", po::value<size_t>(), "integer option one.")
+      ("i2", po::value<size_t>(), "integer option two.")
+      ("i3", po::value<size_t>(), "integer option three.")
+      ("i4", po::value<size_t>(), "integer option four.")
+      ("s1", po::value<std::string>(), "string option one.")
+      ("s2", po::value<std::string>(), "string option two.")
+      ("f1", po::value<double>(), "double option one.")
+      ("f2", po::value<double>(), "double option two.")
+      ("f3", po::value<double>(), "double option three.")
+      ("f4", po::value<double>(), "double option four.")
+      ("f5", po::value<double>(), "double option five.")
+      ("f6", po::value<double>(), "double option six.")
+      ("f7", po::value<double>(), "double option seven.")
+      ("f8", po::value<double>(), "double option eight.")
+      ("f9", po::value<double>(), "double option nine.")
+      ("f10", po::value<double>(), "double option ten.")
+      ("NCells,C", po::value<unsigned long>()->default_value(7),
+       "Default number of unit cells per dimension, used for crystal packing of particles.")
+      ("xcell,x", po::value<unsigned long>(),
+       "Number of unit cells in the x dimension.")
+      ("ycell,y", po::value<unsigned long>(),
+       "Number of unit cells in the y dimension.")
+      ("zcell,z", po::value<unsigned long>(),
+       "Number of unit cells in the z dimension.")
+      ("rectangular-box", "Force the simulation box to be deformed so "
+       "that the x,y,z cells also specify the box aspect ratio.")
+      ("density,d", po::value<double>()->default_value(0.5),
+       "System number density.")
+      ;
+
+    return retval;
+  }
+
   void
   IPPacker::initialise()
   {
@@ -1285,7 +1326,7 @@ namespace dynamo {
 	  Sim->interactions.push_back(shared_ptr<Interaction>(new IHardSphere(Sim, particleDiamB, new IDPairRangeAll(), "BBInt")));	     
 	  Sim->addSpecies(shared_ptr<Species>(new SpPoint(Sim, new IDRangeRange(0, nPartA - 1), 1.0, "A", 0)));
 
-	  Sim->addSpecies(shared_ptr<Species>(new SpPoint(Sim, new IDRangeRange(nPartA - 1, latticeSites.size()), massFrac / chainlength, "B", 0)));
+	  Sim->addSpecies(shared_ptr<Species>(new SpPoint(Sim, new IDRangeRange(nPartA, latticeSites.size() - 1), massFrac / chainlength, "B", 0)));
 
 	  Sim->units.setUnitLength(particleDiam);
 	  unsigned long nParticles = 0;
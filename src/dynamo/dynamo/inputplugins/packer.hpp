@@ -37,6 +37,14 @@ namespace dynamo {
 
     static po::options_description getOptions();
 
+    /*! \brief The generic parameters used by the packer modes
+        (e.g., --density, --NCells, --i1, --f1).
+
+	These are hidden from the help text, each packer mode
+	describes the parameters it uses.
+     */
+    static po::options_description getPackerParameters();
+
   protected:
     std::array<long, 3> getCells();
     Vector  getNormalisedCellDimensions();
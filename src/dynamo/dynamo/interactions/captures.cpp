@@ -19,6 +19,8 @@
 #include <dynamo/particle.hpp>
 #include <dynamo/schedulers/scheduler.hpp>
 #include <dynamo/simulation.hpp>
+#include <dynamo/dynamics/dynamics.hpp>
+#include <dynamo/BC/BC.hpp>
 #include <magnet/xmlwriter.hpp>
 #include <magnet/xmlreader.hpp>
 
@@ -32,16 +34,41 @@ namespace dynamo {
 	_mapUninitialised = false;
 	clear();
 
-	for (std::vector<Particle>::const_iterator iPtr1 = Sim->particles.begin();
-	     iPtr1 != Sim->particles.end(); iPtr1++)
-	  for (std::vector<Particle>::const_iterator iPtr2 = iPtr1+1;
-	       iPtr2 != Sim->particles.end(); iPtr2++)
-	    //Check this interaction is the correct interaction for the pair
-	    if (Sim->getInteraction(*iPtr1, *iPtr2).get() == static_cast<const Interaction*>(this))
-	      testAddToCaptureMap(*iPtr1, iPtr2->getID());
+	//Captured pairs must be within the interaction distance. The
+	//captured pairs are collected per block of particles, allowing
+	//the blocks to be tested in parallel.
+	std::vector<std::vector<Map::value_type> > captured(Sim->getPairBlockCount());
+	const bool concurrent = concurrentEvents() && Sim->dynamics->concurrentEvents()
+	  && Sim->BCs->concurrentEvents();
+	Sim->forEachPair(maxIntDist(), concurrent,
+			 [&](size_t block, const Particle& p1, const Particle& p2)
+			 {
+			   //Check this interaction is the correct interaction for the pair
+			   if (Sim->getInteraction(p1, p2).get() != static_cast<const Interaction*>(this))
+			     return;
+			   const size_t capval = captureTest(p1, p2);
+			   if (capval)
+			     captured[block].push_back(Map::value_type(Map::key_type(p1, p2), capval));
+			 });
+
+	for (const auto& entries : captured)
+	  Map::insert(entries.begin(), entries.end());
       }
   }
 
+  void
+  ICapture::particlesReordered(const std::vector<size_t>& order)
+  {
+    std::vector<size_t> newID(order.size());
+    for (size_t ID(0); ID < order.size(); ++ID)
+      newID[order[ID]] = ID;
+
+    const std::vector<Map::value_type> entries(Map::begin(), Map::end());
+    Map::clear();
+    for (const Map::value_type& entry : entries)
+      Map::insert(Map::value_type(Map::key_type(newID[entry.first.first], newID[entry.first.second]), entry.second));
+  }
+
   void 
   ICapture::testAddToCaptureMap(const Particle& p1, const size_t& p2)
   {
@@ -71,8 +98,8 @@ namespace dynamo {
 
     for (const Map::value_type& IDs : *this)
       XML << magnet::xml::tag("Pair")
-	  << magnet::xml::attr("ID1") << IDs.first.first
-	  << magnet::xml::attr("ID2") << IDs.first.second
+	  << magnet::xml::attr("ID1") << Sim->getExternalID(IDs.first.first)
+	  << magnet::xml::attr("ID2") << Sim->getExternalID(IDs.first.second)
 	  << magnet::xml::attr("val") << IDs.second
 	  << magnet::xml::endtag("Pair");
   
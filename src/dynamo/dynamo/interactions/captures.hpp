@@ -174,6 +174,9 @@ namespace dynamo {
 
     void initCaptureMap();
 
+    //! \brief Renumbers the captured pairs to the new particle IDs.
+    virtual void particlesReordered(const std::vector<size_t>& order);
+
     virtual size_t captureTest(const Particle&, const Particle&) const = 0;
 
   protected:  
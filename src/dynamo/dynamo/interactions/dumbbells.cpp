@@ -39,13 +39,6 @@ namespace dynamo {
     operator<<(XML);
   }
 
-  void 
-  IDumbbells::initialise(size_t nID)
-  {
-    Interaction::initialise(nID);
-    ICapture::initCaptureMap();
-  }
-
   std::array<double, 4> IDumbbells::getGlyphSize(size_t ID) const
   { 
     return {{_diamA->getProperty(ID), _diamB->getProperty(ID), _LA->getProperty(ID), _LB->getProperty(ID)}};
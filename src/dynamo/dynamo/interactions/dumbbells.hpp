@@ -46,8 +46,6 @@ namespace dynamo {
 
     void operator<<(const magnet::xml::Node&);
 
-    virtual void initialise(size_t);
-
     virtual double maxIntDist() const;
 
     virtual IntEvent getEvent(const Particle&, const Particle&) const;
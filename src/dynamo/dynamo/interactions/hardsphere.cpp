@@ -68,7 +68,7 @@ namespace dynamo {
 
   std::array<double, 4>
   IHardSphere::getGlyphSize(size_t ID) const
-  { return {{_diameter->getProperty(ID), 0, 0, 0}}; }
+  { return {{_diameter.getProperty(ID), 0, 0, 0}}; }
 
   double 
   IHardSphere::maxIntDist() const 
@@ -77,7 +77,7 @@ namespace dynamo {
   double 
   IHardSphere::getExcludedVolume(size_t ID) const 
   { 
-    const double diam = _diameter->getProperty(ID);
+    const double diam = _diameter.getProperty(ID);
     return diam * diam * diam * M_PI / 6.0; 
   }
 
@@ -95,7 +95,7 @@ namespace dynamo {
       M_throw() << "You shouldn't pass p1==p2 events to the interactions!";
 #endif 
 
-    const double d = _diameter->getProperty(p1, p2);
+    const double d = _diameter.getProperty(p1, p2);
     const double dt = Sim->dynamics->SphereSphereInRoot(p1, p2, d);
 
     if (dt != HUGE_VAL)
@@ -104,22 +104,47 @@ namespace dynamo {
     return IntEvent(p1,p2,HUGE_VAL, NONE, *this);  
   }
 
+  void
+  IHardSphere::getEvents(const Particle& p1, const std::vector<size_t>& ids, std::vector<IntEvent>& events) const
+  {
+    //The storage is per thread, as the events may be calculated
+    //concurrently (see concurrentEvents)
+    static thread_local std::vector<double> diameters;
+    static thread_local std::vector<double> roots;
+
+    const size_t N = ids.size();
+    diameters.resize(N);
+    roots.resize(N);
+
+    if (_diameter.isUniform())
+      std::fill(diameters.begin(), diameters.end(), _diameter.getProperty(p1.getID()));
+    else
+      for (size_t i(0); i < N; ++i)
+	diameters[i] = _diameter.getProperty(p1.getID(), ids[i]);
+
+    Sim->dynamics->SphereSphereInRoots(p1, ids.data(), diameters.data(), N, roots.data());
+
+    for (size_t i(0); i < N; ++i)
+      if (roots[i] != HUGE_VAL)
+	events.push_back(IntEvent(p1, Sim->particles[ids[i]], roots[i], CORE, *this));
+  }
+
   PairEventData
   IHardSphere::runEvent(Particle& p1, Particle& p2, const IntEvent& iEvent)
   {
     ++Sim->eventCount;
 
-    const double d1 = _diameter->getProperty(p1);
-    const double d2 = _diameter->getProperty(p2);
-    const double d = _diameter->getProperty(p1, p2);
+    const double d1 = _diameter.getProperty(p1);
+    const double d2 = _diameter.getProperty(p2);
+    const double d = _diameter.getProperty(p1, p2);
 
     double e = 1.0;
-    if (_e) e = _e->getProperty(p1, p2);
+    if (_e) e = _e.getProperty(p1, p2);
    
     PairEventData EDat;
     if (_et)
       {
-	const double et = _et->getProperty(p1, p2);
+	const double et = _et.getProperty(p1, p2);
 	EDat = Sim->dynamics->RoughSpheresColl(iEvent, e, et, d1, d2);
       }
     else
@@ -142,7 +167,7 @@ namespace dynamo {
   bool
   IHardSphere::validateState(const Particle& p1, const Particle& p2, bool textoutput) const
   {
-    const double d = _diameter->getProperty(p1, p2);
+    const double d = _diameter.getProperty(p1, p2);
     if (Sim->dynamics->sphereOverlap(p1, p2, d))
       {
 	if (textoutput)
@@ -70,6 +70,10 @@ namespace dynamo {
     virtual void rescaleLengths(double) {}
 
     virtual IntEvent getEvent(const Particle&, const Particle&) const;
+
+    virtual void getEvents(const Particle&, const std::vector<size_t>&, std::vector<IntEvent>&) const;
+
+    virtual bool concurrentEvents() const { return true; }
  
     virtual PairEventData runEvent(Particle&, Particle&, const IntEvent&);
    
@@ -80,8 +84,8 @@ namespace dynamo {
     void outputData(magnet::xml::XmlStream& XML) const;
 
   protected:
-    shared_ptr<Property> _diameter;
-    shared_ptr<Property> _e;
-    shared_ptr<Property> _et;
+    PropertyHandle _diameter;
+    PropertyHandle _e;
+    PropertyHandle _et;
   };
 }
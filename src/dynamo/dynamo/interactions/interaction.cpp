@@ -33,6 +33,17 @@ namespace dynamo {
   Interaction::operator<<(const magnet::xml::Node& XML)
   { range = shared_ptr<IDPairRange>(IDPairRange::getClass(XML.getNode("IDPairRange"), Sim)); }
 
+  void
+  Interaction::getEvents(const Particle& p1, const std::vector<size_t>& ids, std::vector<IntEvent>& events) const
+  {
+    for (const size_t id : ids)
+      {
+	const IntEvent event = getEvent(p1, Sim->particles[id]);
+	if (event.getType() != NONE)
+	  events.push_back(event);
+      }
+  }
+
   bool 
   Interaction::isInteraction(const IntEvent &coll) const
   { 
@@ -22,6 +22,7 @@
 #include <string>
 #include <limits>
 #include <array>
+#include <vector>
 
 namespace magnet { namespace xml { class Node; class XmlStream; } }
 
@@ -73,6 +74,30 @@ namespace dynamo {
      */
     virtual IntEvent getEvent(const Particle &, const Particle &) const = 0;
 
+    /*! \brief Calculate the events between a particle and a batch of
+        other particles, all of which use this Interaction with it.
+
+	Only events which will occur (i.e., not of type NONE) are
+	appended to \a events. The default implementation calls
+	getEvent for each pairing, but Interactions may override this
+	to use the batched primatives of the Dynamics.
+
+	\param ids The IDs of the other particles, which must be up to
+	date.
+     */
+    virtual void getEvents(const Particle& p1, const std::vector<size_t>& ids, std::vector<IntEvent>& events) const;
+
+    /*! \brief Returns true if getEvent, getEvents, validateState
+        and ICapture::captureTest may be called concurrently from
+        several threads.
+
+	This is only the case if they do not modify any state. It is
+	used to decide if the event list can be built and the system
+	checked in parallel (see Scheduler::rebuildList and
+	Simulation::forEachPair).
+     */
+    virtual bool concurrentEvents() const { return false; }
+
     /*! \brief Run the dynamics of an event which is occuring now.
      */
     virtual PairEventData runEvent(Particle&, Particle&, const IntEvent&) = 0;
@@ -142,6 +167,13 @@ namespace dynamo {
      */
     const shared_ptr<IDPairRange>& getRange() const;
 
+    /*! \brief Permutes any per-particle data held by the
+        Interaction after the particles have been reordered.
+
+	\sa Simulation::reorderParticles()
+     */
+    virtual void particlesReordered(const std::vector<size_t>& order) {}
+
     /*! \brief Test if an invalid state has occurred between the two
         passed particles.
 	
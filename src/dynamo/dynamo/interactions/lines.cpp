@@ -38,13 +38,6 @@ namespace dynamo {
     operator<<(XML);
   }
 
-  void 
-  ILines::initialise(size_t nID)
-  {
-    Interaction::initialise(nID);
-    ICapture::initCaptureMap();
-  }
-
   std::array<double, 4> ILines::getGlyphSize(size_t ID) const
   {
     return {{_length->getProperty(ID), 0, 0, 0}};
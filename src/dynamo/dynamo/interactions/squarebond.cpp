@@ -116,19 +116,36 @@ namespace dynamo {
   size_t 
   ISquareBond::validateState(bool textoutput, size_t max_reports) const
   {
+    //Bonded pairs may be any distance apart, so they cannot be found
+    //using the neighbour lists. Most ranges can list their pairs,
+    //otherwise every pair of particles must be visited.
+    std::vector<std::pair<size_t, size_t> > pairs;
+    if (!range->getPairs(pairs))
+      {
+	std::vector<std::vector<std::pair<size_t, size_t> > > blockPairs(Sim->getPairBlockCount());
+	Sim->forEachPair(HUGE_VAL, true,
+			 [&](size_t block, const Particle& p1, const Particle& p2)
+			 {
+			   if (range->isInRange(p1, p2))
+			     blockPairs[block].push_back(std::make_pair(p1.getID(), p2.getID()));
+			 });
+
+	for (const auto& block : blockPairs)
+	  pairs.insert(pairs.end(), block.begin(), block.end());
+      }
+
     size_t retval(0);
-    for (std::vector<Particle>::const_iterator iPtr = Sim->particles.begin();
-	 iPtr != Sim->particles.end(); ++iPtr)
-      for (std::vector<Particle>::const_iterator jPtr = iPtr + 1;
-	   jPtr != Sim->particles.end(); ++jPtr)
-	{
-	  const Particle& p1 = *iPtr;
-	  const Particle& p2 = *jPtr;
-	  
-	  shared_ptr<Interaction> interaction_ptr = Sim->getInteraction(p1, p2);
-	  if (interaction_ptr.get() == static_cast<const Interaction*>(this))
-	    retval += validateState(*iPtr, *jPtr, retval < max_reports);
-	}
+    for (const auto& pair : pairs)
+      {
+	if (pair.second >= Sim->N()) continue;
+
+	const Particle& p1 = Sim->particles[pair.first];
+	const Particle& p2 = Sim->particles[pair.second];
+
+	//Another interaction may take precedence for this pair
+	if (Sim->getInteraction(p1, p2).get() == static_cast<const Interaction*>(this))
+	  retval += validateState(p1, p2, retval < max_reports);
+      }
     
     return retval;
   }
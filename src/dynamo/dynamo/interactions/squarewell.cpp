@@ -61,13 +61,13 @@ namespace dynamo {
   std::array<double, 4>
   ISquareWell::getGlyphSize(size_t ID) const 
   { 
-    return {{_diameter->getProperty(ID), 0, 0, 0}};
+    return {{_diameter.getProperty(ID), 0, 0, 0}};
   }
 
   double 
   ISquareWell::getExcludedVolume(size_t ID) const 
   { 
-    double diam = _diameter->getProperty(ID);
+    double diam = _diameter.getProperty(ID);
     return diam * diam * diam * M_PI / 6.0; 
   }
 
@@ -75,20 +75,13 @@ namespace dynamo {
   ISquareWell::maxIntDist() const 
   { return _diameter->getMaxValue() * _lambda->getMaxValue(); }
 
-  void 
-  ISquareWell::initialise(size_t nID)
-  {
-    Interaction::initialise(nID);
-    ICapture::initCaptureMap();
-  }
-
   size_t
   ISquareWell::captureTest(const Particle& p1, const Particle& p2) const
   {
     if (&(*(Sim->getInteraction(p1, p2))) != this) return false;
 
-    const double d = _diameter->getProperty(p1, p2);
-    const double l = _lambda->getProperty(p1, p2);
+    const double d = _diameter.getProperty(p1, p2);
+    const double l = _lambda.getProperty(p1, p2);
 
 #ifdef DYNAMO_DEBUG
     if (Sim->dynamics->sphereOverlap(p1, p2, d))
@@ -116,8 +109,8 @@ namespace dynamo {
       M_throw() << "You shouldn't pass p1==p2 events to the interactions!";
 #endif 
 
-    const double d = _diameter->getProperty(p1, p2);
-    const double l = _lambda->getProperty(p1, p2);
+    const double d = _diameter.getProperty(p1, p2);
+    const double l = _lambda.getProperty(p1, p2);
 
     IntEvent retval(p1, p2, HUGE_VAL, NONE, *this);
 
@@ -147,12 +140,12 @@ namespace dynamo {
   {
     ++Sim->eventCount;
 
-    const double d = _diameter->getProperty(p1,p2);
+    const double d = _diameter.getProperty(p1,p2);
     const double d2 = d * d;
-    const double e = _e->getProperty(p1, p2);
-    const double l = _lambda->getProperty(p1, p2);
+    const double e = _e.getProperty(p1, p2);
+    const double l = _lambda.getProperty(p1, p2);
     const double ld2 = d * l * d * l;
-    const double wd = _wellDepth->getProperty(p1, p2);
+    const double wd = _wellDepth.getProperty(p1, p2);
 
     PairEventData retVal;
     switch (iEvent.getType())
@@ -184,8 +177,8 @@ namespace dynamo {
   bool
   ISquareWell::validateState(const Particle& p1, const Particle& p2, bool textoutput) const
   {
-    const double d = _diameter->getProperty(p1, p2);
-    const double l = _lambda->getProperty(p1, p2);
+    const double d = _diameter.getProperty(p1, p2);
+    const double l = _lambda.getProperty(p1, p2);
 
     if (isCaptured(p1, p2))
       {
@@ -257,6 +250,6 @@ namespace dynamo {
   double 
   ISquareWell::getInternalEnergy(const Particle& p1, const Particle& p2) const
   {
-    return - _wellDepth->getProperty(p1, p2) * isCaptured(p1, p2);
+    return - _wellDepth.getProperty(p1, p2) * isCaptured(p1, p2);
   }
 }
@@ -46,9 +46,9 @@ namespace dynamo {
 
     virtual size_t captureTest(const Particle&, const Particle&) const;
 
-    virtual void initialise(size_t);
-
     virtual IntEvent getEvent(const Particle&, const Particle&) const;
+
+    virtual bool concurrentEvents() const { return true; }
   
     virtual PairEventData runEvent(Particle&, Particle&, const IntEvent&);
   
@@ -62,9 +62,9 @@ namespace dynamo {
     ISquareWell(dynamo::Simulation* tmp, IDPairRange* nR):
       ICapture(tmp,nR) {}
 
-    shared_ptr<Property> _diameter;
-    shared_ptr<Property> _lambda;
-    shared_ptr<Property> _wellDepth;
-    shared_ptr<Property> _e;
+    PropertyHandle _diameter;
+    PropertyHandle _lambda;
+    PropertyHandle _wellDepth;
+    PropertyHandle _e;
   };
 }
@@ -64,33 +64,26 @@ namespace dynamo {
   IStepped::getExcludedVolume(size_t ID) const 
   { 
     //Get the inner diameter
-    double diam = _potential->hard_core_diameter() * _lengthScale->getProperty(ID);
+    double diam = _potential->hard_core_diameter() * _lengthScale.getProperty(ID);
     return (M_PI / 6) * diam * diam * diam; 
   }
 
   std::array<double, 4>
   IStepped::getGlyphSize(size_t ID) const
   { 
-    return {{_potential->render_diameter() * _lengthScale->getProperty(ID), 0, 0, 0}};
+    return {{_potential->render_diameter() * _lengthScale.getProperty(ID), 0, 0, 0}};
   }
 
   double 
   IStepped::maxIntDist() const 
   { return _potential->max_distance() * _lengthScale->getMaxValue(); }
 
-  void 
-  IStepped::initialise(size_t nID)
-  {
-    Interaction::initialise(nID);
-    ICapture::initCaptureMap();
-  }
-
   size_t 
   IStepped::captureTest(const Particle& p1, const Particle& p2) const
   {
     if (&(*(Sim->getInteraction(p1, p2))) != this) return false;
   
-    const double length_scale = _lengthScale->getProperty(p1, p2);
+    const double length_scale = _lengthScale.getProperty(p1, p2);
 
     Vector rij = p1.getPosition() - p2.getPosition();
     Sim->BCs->applyBC(rij);
@@ -112,7 +105,7 @@ namespace dynamo {
   {
     ICapture::const_iterator capstat = ICapture::find(ICapture::key_type(p1, p2));
     if (capstat == ICapture::end()) return 0;
-    const double energy_scale = _energyScale->getProperty(p1, p2);
+    const double energy_scale = _energyScale.getProperty(p1, p2);
     return (*_potential)[capstat->second - 1].second * energy_scale;
   }
 
@@ -134,7 +127,7 @@ namespace dynamo {
     ICapture::const_iterator capstat = ICapture::find(ICapture::key_type(p1, p2));
     const size_t current_step_ID = (capstat == ICapture::end()) ? 0 : capstat->second;
     const std::pair<double, double> step_bounds = _potential->getStepBounds(current_step_ID);
-    const double length_scale = _lengthScale->getProperty(p1, p2);
+    const double length_scale = _lengthScale.getProperty(p1, p2);
 
     IntEvent retval(p1, p2, HUGE_VAL, NONE, *this);
     if (step_bounds.first != 0)
@@ -159,8 +152,8 @@ namespace dynamo {
   {
     ++Sim->eventCount;
 
-    const double length_scale = _lengthScale->getProperty(p1, p2);
-    const double energy_scale = _energyScale->getProperty(p1, p2);
+    const double length_scale = _lengthScale.getProperty(p1, p2);
+    const double energy_scale = _energyScale.getProperty(p1, p2);
 
     ICapture::const_iterator capstat = ICapture::find(ICapture::key_type(p1, p2));
     const size_t old_step_ID = (capstat == ICapture::end()) ? 0 : capstat->second;
@@ -47,8 +47,6 @@ namespace dynamo {
 
     virtual size_t captureTest(const Particle&, const Particle&) const;
 
-    virtual void initialise(size_t);
-
     virtual IntEvent getEvent(const Particle&, const Particle&) const;
   
     virtual PairEventData runEvent(Particle&, Particle&, const IntEvent&);
@@ -65,9 +63,9 @@ namespace dynamo {
 
   protected:
     //!This class is used to track how the length scale changes in the system
-    shared_ptr<Property> _lengthScale;
+    PropertyHandle _lengthScale;
     //!This class is used to track how the energy scale changes in the system
-    shared_ptr<Property> _energyScale;
+    PropertyHandle _energyScale;
 
     shared_ptr<Potential> _potential;
     
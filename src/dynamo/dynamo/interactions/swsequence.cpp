@@ -163,13 +163,6 @@ namespace dynamo {
   ISWSequence::maxIntDist() const 
   { return _diameter->getMaxValue() * _lambda->getMaxValue(); }
 
-  void 
-  ISWSequence::initialise(size_t nID)
-  {
-    Interaction::initialise(nID);
-    ICapture::initCaptureMap();
-  }
-
   size_t
   ISWSequence::captureTest(const Particle& p1, const Particle& p2) const
   {
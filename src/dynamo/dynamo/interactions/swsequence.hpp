@@ -70,8 +70,6 @@ namespace dynamo {
 
     virtual size_t captureTest(const Particle&, const Particle&) const;
 
-    virtual void initialise(size_t);
-
     virtual IntEvent getEvent(const Particle&, const Particle&) const;
   
     virtual PairEventData runEvent(Particle&, Particle&, const IntEvent&);
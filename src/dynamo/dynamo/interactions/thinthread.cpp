@@ -70,8 +70,8 @@ namespace dynamo {
       M_throw() << "You shouldn't pass p1==p2 events to the interactions!";
 #endif 
 
-    const double d = _diameter->getProperty(p1, p2);
-    const double l = _lambda->getProperty(p1, p2);
+    const double d = _diameter.getProperty(p1, p2);
+    const double l = _lambda.getProperty(p1, p2);
 
     IntEvent retval(p1, p2, HUGE_VAL, NONE, *this);
 
@@ -101,15 +101,15 @@ namespace dynamo {
   {
     ++Sim->eventCount;
 
-    const double d = _diameter->getProperty(p1, p2);
+    const double d = _diameter.getProperty(p1, p2);
     const double d2 = d * d;
 
-    const double e = _e->getProperty(p1, p2);
+    const double e = _e.getProperty(p1, p2);
 
-    const double l = _lambda->getProperty(p1, p2);
+    const double l = _lambda.getProperty(p1, p2);
     const double ld2 = d * l * d * l;
 
-    const double wd = _wellDepth->getProperty(p1, p2);
+    const double wd = _wellDepth.getProperty(p1, p2);
 
     PairEventData retVal;
     switch (iEvent.getType())
@@ -140,8 +140,8 @@ namespace dynamo {
   bool
   IThinThread::validateState(const Particle& p1, const Particle& p2, bool textoutput) const
   {
-    const double d = _diameter->getProperty(p1, p2);
-    const double l = _lambda->getProperty(p1, p2);
+    const double d = _diameter.getProperty(p1, p2);
+    const double l = _lambda.getProperty(p1, p2);
 
     if (isCaptured(p1, p2))
       {
@@ -51,6 +51,13 @@ namespace dynamo {
 
     virtual LocalEvent getEvent(const Particle&) const = 0;
 
+    /*! \brief Returns true if getEvent may be called concurrently
+        from several threads.
+
+	\sa Interaction::concurrentEvents
+     */
+    virtual bool concurrentEvents() const { return false; }
+
     virtual void runEvent(Particle&, const LocalEvent&) const = 0;
   
     virtual void initialise(size_t nID)  { ID = nID; }
@@ -67,6 +74,9 @@ namespace dynamo {
 
     inline const size_t& getID() const { return ID; }
 
+    //! \brief Returns the IDRange of particles this Local acts on.
+    const shared_ptr<IDRange>& getRange() const { return range; }
+
     /* \brief Test if a particle is in a valid state according to this
        local.
        
@@ -44,6 +44,8 @@ namespace dynamo {
 
     virtual LocalEvent getEvent(const Particle&) const;
 
+    virtual bool concurrentEvents() const { return true; }
+
     virtual void runEvent(Particle&, const LocalEvent&) const;
   
     virtual void operator<<(const magnet::xml::Node&);
@@ -16,12 +16,15 @@
 */
 
 #include <dynamo/locals/oscillatingplate.hpp>
-#include <dynamo/dynamics/dynamics.hpp>
+#include <dynamo/dynamics/newtonian.hpp>
+#include <dynamo/dynamics/gravity.hpp>
+#include <dynamo/BC/BC.hpp>
 #include <dynamo/locals/localEvent.hpp>
 #include <dynamo/NparticleEventData.hpp>
 #include <dynamo/units/units.hpp>
 #include <dynamo/schedulers/scheduler.hpp>
 #include <dynamo/outputplugins/outputplugin.hpp>
+#include <algorithm>
 
 namespace dynamo {
   LOscillatingPlate::LOscillatingPlate(dynamo::Simulation* nSim,
@@ -66,10 +69,31 @@ namespace dynamo {
 
     if (eventData.second == HUGE_VAL)
       type = NONE;
+
+    addDependent(part);
   
     return LocalEvent(part, eventData.second, type, *this);
   }
 
+  void
+  LOscillatingPlate::addDependent(const Particle& part) const
+  {
+    if (!Sim->ptrScheduler) return;
+
+    const std::vector<size_t>& eventCounts = Sim->ptrScheduler->getEventCounts();
+    if (part.getID() >= eventCounts.size()) return;
+
+    //Compact out the stale entries before the list would need to
+    //grow
+    if (_dependents.size() == _dependents.capacity())
+      _dependents.erase(std::remove_if(_dependents.begin(), _dependents.end(), 
+				       [&](const std::pair<size_t, size_t>& dependent)
+				       { return dependent.second != eventCounts[dependent.first]; }),
+			_dependents.end());
+
+    _dependents.push_back(std::make_pair(part.getID(), eventCounts[part.getID()]));
+  }
+
 
 
   void
@@ -87,16 +111,63 @@ namespace dynamo {
 
     Sim->_sigParticleUpdate(EDat);
 
-    //Now we're past the event update the scheduler and plugins
-    //if (strongPlate) 
-    //  Sim->ptrScheduler->fullUpdate(part);
-    //else
-    Sim->ptrScheduler->rebuildList();
+    //Now we're past the event update the scheduler and plugins.
+    if (!strongPlate && (!std::dynamic_pointer_cast<DynNewtonian>(Sim->dynamics)
+			 || std::dynamic_pointer_cast<DynGravity>(Sim->dynamics)))
+      {
+	//getMinimumCollisionTime is not a bound on curved
+	//trajectories, so every event is recalculated.
+	_dependents.clear();
+	Sim->ptrScheduler->rebuildList();
+      }
+    else
+      {
+	//The list is taken first, as the updates below add new
+	//dependents.
+	std::vector<std::pair<size_t, size_t> > dependents;
+	if (!strongPlate)
+	  dependents.swap(_dependents);
+
+	Sim->ptrScheduler->fullUpdate(part);
+
+	//If the plate motion has changed, the events of every particle
+	//predicted using the old motion are invalid. Rather than
+	//searching for the new collision of each of these particles, a
+	//RECALCULATE event is scheduled at the earliest time they can
+	//reach the plate. Most particles have other events before then
+	//and are updated anyway. Particles updated since their
+	//prediction (including duplicate entries) have a changed event
+	//counter and are skipped.
+	const std::vector<size_t>& eventCounts = Sim->ptrScheduler->getEventCounts();
+	for (const std::pair<size_t, size_t>& dependent : dependents)
+	  if (dependent.second == eventCounts[dependent.first])
+	    {
+	      Particle& other = Sim->particles[dependent.first];
+	      Sim->dynamics->updateParticle(other);
+	      Sim->ptrScheduler->pushEvent(other, Event(LocalEvent(other, getMinimumCollisionTime(other), RECALCULATE, *this)));
+	      Sim->ptrScheduler->sort(other);
+	      addDependent(other);
+	    }
+      }
 
     for (shared_ptr<OutputPlugin> & Ptr : Sim->outputPlugins)
       Ptr->eventUpdate(iEvent, EDat);
   }
 
+  double
+  LOscillatingPlate::getMinimumCollisionTime(const Particle& part) const
+  {
+    Vector pos(part.getPosition() - getPosition()), vel(part.getVelocity());
+    Sim->BCs->applyBC(pos, vel);
+
+    //The particle is between the two faces of the plate at +/-sigma,
+    //and the separation to the nearest face closes no faster than the
+    //particle and the plate can approach each other.
+    const double gap = sigma - std::abs(pos | nhat);
+    const double maxApproachVel = std::abs(vel | nhat) + delta * omega0;
+    return std::max(0.0, gap / maxApproachVel);
+  }
+
   void 
   LOscillatingPlate::operator<<(const magnet::xml::Node& XML)
   {
@@ -62,6 +62,19 @@ namespace dynamo {
 
     virtual void outputXML(magnet::xml::XmlStream&) const;
 
+    //! \brief Records that the scheduled events of a particle depend on the plate motion.
+    void addDependent(const Particle&) const;
+
+    /*! \brief A lower bound on the time until a particle collides
+        with the plate, valid for the current plate motion.
+
+	The bound assumes the particle moves in a straight line at
+	its current velocity, so it is only valid for DynNewtonian
+	motion. runEvent falls back to rebuilding the event list for
+	dynamics with curved trajectories (e.g., DynGravity).
+     */
+    double getMinimumCollisionTime(const Particle&) const;
+
     bool strongPlate;
     Vector rw0;
     Vector nhat;
@@ -73,5 +86,17 @@ namespace dynamo {
     mutable double timeshift;
     mutable size_t lastID;
     mutable long double lastsystemTime;
+
+    /*! \brief The particles whose events were predicted with the
+        current plate motion.
+
+	Each entry holds a particle ID and the scheduler event counter
+	of the particle when its event was predicted. If the counter
+	has since changed, the events of the particle have been
+	recalculated and the entry is stale. When a collision changes
+	the plate motion, only these particles are updated instead of
+	rebuilding the whole event list.
+     */
+    mutable std::vector<std::pair<size_t, size_t> > _dependents;
   };
 }
@@ -23,6 +23,9 @@
 #include <dynamo/units/units.hpp>
 #include <dynamo/schedulers/scheduler.hpp>
 #include <dynamo/outputplugins/outputplugin.hpp>
+#include <dynamo/species/species.hpp>
+#include <algorithm>
+#include <numeric>
 
 
 namespace dynamo {
@@ -30,6 +33,147 @@ namespace dynamo {
     Local(tmp, "LocalWall")
   { operator<<(XML); }
 
+  void 
+  LTriangleMesh::initialise(size_t nID)
+  {
+    Local::initialise(nID);
+    buildBVH();
+  }
+
+  void
+  LTriangleMesh::buildBVH()
+  {
+    _bvh.clear();
+    _bvhTriangles.clear();
+
+    if (_elements.size() < BVHMinTriangles) return;
+
+    _bvhTriangles.resize(_elements.size());
+    std::iota(_bvhTriangles.begin(), _bvhTriangles.end(), 0);
+    _bvh.reserve(2 * (_elements.size() / BVHLeafSize + 1));
+    buildBVHNode(0, _elements.size());
+
+    //The search boxes should rarely be left by a particle before it
+    //hits something, but should only hold a few triangles. They are
+    //sized by the largest particle and the mean triangle size.
+    double meanSize = 0;
+    for (const TriangleElements& elem : _elements)
+      {
+	const Vector& A(_vertices[std::get<0>(elem)]);
+	const Vector& B(_vertices[std::get<1>(elem)]);
+	const Vector& C(_vertices[std::get<2>(elem)]);
+	meanSize += std::max((B - A).nrm(), std::max((C - B).nrm(), (A - C).nrm()));
+      }
+    meanSize /= _elements.size();
+
+    _searchHalfWidth = std::max(_diameter->getMaxValue(), meanSize);
+
+    //The search boxes must be smaller than half the simulation box,
+    //so that the periodic images of a box do not overlap.
+    for (size_t iDim(0); iDim < NDIM; ++iDim)
+      if (2 * _searchHalfWidth >= 0.5 * Sim->primaryCellSize[iDim])
+	{
+	  _bvh.clear();
+	  _bvhTriangles.clear();
+	  return;
+	}
+
+    _searchBoxes.resize(Sim->N());
+    for (const Particle& part : Sim->particles)
+      _searchBoxes[part.getID()] = part.getPosition();
+
+    dout << "Built a BVH of " << _bvh.size() << " nodes over " << _elements.size() 
+	 << " triangles, search box width " << 2 * _searchHalfWidth / Sim->units.unitLength() << std::endl;
+  }
+
+  size_t
+  LTriangleMesh::buildBVHNode(size_t first, size_t last)
+  {
+    const size_t nodeID = _bvh.size();
+    _bvh.push_back(BVHNode());
+
+    Vector lower(HUGE_VAL, HUGE_VAL, HUGE_VAL), upper(-HUGE_VAL, -HUGE_VAL, -HUGE_VAL);
+    Vector centroidLower = lower, centroidUpper = upper;
+    for (size_t i(first); i < last; ++i)
+      {
+	const TriangleElements& elem = _elements[_bvhTriangles[i]];
+	const Vector& A(_vertices[std::get<0>(elem)]);
+	const Vector& B(_vertices[std::get<1>(elem)]);
+	const Vector& C(_vertices[std::get<2>(elem)]);
+	const Vector centroid = (A + B + C) / 3.0;
+	for (size_t iDim(0); iDim < NDIM; ++iDim)
+	  {
+	    lower[iDim] = std::min(lower[iDim], std::min(A[iDim], std::min(B[iDim], C[iDim])));
+	    upper[iDim] = std::max(upper[iDim], std::max(A[iDim], std::max(B[iDim], C[iDim])));
+	    centroidLower[iDim] = std::min(centroidLower[iDim], centroid[iDim]);
+	    centroidUpper[iDim] = std::max(centroidUpper[iDim], centroid[iDim]);
+	  }
+      }
+
+    _bvh[nodeID].centre = 0.5 * (lower + upper);
+    _bvh[nodeID].halfWidth = 0.5 * (upper - lower);
+    _bvh[nodeID].first = first;
+    _bvh[nodeID].count = 0;
+    _bvh[nodeID].secondChild = 0;
+
+    if (last - first <= BVHLeafSize)
+      {
+	_bvh[nodeID].count = last - first;
+	return nodeID;
+      }
+
+    //Split the triangles in half along the axis where their
+    //centroids are most spread out
+    size_t axis = 0;
+    for (size_t iDim(1); iDim < NDIM; ++iDim)
+      if (centroidUpper[iDim] - centroidLower[iDim] > centroidUpper[axis] - centroidLower[axis])
+	axis = iDim;
+
+    const size_t mid = (first + last) / 2;
+    std::nth_element(_bvhTriangles.begin() + first, _bvhTriangles.begin() + mid, _bvhTriangles.begin() + last,
+		     [&](size_t a, size_t b)
+		     {
+		       const TriangleElements& ea = _elements[a];
+		       const TriangleElements& eb = _elements[b];
+		       return (_vertices[std::get<0>(ea)][axis] + _vertices[std::get<1>(ea)][axis] + _vertices[std::get<2>(ea)][axis])
+			 < (_vertices[std::get<0>(eb)][axis] + _vertices[std::get<1>(eb)][axis] + _vertices[std::get<2>(eb)][axis]);
+		     });
+
+    buildBVHNode(first, mid);
+    const size_t secondChild = buildBVHNode(mid, last);
+    _bvh[nodeID].secondChild = secondChild;
+    return nodeID;
+  }
+
+  bool
+  LTriangleMesh::insideSearchBox(const Particle& part) const
+  {
+    const Vector& boxCentre = _searchBoxes[part.getID()];
+
+    Vector separation = part.getPosition() - boxCentre;
+    Sim->BCs->applyBC(separation);
+
+    //A particle leaving its box is on the boundary, which is allowed
+    //for (with a tolerance for rounding) so that its VIRTUAL event
+    //is not pushed back by a recalculation.
+    for (size_t iDim(0); iDim < NDIM; ++iDim)
+      if (std::abs(separation[iDim]) > _searchHalfWidth * (1 + 1e-8))
+	return false;
+
+    return true;
+  }
+
+  std::pair<double, size_t>
+  LTriangleMesh::getTriangleEvent(const Particle& part, size_t triangleID, double radius) const
+  {
+    const TriangleElements& elem = _elements[triangleID];
+    return Sim->dynamics->getSphereTriangleEvent(part,
+						 _vertices[std::get<0>(elem)],
+						 _vertices[std::get<1>(elem)],
+						 _vertices[std::get<2>(elem)],
+						 radius);
+  }
+
   LocalEvent 
   LTriangleMesh::getEvent(const Particle& part) const
   {
@@ -43,23 +187,92 @@ namespace dynamo {
 
     std::pair<double, size_t> tmin(HUGE_VAL, 0); //Default to no collision
 
-    for (size_t id(0); id < _elements.size(); ++id)
+    if (_bvh.empty())
       {
-	std::pair<double, size_t> t 
-	  = Sim->dynamics->getSphereTriangleEvent(part,
-						  _vertices[std::get<0>(_elements[id])],
-						  _vertices[std::get<1>(_elements[id])],
-						  _vertices[std::get<2>(_elements[id])],
-						  diam);
-	if (t < tmin) { tmin = t; triangleid = id; }
+	for (size_t id(0); id < _elements.size(); ++id)
+	  {
+	    std::pair<double, size_t> t = getTriangleEvent(part, id, diam);
+	    if (t < tmin) { tmin = t; triangleid = id; }
+	  }
+
+	return LocalEvent(part, tmin.first, WALL, *this, 8 * triangleid + tmin.second);
       }
 
+    //The search box of a particle only moves when the particle leaves
+    //it (see runEvent), so recalculating the event before it is
+    //executed gives the same result. The particle cannot leave the
+    //box before the horizon, so only triangles within reach of the
+    //box can be hit before then. A particle outside of its box
+    //(e.g., one moved by a System) is searched around its current
+    //position until the box is recentred by runEvent.
+    const Vector halfWidth(_searchHalfWidth, _searchHalfWidth, _searchHalfWidth);
+    const Vector boxCentre = insideSearchBox(part) ? _searchBoxes[part.getID()] : part.getPosition();
+
+    const double horizon = std::max(0.0, Sim->dynamics->getSquareCellCollision2(part, boxCentre - halfWidth, 2 * halfWidth));
+    const Vector reach = halfWidth + Vector(diam, diam, diam);
+
+    //The BVH depth is logarithmic in the triangle count, so this
+    //stack cannot overflow
+    size_t stack[128];
+    size_t stackSize = 0;
+    stack[stackSize++] = 0;
+    while (stackSize)
+      {
+	const size_t nodeID = stack[--stackSize];
+	const BVHNode& node = _bvh[nodeID];
+
+	Vector separation = node.centre - boxCentre;
+	Sim->BCs->applyBC(separation);
+
+	bool overlap = true;
+	for (size_t iDim(0); iDim < NDIM; ++iDim)
+	  if (std::abs(separation[iDim]) > node.halfWidth[iDim] + reach[iDim])
+	    { overlap = false; break; }
+
+	if (!overlap) continue;
+
+	if (node.count)
+	  for (size_t i(node.first); i < node.first + node.count; ++i)
+	    {
+	      const size_t id = _bvhTriangles[i];
+	      std::pair<double, size_t> t = getTriangleEvent(part, id, diam);
+	      //Ties are resolved as in the brute force search
+	      if ((t < tmin) || ((t == tmin) && (id < triangleid))) { tmin = t; triangleid = id; }
+	    }
+	else
+	  {
+	    stack[stackSize++] = node.secondChild;
+	    stack[stackSize++] = nodeID + 1;
+	  }
+      }
+
+    if (tmin.first > horizon)
+      return LocalEvent(part, horizon, VIRTUAL, *this);
+
     return LocalEvent(part, tmin.first, WALL, *this, 8 * triangleid + tmin.second);
   }
 
   void
   LTriangleMesh::runEvent(Particle& part, const LocalEvent& iEvent) const
   { 
+    if (iEvent.getType() == VIRTUAL)
+      {
+	//The particle has left its search box, so a new box is centred
+	//on it and its events are recalculated
+	Sim->dynamics->updateParticle(part);
+	_searchBoxes[part.getID()] = part.getPosition();
+
+	NEventData EDat(ParticleEventData(part, *Sim->species(part), VIRTUAL));
+
+	Sim->_sigParticleUpdate(EDat);
+
+	Sim->ptrScheduler->fullUpdate(part);
+  
+	for (shared_ptr<OutputPlugin> & Ptr : Sim->outputPlugins)
+	  Ptr->eventUpdate(iEvent, EDat);
+	return;
+      }
+
     ++Sim->eventCount;
   
     const size_t triangleID = iEvent.getExtraData() / Dynamics::T_COUNT;
@@ -141,6 +354,9 @@ namespace dynamo {
 
     NEventData EDat(Sim->dynamics->runPlaneEvent(part, normal, _e->getProperty(part), 0.0));
 
+    if (!_bvh.empty() && !insideSearchBox(part))
+      _searchBoxes[part.getID()] = part.getPosition();
+
     Sim->_sigParticleUpdate(EDat);
 
     //Now we're past the event update the scheduler and plugins
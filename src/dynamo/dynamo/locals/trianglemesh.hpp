@@ -27,6 +27,15 @@
 #endif
 
 namespace dynamo {
+  /*! \brief A wall made of a mesh of triangles.
+
+    Large meshes (e.g., imported hoppers) are stored in a bounding
+    volume hierarchy (BVH) of the triangle bounds. Events are only
+    calculated for the triangles near a particle, within a search box
+    around the particle. If no event occurs before the particle
+    leaves this box, a VIRTUAL event is scheduled at the time it
+    leaves, where a new box is centred on the particle.
+   */
   class LTriangleMesh: public Local, public CoilRenderObj
   {
   public:
@@ -41,6 +50,8 @@ namespace dynamo {
 
     virtual ~LTriangleMesh() {}
 
+    virtual void initialise(size_t nID);
+
     virtual LocalEvent getEvent(const Particle&) const;
 
     virtual void runEvent(Particle&, const LocalEvent&) const;
@@ -66,6 +77,45 @@ namespace dynamo {
     typedef std::tuple<size_t, size_t, size_t> TriangleElements;
     std::vector<TriangleElements> _elements;
 
+    /*! \brief A node of the bounding volume hierarchy.
+
+      The nodes are stored in depth-first order, so the first child
+      of a node directly follows it.
+     */
+    struct BVHNode
+    {
+      Vector centre;
+      Vector halfWidth;
+      //! \brief The first entry of the node's triangles in _bvhTriangles.
+      size_t first;
+      //! \brief The number of triangles in a leaf node, zero for branch nodes.
+      size_t count;
+      //! \brief The index of the second child of a branch node.
+      size_t secondChild;
+    };
+
+    //! \brief Meshes with fewer triangles than this are tested by brute force.
+    static const size_t BVHMinTriangles = 32;
+    //! \brief The maximum number of triangles in a leaf of the BVH.
+    static const size_t BVHLeafSize = 4;
+
+    void buildBVH();
+    size_t buildBVHNode(size_t first, size_t last);
+    std::pair<double, size_t> getTriangleEvent(const Particle&, size_t triangleID, double radius) const;
+
+    std::vector<BVHNode> _bvh;
+    std::vector<size_t> _bvhTriangles;
+    bool insideSearchBox(const Particle&) const;
+
+    //! \brief Half the width of the boxes searched for triangles.
+    double _searchHalfWidth;
+    /*! \brief The centre of the current search box of each particle.
+
+      This is only moved by runEvent, so getEvent does not modify any
+      state.
+     */
+    mutable std::vector<Vector> _searchBoxes;
+
     shared_ptr<Property> _e;
     shared_ptr<Property> _diameter;
   };
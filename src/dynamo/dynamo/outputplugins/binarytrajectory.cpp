@@ -0,0 +1,447 @@
+/*  dynamo:- Event driven molecular dynamics simulator 
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <dynamo/outputplugins/binarytrajectory.hpp>
+#include <dynamo/units/units.hpp>
+#include <dynamo/globals/globEvent.hpp>
+#include <dynamo/interactions/intEvent.hpp>
+#include <dynamo/locals/localEvent.hpp>
+#include <dynamo/NparticleEventData.hpp>
+#include <dynamo/systems/system.hpp>
+#include <dynamo/species/species.hpp>
+#include <dynamo/BC/BC.hpp>
+#include <magnet/xmlwriter.hpp>
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+
+namespace dynamo {
+  namespace {
+    const char binaryTrajectoryMagic[8] = {'D', 'Y', 'N', 'A', 'M', 'O', 'T', 'R'};
+    const char binaryTrajectoryIndexMagic[8] = {'D', 'Y', 'N', 'T', 'R', 'I', 'D', 'X'};
+    const uint32_t binaryTrajectoryVersion = 1;
+
+    //! \brief The number of records buffered before they are written.
+    const size_t bufferedRecords = 8192;
+    //! \brief The minimum number of records between index entries.
+    const uint64_t indexInterval = 4096;
+
+    struct BinaryTrajectoryHeader
+    {
+      char magic[8];
+      uint32_t version;
+      uint32_t recordSize;
+    };
+
+    //! \brief The end of the file, after the index entries.
+    struct BinaryTrajectoryTrailer
+    {
+      uint64_t indexOffset;
+      uint64_t indexEntries;
+      uint64_t records;
+      char magic[8];
+    };
+
+    static_assert(sizeof(BinaryTrajectoryHeader) == 16, "Unexpected padding in the binary trajectory header");
+    static_assert(sizeof(BinaryTrajectoryRecord) == 144, "Unexpected padding in the binary trajectory record");
+    static_assert(sizeof(BinaryTrajectoryIndexEntry) == 16, "Unexpected padding in the binary trajectory index");
+    static_assert(sizeof(BinaryTrajectoryTrailer) == 32, "Unexpected padding in the binary trajectory trailer");
+
+    //The records are stored in the native byte order, which must be
+    //little-endian.
+    void checkHostByteOrder()
+    {
+      const uint16_t probe = 1;
+      if (*reinterpret_cast<const uint8_t*>(&probe) != 1)
+	M_throw() << "Binary trajectory files are only supported on little-endian hosts";
+    }
+
+    void setVector(double* data, const Vector& vec)
+    {
+      for (size_t iDim(0); iDim < NDIM; ++iDim)
+	data[iDim] = vec[iDim];
+    }
+
+    Vector getVector(const double* data)
+    { return Vector(data[0], data[1], data[2]); }
+  }
+
+  OPBinaryTrajectory::OPBinaryTrajectory(const dynamo::Simulation* t1, const magnet::xml::Node& XML):
+    OutputPlugin(t1, "BinaryTrajectory"),
+    _fileName("trajectory.dtrj"),
+    _records(0)
+  {
+    if (XML.hasAttribute("File"))
+      _fileName = XML.getAttribute("File").getValue();
+  }
+
+  OPBinaryTrajectory::~OPBinaryTrajectory()
+  {
+    try { finish(); }
+    catch (std::exception& cep)
+      { derr << "Failed to complete the binary trajectory file:-\n" << cep.what() << std::endl; }
+  }
+
+  void
+  OPBinaryTrajectory::initialise()
+  {
+    checkHostByteOrder();
+    finish();
+
+    _file.reset(new std::ofstream(_fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc));
+    if (!*_file)
+      M_throw() << "Failed to open the binary trajectory file " << _fileName;
+
+    BinaryTrajectoryHeader header;
+    std::memcpy(header.magic, binaryTrajectoryMagic, sizeof(header.magic));
+    header.version = binaryTrajectoryVersion;
+    header.recordSize = sizeof(BinaryTrajectoryRecord);
+    _file->write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    _records = 0;
+    _index.clear();
+    _buffer.clear();
+    _buffer.reserve(bufferedRecords);
+
+    //Two buffers may wait to be written before the simulation is
+    //made to wait for the disk.
+    if (!_writer)
+      _writer.reset(new magnet::thread::BackgroundWorker(2));
+  }
+
+  void
+  OPBinaryTrajectory::push(const BinaryTrajectoryRecord& record)
+  {
+    if ((record.kind < BinaryTrajectoryRecord::PARTICLE_CHANGE)
+	&& (_index.empty() || (_records - _index.back().record >= indexInterval)))
+      _index.push_back(BinaryTrajectoryIndexEntry{record.eventCount, _records});
+
+    _buffer.push_back(record);
+    ++_records;
+
+    if (_buffer.size() >= bufferedRecords)
+      flush();
+  }
+
+  void
+  OPBinaryTrajectory::flush()
+  {
+    if (_buffer.empty()) return;
+
+    shared_ptr<std::vector<BinaryTrajectoryRecord> > data(new std::vector<BinaryTrajectoryRecord>);
+    data->swap(_buffer);
+    _buffer.reserve(bufferedRecords);
+
+    shared_ptr<std::ofstream> file(_file);
+    const std::string fileName(_fileName);
+    _writer->queueTask(std::function<void()>([=]()
+      {
+	file->write(reinterpret_cast<const char*>(data->data()), data->size() * sizeof(BinaryTrajectoryRecord));
+	if (!*file)
+	  M_throw() << "Failed to write to the binary trajectory file " << fileName;
+      }));
+  }
+
+  void
+  OPBinaryTrajectory::finish()
+  {
+    if (!_file) return;
+
+    flush();
+
+    BinaryTrajectoryTrailer trailer;
+    trailer.indexOffset = sizeof(BinaryTrajectoryHeader) + _records * sizeof(BinaryTrajectoryRecord);
+    trailer.indexEntries = _index.size();
+    trailer.records = _records;
+    std::memcpy(trailer.magic, binaryTrajectoryIndexMagic, sizeof(trailer.magic));
+
+    shared_ptr<std::ofstream> file(_file);
+    std::vector<BinaryTrajectoryIndexEntry> index;
+    index.swap(_index);
+    _file.reset();
+
+    _writer->queueTask(std::function<void()>([=]()
+      {
+	file->write(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(BinaryTrajectoryIndexEntry));
+	file->write(reinterpret_cast<const char*>(&trailer), sizeof(trailer));
+	file->close();
+      }));
+
+    _writer->wait();
+  }
+
+  void
+  OPBinaryTrajectory::setPairData(BinaryTrajectoryRecord& record, size_t p1, size_t p2) const
+  {
+    //The pair is ordered and reported using the original IDs of the
+    //particles, in case the Simulation has reordered them
+    if (Sim->getExternalID(p1) > Sim->getExternalID(p2))
+      std::swap(p1, p2);
+
+    Vector rij = Sim->particles[p1].getPosition() - Sim->particles[p2].getPosition(),
+      vij = Sim->particles[p1].getVelocity() - Sim->particles[p2].getVelocity();
+    Sim->BCs->applyBC(rij, vij);
+
+    record.ID1 = Sim->getExternalID(p1);
+    record.ID2 = Sim->getExternalID(p2);
+    setVector(record.data[1], rij / Sim->units.unitLength());
+    setVector(record.data[2], vij / Sim->units.unitVelocity());
+  }
+
+  void 
+  OPBinaryTrajectory::eventUpdate(const IntEvent& eevent, const PairEventData& pdat)
+  {
+    BinaryTrajectoryRecord record = BinaryTrajectoryRecord();
+    record.eventCount = Sim->eventCount;
+    record.time = Sim->systemTime / Sim->units.unitTime();
+    record.dt = eevent.getdt() / Sim->units.unitTime();
+    record.sourceID = eevent.getInteractionID();
+    record.kind = BinaryTrajectoryRecord::INTERACTION_EVENT;
+    record.eventType = eevent.getType();
+
+    //The impulse is reported for the particle with the lower original ID
+    const double sign = (Sim->getExternalID(eevent.getParticle1ID()) < Sim->getExternalID(eevent.getParticle2ID())) ? -1 : 1;
+    setVector(record.data[0], sign * pdat.impulse / Sim->units.unitMomentum());
+    setPairData(record, eevent.getParticle1ID(), eevent.getParticle2ID());
+    push(record);
+  }
+
+  void
+  OPBinaryTrajectory::addEvent(BinaryTrajectoryRecord::Kind kind, size_t sourceID, EEventType type, 
+			       double dt, const NEventData& SDat)
+  {
+    BinaryTrajectoryRecord record = BinaryTrajectoryRecord();
+    record.eventCount = Sim->eventCount;
+    record.time = Sim->systemTime / Sim->units.unitTime();
+    record.dt = dt / Sim->units.unitTime();
+    record.sourceID = sourceID;
+    record.kind = kind;
+    record.eventType = type;
+    push(record);
+
+    //The change records share the event data of the first record
+    record.kind = BinaryTrajectoryRecord::PARTICLE_CHANGE;
+    for (const ParticleEventData& pData : SDat.L1partChanges)
+      {
+	const Particle& part = Sim->particles[pData.getParticleID()];
+	const double mass = Sim->species[pData.getSpeciesID()]->getMass(part.getID());
+	record.ID1 = Sim->getExternalID(part.getID());
+	setVector(record.data[0], mass * (part.getVelocity() - pData.getOldVel()) / Sim->units.unitMomentum());
+	setVector(record.data[1], part.getPosition() / Sim->units.unitLength());
+	setVector(record.data[2], part.getVelocity() / Sim->units.unitVelocity());
+	setVector(record.data[3], pData.getOldVel() / Sim->units.unitVelocity());
+	push(record);
+      }
+
+    record.kind = BinaryTrajectoryRecord::PAIR_CHANGE;
+    std::fill(record.data[0], record.data[0] + 3, 0.0);
+    std::fill(record.data[3], record.data[3] + 3, 0.0);
+    for (const PairEventData& pData : SDat.L2partChanges)
+      {
+	setPairData(record, pData.particle1_.getParticleID(), pData.particle2_.getParticleID());
+	push(record);
+      }
+  }
+
+  void 
+  OPBinaryTrajectory::eventUpdate(const GlobalEvent& eevent, const NEventData& SDat)
+  { addEvent(BinaryTrajectoryRecord::GLOBAL_EVENT, eevent.getGlobalID(), eevent.getType(), eevent.getdt(), SDat); }
+
+  void 
+  OPBinaryTrajectory::eventUpdate(const LocalEvent& eevent, const NEventData& SDat)
+  { addEvent(BinaryTrajectoryRecord::LOCAL_EVENT, eevent.getLocalID(), eevent.getType(), eevent.getdt(), SDat); }
+
+  void 
+  OPBinaryTrajectory::eventUpdate(const System& sys, const NEventData& SDat, const double& dt)
+  { addEvent(BinaryTrajectoryRecord::SYSTEM_EVENT, sys.getID(), sys.getType(), dt, SDat); }
+
+  void 
+  OPBinaryTrajectory::output(magnet::xml::XmlStream& XML)
+  {
+    //Make sure everything recorded so far is on disk
+    flush();
+    if (_writer)
+      _writer->wait();
+
+    XML << magnet::xml::tag("BinaryTrajectory")
+	<< magnet::xml::attr("File") << _fileName
+	<< magnet::xml::attr("Records") << _records
+	<< magnet::xml::endtag("BinaryTrajectory");
+  }
+
+  BinaryTrajectoryReader::BinaryTrajectoryReader(const std::string& fileName):
+    _data(NULL),
+    _records(0),
+    _index(NULL),
+    _indexSize(0)
+  {
+    checkHostByteOrder();
+
+    try {
+      _file.open(fileName);
+    } catch (std::exception& err)
+      {
+	M_throw() << "Failed to map the binary trajectory file " << fileName << "\n" << err.what();
+      }
+
+    if (_file.size() < sizeof(BinaryTrajectoryHeader))
+      M_throw() << "The binary trajectory file " << fileName << " is truncated";
+
+    BinaryTrajectoryHeader header;
+    std::memcpy(&header, _file.data(), sizeof(header));
+
+    if (std::memcmp(header.magic, binaryTrajectoryMagic, sizeof(binaryTrajectoryMagic)))
+      M_throw() << fileName << " is not a binary trajectory file";
+
+    if (header.version != binaryTrajectoryVersion)
+      M_throw() << "The binary trajectory file " << fileName << " has an unsupported version (" 
+		<< header.version << ")";
+
+    if (header.recordSize != sizeof(BinaryTrajectoryRecord))
+      M_throw() << "The binary trajectory file " << fileName << " has an unexpected record size (" 
+		<< header.recordSize << ")";
+
+    _data = reinterpret_cast<const BinaryTrajectoryRecord*>(_file.data() + sizeof(BinaryTrajectoryHeader));
+    const size_t dataSize = _file.size() - sizeof(BinaryTrajectoryHeader);
+
+    BinaryTrajectoryTrailer trailer;
+    if (dataSize >= sizeof(trailer))
+      {
+	std::memcpy(&trailer, _file.data() + _file.size() - sizeof(trailer), sizeof(trailer));
+	if (!std::memcmp(trailer.magic, binaryTrajectoryIndexMagic, sizeof(binaryTrajectoryIndexMagic))
+	    && (trailer.indexOffset == sizeof(BinaryTrajectoryHeader) + trailer.records * sizeof(BinaryTrajectoryRecord))
+	    && (trailer.indexOffset + trailer.indexEntries * sizeof(BinaryTrajectoryIndexEntry) + sizeof(trailer) == _file.size()))
+	  {
+	    _records = trailer.records;
+	    _index = reinterpret_cast<const BinaryTrajectoryIndexEntry*>(_file.data() + trailer.indexOffset);
+	    _indexSize = trailer.indexEntries;
+	    return;
+	  }
+      }
+
+    //Without the footer, only the complete records can be used
+    _records = dataSize / sizeof(BinaryTrajectoryRecord);
+  }
+
+  size_t
+  BinaryTrajectoryReader::findEvent(uint64_t eventCount) const
+  {
+    //Narrow the search to the records between two index entries
+    size_t first = 0, last = _records;
+    const BinaryTrajectoryIndexEntry* entry 
+      = std::lower_bound(_index, _index + _indexSize, eventCount, 
+			 [](const BinaryTrajectoryIndexEntry& e, uint64_t count) { return e.eventCount < count; });
+
+    if (entry != _index + _indexSize)
+      last = entry->record;
+    if (entry != _index)
+      first = (entry - 1)->record;
+
+    return std::lower_bound(_data + first, _data + last, eventCount, 
+			    [](const BinaryTrajectoryRecord& r, uint64_t count) { return r.eventCount < count; })
+      - _data;
+  }
+
+  void
+  BinaryTrajectoryReader::writeText(std::ostream& os, size_t first, size_t last) const
+  {
+    //These are the stream settings used by OPTrajectory
+    const std::streamsize oldPrecision = os.precision(4);
+    const std::ios::fmtflags oldFlags = os.setf(std::ios::fixed);
+
+    for (size_t i(first); i < std::min(last, _records); ++i)
+      writeText(os, _data[i]);
+
+    os.precision(oldPrecision);
+    os.flags(oldFlags);
+  }
+
+  namespace {
+    void writePairText(std::ostream& os, const BinaryTrajectoryRecord& record)
+    {
+      const Vector rij = getVector(record.data[1]), vij = getVector(record.data[2]);
+
+      os << " p1 " << std::setw(5) << record.ID1
+	 << " p2 " << std::setw(5) << record.ID2
+	 << " |r12| " << std::setw(5) << rij.nrm()
+	 << " post-r12 < ";
+  
+      for (size_t iDim(0); iDim < NDIM; ++iDim)
+	os << std::setw(7) << rij[iDim] << " ";
+
+      os << ">";
+
+      os << " post-v12 < ";
+      for (size_t iDim(0); iDim < NDIM; ++iDim)
+	os << std::setw(7) << vij[iDim] << " ";
+
+      os << "> post-rvdot " << (vij | rij) ;
+    }
+  }
+
+  void
+  BinaryTrajectoryReader::writeText(std::ostream& os, const BinaryTrajectoryRecord& record)
+  {
+    const EEventType type = static_cast<EEventType>(record.eventType);
+
+    switch (record.kind)
+      {
+      case BinaryTrajectoryRecord::INTERACTION_EVENT:
+	os << std::setw(8) << record.eventCount
+	   << " INTERACTION " << record.sourceID
+	   << " TYPE " << type
+	   << " t " << std::setw(5) << record.time
+	   << " dt " << std::setw(5) << record.dt;
+
+	os << " deltaP1 < ";
+	for (size_t iDim(0); iDim < NDIM; ++iDim)
+	  os << std::setw(7) << record.data[0][iDim] << " ";
+	os << " >";
+
+	writePairText(os, record);
+	os << "\n";
+	break;
+      case BinaryTrajectoryRecord::GLOBAL_EVENT:
+      case BinaryTrajectoryRecord::LOCAL_EVENT:
+      case BinaryTrajectoryRecord::SYSTEM_EVENT:
+	{
+	  static const char* sources[] = {"", " GLOBAL ", " LOCAL ", " SYSTEM "};
+	  os << std::setw(8) << record.eventCount
+	     << sources[record.kind] << record.sourceID
+	     << " TYPE " << type
+	     << " t " << record.time
+	     << " dt " << record.dt
+	     << "\n";
+	  break;
+	}
+      case BinaryTrajectoryRecord::PARTICLE_CHANGE:
+	os << "    1PEvent p1 " << record.ID1
+	   << " delP1=" << getVector(record.data[0]).toString() 
+	   << ", pos=" << getVector(record.data[1]).toString() 
+	   << ", vel=" << getVector(record.data[2]).toString() 
+	   << ", oldvel=" << getVector(record.data[3]).toString() << "\n";
+	break;
+      case BinaryTrajectoryRecord::PAIR_CHANGE:
+	os << "    2PEvent";
+	writePairText(os, record);
+	os << "\n";
+	break;
+      default:
+	M_throw() << "Unknown binary trajectory record kind " << record.kind;
+      }
+  }
+}
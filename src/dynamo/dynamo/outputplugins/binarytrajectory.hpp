@@ -0,0 +1,173 @@
+/*  dynamo:- Event driven molecular dynamics simulator 
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <dynamo/outputplugins/outputplugin.hpp>
+#include <dynamo/eventtypes.hpp>
+#include <magnet/thread/backgroundworker.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace dynamo {
+  /*! \brief A fixed size record of the binary trajectory file.
+
+    Each event is stored as one record describing the event (the
+    source of the event is given by the kind), followed by a record
+    for each particle or pair changed by the event. Every record
+    carries the event counter, time and source of its event, so any
+    record can be interpreted on its own. Positions and velocities
+    are in reduced units and particles are identified by their
+    original (external) IDs.
+
+    The data array holds, depending on the kind of record:
+    - INTERACTION_EVENT: the impulse on particle 1, the separation
+      vector and the relative velocity of the pair after the event.
+    - PARTICLE_CHANGE: the change in momentum, the position, the new
+      velocity and the old velocity of the particle.
+    - PAIR_CHANGE: unused, the separation vector and the relative
+      velocity of the pair after the event.
+   */
+  struct BinaryTrajectoryRecord
+  {
+    enum Kind
+      {
+	INTERACTION_EVENT,
+	GLOBAL_EVENT,
+	LOCAL_EVENT,
+	SYSTEM_EVENT,
+	PARTICLE_CHANGE,
+	PAIR_CHANGE
+      };
+
+    uint64_t eventCount;
+    double time;
+    double dt;
+    uint64_t ID1;
+    uint64_t ID2;
+    //! \brief The ID of the Interaction, Global, Local or System.
+    uint32_t sourceID;
+    uint16_t kind;
+    uint16_t eventType;
+    double data[4][3];
+  };
+
+  //! \brief An entry of the index footer of a binary trajectory file.
+  struct BinaryTrajectoryIndexEntry
+  {
+    uint64_t eventCount;
+    //! \brief The number of the first record of the event.
+    uint64_t record;
+  };
+
+  /*! \brief Writes a binary trajectory file, a compact replacement
+      for the text output of OPTrajectory.
+
+    The file ("trajectory.dtrj" unless a File option is given) starts
+    with a small header, followed by a BinaryTrajectoryRecord for
+    each event and particle change. The records are collected in a
+    buffer which is written out by a background thread. When the
+    plugin is destroyed an index footer is appended, mapping the event
+    counter to the record number every few thousand records, so
+    readers can seek to any event (see BinaryTrajectoryReader).
+   */
+  class OPBinaryTrajectory: public OutputPlugin
+  {
+  public:
+    OPBinaryTrajectory(const dynamo::Simulation*, const magnet::xml::Node&);
+
+    ~OPBinaryTrajectory();
+
+    void eventUpdate(const IntEvent&, const PairEventData&);
+
+    void eventUpdate(const GlobalEvent&, const NEventData&);
+
+    void eventUpdate(const LocalEvent&, const NEventData&);
+  
+    void eventUpdate(const System&, const NEventData&, const double&);
+
+    virtual void replicaExchange(OutputPlugin&)
+    { M_throw() << "This output plugin hasn't been prepared for changes of system"; }
+
+    virtual void initialise();
+
+    virtual void output(magnet::xml::XmlStream&);
+
+  private:
+    void addEvent(BinaryTrajectoryRecord::Kind, size_t sourceID, EEventType, double dt, const NEventData&);
+
+    //! \brief Fills in the separation and relative velocity of a pair.
+    void setPairData(BinaryTrajectoryRecord&, size_t p1, size_t p2) const;
+
+    void push(const BinaryTrajectoryRecord&);
+
+    //! \brief Hands the buffered records to the background thread.
+    void flush();
+
+    //! \brief Flushes the records and writes the index footer.
+    void finish();
+
+    std::string _fileName;
+    shared_ptr<std::ofstream> _file;
+    std::vector<BinaryTrajectoryRecord> _buffer;
+    std::vector<BinaryTrajectoryIndexEntry> _index;
+    uint64_t _records;
+    shared_ptr<magnet::thread::BackgroundWorker> _writer;
+  };
+
+  /*! \brief Reads a binary trajectory file written by
+      OPBinaryTrajectory.
+
+    The file is memory mapped. If the index footer is missing (e.g.,
+    the simulation did not exit cleanly) all complete records are
+    still available, but finding an event requires a binary search of
+    the whole file.
+   */
+  class BinaryTrajectoryReader
+  {
+  public:
+    BinaryTrajectoryReader(const std::string& fileName);
+
+    size_t size() const { return _records; }
+
+    const BinaryTrajectoryRecord& operator[](size_t i) const { return _data[i]; }
+
+    bool hasIndex() const { return _indexSize; }
+
+    /*! \brief Returns the number of the first record with an event
+        counter of at least eventCount (or size() if there is none).
+     */
+    size_t findEvent(uint64_t eventCount) const;
+
+    /*! \brief Writes the records [first, last) in the text format of
+        the OPTrajectory plugin.
+     */
+    void writeText(std::ostream&, size_t first, size_t last) const;
+
+    //! \brief Writes a single record in the text format of the OPTrajectory plugin.
+    static void writeText(std::ostream&, const BinaryTrajectoryRecord&);
+
+  private:
+    boost::iostreams::mapped_file_source _file;
+    const BinaryTrajectoryRecord* _data;
+    size_t _records;
+    const BinaryTrajectoryIndexEntry* _index;
+    size_t _indexSize;
+  };
+}
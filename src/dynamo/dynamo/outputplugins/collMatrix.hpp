@@ -49,6 +49,9 @@ namespace dynamo {
 
     //This is fine to replica exchange as the interaction, global and system lookups are done using names
     virtual void replicaExchange(OutputPlugin& plug) { std::swap(Sim, static_cast<OPCollMatrix&>(plug).Sim); }
+
+    virtual void particlesReordered(const std::vector<size_t>& order)
+    { reorderParticleData(lastEvent, order); }
   
   protected:
     void newEvent(const size_t&, const EEventType&, const classKey&);
@@ -18,6 +18,8 @@
 #include <dynamo/outputplugins/misc.hpp>
 #include <dynamo/include.hpp>
 #include <dynamo/simulation.hpp>
+#include <dynamo/schedulers/scheduler.hpp>
+#include <dynamo/BC/LEBC.hpp>
 #include <magnet/memUsage.hpp>
 #include <magnet/xmlwriter.hpp>
 #include <dynamo/systems/tHalt.hpp>
@@ -113,25 +115,47 @@ namespace dynamo {
 	  _internalEnergy[ptr2->getID()] += energy;
 	}
 
-    for (const Particle& part : Sim->particles)
+    //The system sums are taken over the structure of arrays copy of
+    //the particles, particles with infinite mass have zero mass in
+    //the copy and are skipped.
+    _arrays.gatherVelocities(Sim->particles);
+    _arrays.gatherMasses(*Sim);
+    Vector sysMomentum(0, 0, 0);
+    for (size_t iDim(0); iDim < NDIM; ++iDim)
       {
-	const Species& sp = *(Sim->species(part));
-	const double mass = sp.getMass(part.getID());
-	if (std::isinf(mass)) continue;
-	kineticP += mass * Dyadic(part.getVelocity(), part.getVelocity());
-	_speciesMasses[sp.getID()] += mass;
-	_speciesMomenta[sp.getID()] += mass * part.getVelocity();
-	thermalConductivityFS += part.getVelocity() * (Sim->dynamics->getParticleKineticEnergy(part) + _internalEnergy[part.getID()]);
+	sysMomentum[iDim] = _arrays.momentum(iDim);
+	for (size_t jDim(0); jDim < NDIM; ++jDim)
+	  kineticP(iDim, jDim) = _arrays.kineticTensor(iDim, jDim);
       }
 
-    Vector sysMomentum(0, 0, 0);
-    _systemMass = 0;
-    for (size_t i(0); i < Sim->species.size(); ++i)
+    //The kinetic energy of a particle can only be taken from the
+    //arrays if it has no rotational energy and the velocity is the
+    //peculiar velocity (i.e., not for Lees-Edwards BCs).
+    const bool arrayKE = !Sim->dynamics->hasOrientationData()
+      && !std::dynamic_pointer_cast<BCLeesEdwards>(Sim->BCs);
+
+    for (size_t i(0); i < _arrays.size(); ++i)
       {
-	sysMomentum += _speciesMomenta[i];
-	_systemMass += _speciesMasses[i];
+	const double mass = _arrays.mass[i];
+	if (mass == 0) continue;
+
+	Vector vel(0, 0, 0);
+	for (size_t iDim(0); iDim < NDIM; ++iDim)
+	  vel[iDim] = _arrays.vel[iDim][i];
+
+	const uint32_t speciesID = _arrays.species[i];
+	_speciesMasses[speciesID] += mass;
+	_speciesMomenta[speciesID] += mass * vel;
+
+	const double KE = arrayKE ? 0.5 * mass * vel.nrm2()
+	  : Sim->dynamics->getParticleKineticEnergy(Sim->particles[i]);
+	thermalConductivityFS += vel * (KE + _internalEnergy[i]);
       }
 
+    _systemMass = 0;
+    for (size_t i(0); i < Sim->species.size(); ++i)
+      _systemMass += _speciesMasses[i];
+
     _kineticP.init(kineticP);
     _sysMomentum.init(sysMomentum);
 
@@ -596,8 +620,12 @@ namespace dynamo {
 	XML << endtag("Correlator");
       }
 
-    XML << endtag("MutualDiffusion")
-	<< endtag("Misc");
+    XML << endtag("MutualDiffusion");
+
+    if (Sim->ptrScheduler)
+      Sim->ptrScheduler->outputCounters(XML);
+
+    XML << endtag("Misc");
   }
 
   void
@@ -654,5 +682,8 @@ namespace dynamo {
 	      << ", <MFT> " <<  getMFT()
 	      << ", T " << getCurrentkT() / Sim->units.unitEnergy()
 	      << ", U " << _internalE.current() / (Sim->units.unitEnergy() * Sim->N());
+
+    if (SchedulerCounters::enabled && Sim->ptrScheduler)
+      I_Pcout() << ", " << Sim->ptrScheduler->getCounters().periodicOutput();
   }
 }
@@ -21,6 +21,7 @@
 #include <magnet/math/matrix.hpp>
 #include <magnet/math/timeaveragedproperty.hpp>
 #include <magnet/math/correlators.hpp>
+#include <dynamo/particleArrays.hpp>
 #include <chrono>
 #include <map>
 
@@ -57,6 +58,9 @@ namespace dynamo {
 
     void temperatureRescale(const double&);
 
+    virtual void particlesReordered(const std::vector<size_t>& order)
+    { reorderParticleData(_internalEnergy, order); }
+
     double getMeankT() const;
     double getMeanSqrkT() const;
     double getCurrentkT() const;
@@ -104,6 +108,8 @@ namespace dynamo {
 
     std::vector<double> _internalEnergy;
 
+    ParticleArrays _arrays;
+
     std::vector<double> _speciesMasses;
     std::vector<Vector> _speciesMomenta;
     double _systemMass;
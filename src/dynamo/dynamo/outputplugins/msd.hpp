@@ -48,6 +48,9 @@ namespace dynamo {
 
     virtual void replicaExchange(OutputPlugin&)
     { M_throw() << "This plugin hasn't been prepared for changes of system"; }
+
+    virtual void particlesReordered(const std::vector<size_t>& order)
+    { reorderParticleData(initPos, order); }
   
   protected:
   
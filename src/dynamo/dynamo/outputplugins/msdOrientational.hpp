@@ -52,6 +52,9 @@ namespace dynamo {
     virtual void replicaExchange(OutputPlugin&)
     { M_throw() << "This output plugin hasn't been prepared for changes of system"; }
 
+    virtual void particlesReordered(const std::vector<size_t>& order)
+    { reorderParticleData(initialConfiguration, order); }
+
   protected:
 
     std::vector<RUpair> initialConfiguration;
@@ -140,6 +140,8 @@ namespace dynamo {
       return testGeneratePlugin<OPChainBondAngles>(Sim, XML);
     else if (!Name.compare("Trajectory"))
       return testGeneratePlugin<OPTrajectory>(Sim, XML);
+    else if (!Name.compare("BinaryTrajectory"))
+      return testGeneratePlugin<OPBinaryTrajectory>(Sim, XML);
     else if (!Name.compare("ChainBondLength"))
       return testGeneratePlugin<OPChainBondLength>(Sim, XML);
     else if (!Name.compare("VelDist"))
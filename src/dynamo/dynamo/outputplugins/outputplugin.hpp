@@ -17,6 +17,7 @@
 
 #pragma once
 #include <dynamo/base.hpp>
+#include <dynamo/particle.hpp>
 
 namespace magnet { namespace xml { class Node; class XmlStream; } }
 
@@ -64,6 +65,13 @@ namespace dynamo {
     virtual void replicaExchange(OutputPlugin&) = 0;
   
     virtual void temperatureRescale(const double&) {}
+
+    /*! \brief Called after the particles of the Simulation have been
+        reordered, so any per-particle data can be permuted.
+
+	\sa Simulation::reorderParticles()
+     */
+    virtual void particlesReordered(const std::vector<size_t>&) {}
   
   protected:
     std::ostream& I_Pcout() const;
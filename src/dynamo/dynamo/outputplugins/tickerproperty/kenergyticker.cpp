@@ -46,15 +46,11 @@ namespace dynamo {
 
     matrix localE;
 
+    _arrays.gatherVelocities(Sim->particles);
+    _arrays.gatherMasses(*Sim);
     for (size_t iDim = 0; iDim < NDIM; ++iDim)
       for (size_t jDim = 0; jDim < NDIM; ++jDim)
-	localE[iDim][jDim] = 0.0;
-
-    for (const Particle& part : Sim->particles)
-      for (size_t iDim = 0; iDim < NDIM; ++iDim)
-	for (size_t jDim = 0; jDim < NDIM; ++jDim)
-	  localE[iDim][jDim] += part.getVelocity()[iDim] * part.getVelocity()[jDim]
-	    * Sim->species(part)->getMass(part.getID());
+	localE[iDim][jDim] = _arrays.kineticTensor(iDim, jDim);
 
     //Try and stop round off error this way
     for (size_t iDim = 0; iDim < NDIM; ++iDim)
@@ -20,6 +20,7 @@
 #include <dynamo/outputplugins/tickerproperty/ticker.hpp>
 #include <magnet/math/histogram.hpp>
 #include <magnet/math/vector.hpp>
+#include <dynamo/particleArrays.hpp>
 #include <array>
 
 namespace dynamo {
@@ -46,5 +47,6 @@ namespace dynamo {
   protected:
     size_t count;
     matrix sum;
+    ParticleArrays _arrays;
   };
 }
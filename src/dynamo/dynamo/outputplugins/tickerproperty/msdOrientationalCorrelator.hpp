@@ -34,6 +34,9 @@ namespace dynamo {
 
     virtual void operator<<(const magnet::xml::Node&);
 
+    virtual void particlesReordered(const std::vector<size_t>& order)
+    { reorderParticleData(historicalData, order); }
+
     typedef std::pair<Vector,Vector> RUpair;
 
   protected:
@@ -32,6 +32,9 @@ namespace dynamo {
     void output(magnet::xml::XmlStream &); 
 
     virtual void operator<<(const magnet::xml::Node&);
+
+    virtual void particlesReordered(const std::vector<size_t>& order)
+    { reorderParticleData(velHistory, order); }
   
   protected:
     virtual void stream(double) {}
@@ -52,10 +52,12 @@ namespace dynamo {
   OPTrajectory::printData(const size_t& p1,
 			  const size_t& p2) const
   {
-    size_t id1 = ((p1 < p2) 
+    //The pair is ordered and reported using the original IDs of the
+    //particles, in case the Simulation has reordered them
+    size_t id1 = ((Sim->getExternalID(p1) < Sim->getExternalID(p2)) 
 		  ? p1 : p2);
   
-    size_t id2 = ((p1 > p2) 
+    size_t id2 = ((Sim->getExternalID(p1) > Sim->getExternalID(p2)) 
 		  ? p1 : p2);
 
     Vector  rij = Sim->particles[id1].getPosition()
@@ -69,8 +71,8 @@ namespace dynamo {
     rij /= Sim->units.unitLength();
     vij /= Sim->units.unitVelocity();
 
-    logfile << " p1 " << std::setw(5) << id1
-	    << " p2 " << std::setw(5) << id2
+    logfile << " p1 " << std::setw(5) << Sim->getExternalID(id1)
+	    << " p2 " << std::setw(5) << Sim->getExternalID(id2)
 	    << " |r12| " << std::setw(5) << rij.nrm()
 	    << " post-r12 < ";
   
@@ -99,7 +101,7 @@ namespace dynamo {
     logfile << " deltaP1 < ";
     for (size_t iDim(0); iDim < NDIM; ++iDim)
       logfile << std::setw(7) 
-	      << ((eevent.getParticle1ID() < eevent.getParticle2ID())? -1 : 1) 
+	      << ((Sim->getExternalID(eevent.getParticle1ID()) < Sim->getExternalID(eevent.getParticle2ID()))? -1 : 1) 
 	* pdat.impulse[iDim] << " ";
 
     logfile << " >";
@@ -124,7 +126,7 @@ namespace dynamo {
     for (const ParticleEventData& pData : SDat.L1partChanges)
       {
 	const Particle& part = Sim->particles[pData.getParticleID()];
-	logfile << "    1PEvent p1 " << part.getID();
+	logfile << "    1PEvent p1 " << Sim->getExternalID(part.getID());
 	Vector delP = Sim->species[pData.getSpeciesID()]->getMass(part.getID()) * (part.getVelocity() - pData.getOldVel());
 	delP /= Sim->units.unitMomentum();
 	Vector pos = part.getPosition() / Sim->units.unitLength();
@@ -158,7 +160,7 @@ namespace dynamo {
     for (const ParticleEventData& pData : SDat.L1partChanges)
       {
 	const Particle& part = Sim->particles[pData.getParticleID()];
-	logfile << "    1PEvent p1 " << part.getID();
+	logfile << "    1PEvent p1 " << Sim->getExternalID(part.getID());
 	Vector delP = Sim->species[pData.getSpeciesID()]->getMass(part.getID()) * (part.getVelocity() - pData.getOldVel());
 	delP /= Sim->units.unitMomentum();
 	Vector pos = part.getPosition() / Sim->units.unitLength();
@@ -192,7 +194,7 @@ namespace dynamo {
     for (const ParticleEventData& pData : SDat.L1partChanges)
       {
 	const Particle& part = Sim->particles[pData.getParticleID()];
-	logfile << "    1PEvent p1 " << part.getID();
+	logfile << "    1PEvent p1 " << Sim->getExternalID(part.getID());
 	Vector delP = Sim->species[pData.getSpeciesID()]->getMass(part.getID()) * (part.getVelocity() - pData.getOldVel());
 	delP /= Sim->units.unitMomentum();
 	Vector pos = part.getPosition() / Sim->units.unitLength();	
@@ -18,6 +18,7 @@
 #pragma once
 
 #include <magnet/math/vector.hpp>
+#include <vector>
 
 namespace magnet { namespace xml { class Node; class XmlStream; } }
 
@@ -131,4 +132,24 @@ namespace dynamo {
     double _peculiarTime;
     int _state;
   };
+
+  /*! \brief Permutes per-particle data after the Particle's of the
+      Simulation have been reordered.
+
+      \param data The per-particle data, indexed by the particle ID.
+      \param order The previous ID of the particle which now has the
+      ID i is order[i].
+      \sa Simulation::reorderParticles()
+   */
+  template<class T>
+  inline void reorderParticleData(std::vector<T>& data, const std::vector<size_t>& order)
+  {
+    if (data.empty()) return;
+
+    std::vector<T> reordered;
+    reordered.reserve(order.size());
+    for (const size_t& oldID : order)
+      reordered.push_back(data[oldID]);
+    data.swap(reordered);
+  }
 }
@@ -0,0 +1,143 @@
+/*  dynamo:- Event driven molecular dynamics simulator 
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <dynamo/particleArrays.hpp>
+#include <dynamo/simulation.hpp>
+#include <dynamo/species/species.hpp>
+#include <cmath>
+
+namespace dynamo {
+  void
+  ParticleArrays::reserve(size_t N)
+  {
+    _size = N;
+    if (pecTime.size() >= N) return;
+
+    for (size_t iDim(0); iDim < NDIM; ++iDim)
+      {
+	pos[iDim].resize(N);
+	vel[iDim].resize(N);
+      }
+    pecTime.resize(N);
+    mass.resize(N);
+    species.resize(N);
+  }
+
+  void
+  ParticleArrays::gather(const std::vector<Particle>& particles, size_t begin, size_t end)
+  {
+    reserve(end - begin);
+    for (size_t i(0); i < _size; ++i)
+      {
+	const Particle& part = particles[begin + i];
+	for (size_t iDim(0); iDim < NDIM; ++iDim)
+	  {
+	    pos[iDim][i] = part.getPosition()[iDim];
+	    vel[iDim][i] = part.getVelocity()[iDim];
+	  }
+	pecTime[i] = part.getPecTime();
+      }
+  }
+
+  void
+  ParticleArrays::gatherVelocities(const std::vector<Particle>& particles)
+  {
+    reserve(particles.size());
+    for (size_t i(0); i < _size; ++i)
+      for (size_t iDim(0); iDim < NDIM; ++iDim)
+	vel[iDim][i] = particles[i].getVelocity()[iDim];
+  }
+
+  void
+  ParticleArrays::gatherMasses(const Simulation& sim)
+  {
+    reserve(sim.N());
+    for (size_t i(0); i < _size; ++i)
+      {
+	const Particle& part = sim.particles[i];
+	const Species& sp = *sim.species(part);
+	const double m = sp.getMass(part.getID());
+	mass[i] = std::isinf(m) ? 0 : m;
+	species[i] = sp.getID();
+      }
+  }
+
+  void
+  ParticleArrays::gatherSeparations(const std::vector<Particle>& particles, const Particle& p1, const size_t* ids, size_t N)
+  {
+    reserve(N);
+    for (size_t i(0); i < _size; ++i)
+      {
+	const Particle& part = particles[ids[i]];
+	for (size_t iDim(0); iDim < NDIM; ++iDim)
+	  {
+	    pos[iDim][i] = p1.getPosition()[iDim] - part.getPosition()[iDim];
+	    vel[iDim][i] = p1.getVelocity()[iDim] - part.getVelocity()[iDim];
+	  }
+      }
+  }
+
+  //These sums are split over four independent accumulators. This
+  //allows the compiler to vectorise the loop without having to
+  //reassociate the floating point additions.
+  double
+  ParticleArrays::kineticTensor(size_t a, size_t b) const
+  {
+    const double* const m = mass.data();
+    const double* const va = vel[a].data();
+    const double* const vb = vel[b].data();
+    double sum[4] = {0, 0, 0, 0};
+    size_t i(0);
+    for (; i + 4 <= _size; i += 4)
+      for (size_t j(0); j < 4; ++j)
+	sum[j] += m[i + j] * va[i + j] * vb[i + j];
+
+    for (; i < _size; ++i)
+      sum[0] += m[i] * va[i] * vb[i];
+
+    return (sum[0] + sum[1]) + (sum[2] + sum[3]);
+  }
+
+  double
+  ParticleArrays::momentum(size_t a) const
+  {
+    const double* const m = mass.data();
+    const double* const va = vel[a].data();
+    double sum[4] = {0, 0, 0, 0};
+    size_t i(0);
+    for (; i + 4 <= _size; i += 4)
+      for (size_t j(0); j < 4; ++j)
+	sum[j] += m[i + j] * va[i + j];
+
+    for (; i < _size; ++i)
+      sum[0] += m[i] * va[i];
+
+    return (sum[0] + sum[1]) + (sum[2] + sum[3]);
+  }
+
+  void
+  ParticleArrays::scatterPositions(std::vector<Particle>& particles, size_t begin) const
+  {
+    for (size_t i(0); i < _size; ++i)
+      {
+	Particle& part = particles[begin + i];
+	for (size_t iDim(0); iDim < NDIM; ++iDim)
+	  part.getPosition()[iDim] = pos[iDim][i];
+	part.getPecTime() = 0;
+      }
+  }
+}
@@ -0,0 +1,106 @@
+/*  dynamo:- Event driven molecular dynamics simulator 
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <dynamo/particle.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace dynamo {
+  class Simulation;
+
+  /*! \brief A structure-of-arrays copy of the particle data used by
+      bulk passes over all particles.
+
+      \ref Particle stores its data as an array of structures, which
+      is ideal for the event by event updates of the simulation, but
+      passes over every particle (e.g., streaming all particles or
+      summing the kinetic energy) must then stride over fields they
+      do not use. This class mirrors the positions, velocities,
+      peculiar times and masses into contiguous arrays, so these
+      passes can be vectorised by the compiler.
+
+      The arrays are a copy of the state in \ref Simulation::particles,
+      any changes must be written back with the scatter functions. The
+      arrays are only grown, never shrunk, so a single instance may be
+      reused to avoid allocations.
+   */
+  class ParticleArrays
+  {
+  public:
+    ParticleArrays(): _size(0) {}
+
+    //! \brief Copy the positions, velocities and peculiar times.
+    void gather(const std::vector<Particle>& particles, size_t begin, size_t end);
+
+    //! \brief Copy the positions, velocities and peculiar times.
+    void gather(const std::vector<Particle>& particles)
+    { gather(particles, 0, particles.size()); }
+
+    //! \brief Copy the velocities.
+    void gatherVelocities(const std::vector<Particle>& particles);
+
+    /*! \brief Copy the masses and Species indices of the particles.
+
+      Infinite masses are stored as zero, so that they do not
+      contribute to any sums.
+     */
+    void gatherMasses(const Simulation& sim);
+
+    /*! \brief Store the separations \f$\mathbf r_1 - \mathbf r_j\f$
+        and relative velocities \f$\mathbf v_1 - \mathbf v_j\f$ of
+        a particle and the \a N particles with IDs \a ids in the
+        position and velocity arrays.
+     */
+    void gatherSeparations(const std::vector<Particle>& particles, const Particle& p1, const size_t* ids, size_t N);
+
+    /*! \brief Write back the positions of a range of particles,
+        previously loaded with gather(), and zero their peculiar
+        times.
+     */
+    void scatterPositions(std::vector<Particle>& particles, size_t begin) const;
+
+    //! \brief The number of particles stored in the arrays.
+    size_t size() const { return _size; }
+
+    /*! \brief Returns \f$\sum_i m_i v_{i,a} v_{i,b}\f$, an element
+        of the kinetic tensor (requires the velocities and masses).
+     */
+    double kineticTensor(size_t a, size_t b) const;
+
+    /*! \brief Returns \f$\sum_i m_i v_{i,a}\f$, a component of the
+        total momentum (requires the velocities and masses).
+     */
+    double momentum(size_t a) const;
+
+    //! \brief The components of the particle positions.
+    std::vector<double> pos[NDIM];
+    //! \brief The components of the particle velocities.
+    std::vector<double> vel[NDIM];
+    //! \brief The peculiar times of the particles.
+    std::vector<double> pecTime;
+    //! \brief The masses of the particles.
+    std::vector<double> mass;
+    //! \brief The indices of the Species of the particles.
+    std::vector<uint32_t> species;
+
+  private:
+    void reserve(size_t N);
+
+    size_t _size;
+  };
+}
@@ -15,6 +15,7 @@
     along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 #pragma once
+#include <dynamo/particle.hpp>
 #include <magnet/exception.hpp>
 #include <magnet/xmlwriter.hpp>
 #include <magnet/xmlreader.hpp>
@@ -23,6 +24,8 @@
 #include <string>
 #include <algorithm>
 #include <cmath>
+#include <typeinfo>
+#include <functional>
 
 namespace dynamo {
   /*! \brief A interface class which allows other classes to access a property
@@ -88,6 +91,12 @@ namespace dynamo {
     inline virtual void outputParticleXMLData(magnet::xml::XmlStream& XML, 
 					      const size_t pID) const {}
 
+    /*! Permute any per-particle data after the particles have been
+      reordered.
+      \sa Simulation::reorderParticles()
+    */
+    inline virtual void particlesReordered(const std::vector<size_t>& order) {}
+
   protected:
     virtual void outputXML(magnet::xml::XmlStream& XML) const 
     { M_throw() << "Unimplemented"; }
@@ -156,16 +165,13 @@ namespace dynamo {
       Property(units), _name(name),
       _values(N, initalval) {}
   
+    /*! \brief Loads the description of the property, the values
+      are loaded afterwards by PropertyStore::loadParticleData.
+     */
     inline ParticleProperty(const magnet::xml::Node& node):
       Property(Property::Units(node.getAttribute("Units").getValue())),
       _name(node.getAttribute("Name").getValue())
-    {
-      //Move up to the particles nodes, and start loading the property values
-      for (magnet::xml::Node pNode = node.getParent().getParent()
-	     .getNode("ParticleData").fastGetNode("Pt");
-	   pNode.valid(); ++pNode)
-	_values.push_back(pNode.getAttribute(_name).as<double>());
-    }
+    {}
   
     inline virtual const double& getProperty(size_t ID) const 
     { 
@@ -206,6 +212,14 @@ namespace dynamo {
 
     inline void outputParticleXMLData(magnet::xml::XmlStream& XML, const size_t pID) const
     { XML << magnet::xml::attr(_name) << getProperty(pID); }
+
+    //! \brief Replace the values of the property for all particles.
+    inline void setValues(const double* begin, const double* end)
+    { _values.assign(begin, end); }
+
+    //! \sa Property::particlesReordered
+    inline virtual void particlesReordered(const std::vector<size_t>& order)
+    { reorderParticleData(_values, order); }
   
   
   protected:
@@ -227,6 +241,81 @@ namespace dynamo {
     Container _values;
   };
 
+  /*! \brief A handle to a Property which avoids virtual calls for
+      the common Property types.
+
+      Interactions read their parameters (e.g., diameters) for every
+      event they calculate. Through a Property pointer, a lookup for a
+      pair of particles costs three virtual calls, even if the
+      Property is a constant NumericProperty. This handle determines
+      the exact type of the Property when it is bound, so that values
+      of NumericProperty and ParticleProperty instances are read
+      through inlined, non-virtual accessors. Other types of Property
+      are still accessed through the virtual interface.
+
+      The handle dereferences to the Property for any other use.
+   */
+  class PropertyHandle
+  {
+  public:
+    inline PropertyHandle(): _type(GENERIC) {}
+
+    inline PropertyHandle(const shared_ptr<Property>& ptr) { *this = ptr; }
+
+    inline PropertyHandle& operator=(const shared_ptr<Property>& ptr)
+    {
+      _ptr = ptr;
+      _type = GENERIC;
+      if (_ptr && (typeid(*_ptr) == typeid(NumericProperty)))
+	_type = NUMERIC;
+      else if (_ptr && (typeid(*_ptr) == typeid(ParticleProperty)))
+	_type = PERPARTICLE;
+      return *this;
+    }
+
+    //! \sa Property::getProperty(size_t)
+    inline double getProperty(size_t ID) const
+    {
+      switch (_type)
+	{
+	case NUMERIC: 
+	  return static_cast<const NumericProperty&>(*_ptr).NumericProperty::getProperty(ID);
+	case PERPARTICLE: 
+	  return static_cast<const ParticleProperty&>(*_ptr).ParticleProperty::getProperty(ID);
+	default: 
+	  return _ptr->getProperty(ID);
+	}
+    }
+
+    //! \sa Property::getProperty(size_t, size_t)
+    inline double getProperty(size_t ID1, size_t ID2) const
+    {
+      switch (_type)
+	{
+	case NUMERIC: 
+	  return static_cast<const NumericProperty&>(*_ptr).NumericProperty::getProperty(ID1);
+	case PERPARTICLE: 
+	  {
+	    const ParticleProperty& prop = static_cast<const ParticleProperty&>(*_ptr);
+	    return (prop.ParticleProperty::getProperty(ID1) + prop.ParticleProperty::getProperty(ID2)) / 2;
+	  }
+	default: 
+	  return _ptr->getProperty(ID1, ID2);
+	}
+    }
+
+    //! \brief Returns true if the Property has the same value for all particles.
+    inline bool isUniform() const { return _type == NUMERIC; }
+
+    inline Property* operator->() const { return _ptr.get(); }
+    inline Property& operator*() const { return *_ptr; }
+    inline explicit operator bool() const { return bool(_ptr); }
+
+  private:
+    shared_ptr<Property> _ptr;
+    enum { GENERIC, NUMERIC, PERPARTICLE } _type;
+  };
+
   /*! \brief This class stores the properties of the particles loaded from the
     configuration file and hands out reference counting pointers to the
     properties to other classes when they're requested by name.
@@ -351,6 +440,59 @@ namespace dynamo {
 	property->outputParticleXMLData(XML, pID);
     }
 
+    /*! \brief Copy the values of the per-particle Property-s.
+
+      The values are stored in the order of the passed particle IDs,
+      for writing out later (see Dynamics::ParticleSnapshot).
+    */
+    inline std::vector<std::pair<std::string, std::vector<double> > > 
+    getParticleDataSnapshot(const std::vector<size_t>& IDs) const 
+    {
+      std::vector<std::pair<std::string, std::vector<double> > > snapshot;
+      for (const auto& property : _namedProperties)
+	if (dynamic_cast<const ParticleProperty*>(property.get()))
+	  {
+	    snapshot.push_back(std::make_pair(property->getName(), std::vector<double>()));
+	    snapshot.back().second.reserve(IDs.size());
+	    for (const size_t ID : IDs)
+	      snapshot.back().second.push_back(property->getProperty(ID));
+	  }
+      return snapshot;
+    }
+
+    /*! \brief Load the values of the per-particle Property-s from
+      arrays, as read from a configuration file (see
+      BinaryConfigReader and StreamingConfigReader).
+
+      \param source Returns the array of values for the named
+      Property, or NULL if it is not available.
+      \param N The number of particles.
+    */
+    inline void loadParticleData(const std::function<const double*(const std::string&)>& source, const size_t N)
+    {
+      for (auto& property : _namedProperties)
+	{
+	  ParticleProperty* ptr = dynamic_cast<ParticleProperty*>(property.get());
+	  if (!ptr) continue;
+
+	  const double* values = source(ptr->getName());
+	  if (!values)
+	    M_throw() << "Could not find the values of the particle property \"" << ptr->getName() << "\"";
+	  ptr->setValues(values, values + N);
+	}
+    }
+
+    /*! \brief Permute the per-particle Property data after the
+      particles have been reordered.
+      
+      \sa Simulation::reorderParticles()
+    */
+    inline void particlesReordered(const std::vector<size_t>& order)
+    {
+      for (auto& property : _namedProperties)
+	property->particlesReordered(order);
+    }
+
     /*! \brief Method for pushing constructed properties into the
       PropertyStore.
      
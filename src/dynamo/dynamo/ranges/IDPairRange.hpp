@@ -17,12 +17,15 @@
 
 #pragma once
 #include <memory>
+#include <utility>
+#include <vector>
 
 namespace magnet { namespace xml { class Node; class XmlStream; } }
 namespace dynamo { 
   using std::shared_ptr;
   class Simulation;
   class Particle;
+  class IDRange;
 
   class IDPairRange
   {
@@ -37,6 +40,32 @@ namespace dynamo {
       other particle. */
     virtual bool isInRange(const Particle&) const = 0;
 
+    /*! \brief Collects the IDRanges which this range is built from.
+
+      If membership of a pair of distinct particles in this range is
+      entirely determined by the membership of each particle in a set
+      of IDRanges, those IDRanges are appended to the passed container
+      and true is returned. This allows the range to be tabulated by
+      particle class (see Simulation::getInteraction).
+
+      Ranges which depend on the particle IDs directly (e.g., chains
+      or lists of pairs) return false.
+     */
+    virtual bool getIDRanges(std::vector<const IDRange*>&) const { return false; }
+
+    /*! \brief Collects the pairs of particle IDs in this range.
+
+      If the range is built from an explicit set of pairs (e.g., the
+      bonds of chains or a list of pairs), each pair is appended to
+      the passed container (lowest ID first) and true is returned.
+      This allows the pairs to be visited without testing every pair
+      of particles.
+
+      Ranges defined by IDRanges may contain O(N^2) pairs and return
+      false.
+     */
+    virtual bool getPairs(std::vector<std::pair<size_t, size_t> >&) const { return false; }
+
     static IDPairRange* getClass(const magnet::xml::Node&, const dynamo::Simulation*);
     
     friend magnet::xml::XmlStream& operator<<(magnet::xml::XmlStream& XML, const IDPairRange& range);
@@ -72,6 +72,14 @@ namespace dynamo {
 	    || !((p1.getID() - rangeStart + 1) % interval)); //Or the end?
     }
 
+    virtual bool getPairs(std::vector<std::pair<size_t, size_t> >& pairs) const
+    {
+      if (interval > 1)
+	for (size_t start(rangeStart); start <= rangeEnd; start += interval)
+	  pairs.push_back(std::make_pair(start, start + interval - 1));
+      return true;
+    }
+
   protected:
     virtual void outputXML(magnet::xml::XmlStream& XML) const
     {
@@ -62,6 +62,15 @@ namespace dynamo {
     virtual bool isInRange(const Particle&p1) const
     { return (p1.getID() >= range1) && (p1.getID() <= range2); }
 
+    virtual bool getPairs(std::vector<std::pair<size_t, size_t> >& pairs) const
+    {
+      for (size_t start(range1); start <= range2; start += interval)
+	for (size_t ID1(start); ID1 < start + interval; ++ID1)
+	  for (size_t ID2(ID1 + 1); ID2 < start + interval; ++ID2)
+	    pairs.push_back(std::make_pair(ID1, ID2));
+      return true;
+    }
+
   protected:
     virtual void outputXML(magnet::xml::XmlStream& XML) const
     {
@@ -50,6 +50,12 @@ namespace dynamo {
       return false;
     }
 
+    virtual bool getPairs(std::vector<std::pair<size_t, size_t> >& pairs) const
+    {
+      pairs.insert(pairs.end(), pairmap.begin(), pairmap.end());
+      return true;
+    }
+
     void addPair(unsigned long a, unsigned long b)
     { pairmap.insert(Key(std::min(a,b), std::max(a,b))); }
 
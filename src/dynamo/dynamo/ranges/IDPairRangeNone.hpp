@@ -28,6 +28,7 @@ namespace dynamo {
     
     virtual bool isInRange(const Particle&, const Particle&) const { return false; }
     virtual bool isInRange(const Particle&) const { return false; }
+    virtual bool getIDRanges(std::vector<const IDRange*>&) const { return true; }
   
   protected:
     virtual void outputXML(magnet::xml::XmlStream& XML) const
@@ -39,6 +39,13 @@ namespace dynamo {
     virtual bool isInRange(const Particle&p1) const
     { return range1->isInRange(p1) || range2->isInRange(p1); }
 
+    virtual bool getIDRanges(std::vector<const IDRange*>& ranges) const
+    {
+      ranges.push_back(range1.get());
+      ranges.push_back(range2.get());
+      return true;
+    }
+
   protected:
 
     virtual void outputXML(magnet::xml::XmlStream& XML) const
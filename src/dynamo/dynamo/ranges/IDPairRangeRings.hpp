@@ -80,6 +80,20 @@ namespace dynamo {
     virtual bool isInRange(const Particle&p1) const
     { return (p1.getID() >= range1) && (p1.getID() <= range2); }
 
+    virtual bool getPairs(std::vector<std::pair<size_t, size_t> >& pairs) const
+    {
+      for (size_t start(range1); start <= range2; start += interval)
+	{
+	  for (size_t ID(start); ID + 1 < start + interval; ++ID)
+	    pairs.push_back(std::make_pair(ID, ID + 1));
+
+	  //Close the ring (if it is not already closed by the chain)
+	  if (interval > 2)
+	    pairs.push_back(std::make_pair(start, start + interval - 1));
+	}
+      return true;
+    }
+
   protected:
     virtual void outputXML(magnet::xml::XmlStream& XML) const
     {
@@ -36,6 +36,12 @@ namespace dynamo {
     virtual bool isInRange(const Particle&p1) const
     { return range->isInRange(p1); }
 
+    virtual bool getIDRanges(std::vector<const IDRange*>& ranges) const
+    {
+      ranges.push_back(range.get());
+      return true;
+    }
+
     const shared_ptr<IDRange>& getRange() const { return range; }
 
   protected:
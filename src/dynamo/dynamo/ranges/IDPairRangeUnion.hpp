@@ -22,6 +22,7 @@
 #include <magnet/xmlwriter.hpp>
 #include <magnet/xmlreader.hpp>
 #include <list>
+#include <algorithm>
 
 namespace dynamo {
   class IDPairRangeUnion:public IDPairRange, dynamo::SimBase_const
@@ -54,6 +55,29 @@ namespace dynamo {
       return false;
     }
 
+    virtual bool getIDRanges(std::vector<const IDRange*>& idranges) const
+    {
+      for (const shared_ptr<IDPairRange>& rPtr : ranges)
+	if (!rPtr->getIDRanges(idranges)) return false;
+      return true;
+    }
+
+    virtual bool getPairs(std::vector<std::pair<size_t, size_t> >& pairs) const
+    {
+      const size_t start = pairs.size();
+      for (const shared_ptr<IDPairRange>& rPtr : ranges)
+	if (!rPtr->getPairs(pairs))
+	  {
+	    pairs.resize(start);
+	    return false;
+	  }
+
+      //The member ranges may overlap
+      std::sort(pairs.begin() + start, pairs.end());
+      pairs.erase(std::unique(pairs.begin() + start, pairs.end()), pairs.end());
+      return true;
+    }
+
     void addRange(IDPairRange* nRange)
     { ranges.push_back(shared_ptr<IDPairRange>(nRange)); }
   
@@ -0,0 +1,191 @@
+/*  dynamo:- Event driven molecular dynamics simulator 
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <dynamo/eventtypes.hpp>
+#include <magnet/xmlwriter.hpp>
+#include <chrono>
+#include <array>
+#include <ostream>
+#include <sstream>
+
+namespace dynamo {
+  /*! \brief Performance counters for the event loop of the \ref
+      Scheduler.
+
+      These count the events dispatched by type, the event rejections
+      and the size of the neighbourhoods used in event prediction, and
+      time the event loop, the event prediction and the output plugin
+      callbacks. Timing costs a few clock reads per event, so the
+      counters may be compiled out by defining
+      DYNAMO_NO_SCHEDULER_COUNTERS (the dynamo-counters=off build
+      feature), in which case every call here is a no-op.
+
+      Only work done inside the event loop is timed. Predictions made
+      outside of it (e.g., the initial build of the event list) are
+      not counted, so the prediction, execution and plugin times
+      always add up to the event loop time.
+   */
+  class SchedulerCounters
+  {
+  public:
+    enum Timer
+      {
+	EVENTLOOP, //!< The complete runNextEvent call.
+	PREDICTION, //!< Predicting the events of particles.
+	PLUGINS, //!< Output plugin callbacks for interaction events.
+	TIMER_COUNT
+      };
+
+#ifndef DYNAMO_NO_SCHEDULER_COUNTERS
+    static const bool enabled = true;
+
+    SchedulerCounters() { reset(); }
+
+    void reset()
+    {
+      _eventsByType.fill(0);
+      _times.fill(0);
+      _interactionRejections = 0;
+      _localRejections = 0;
+      _predictions = 0;
+      _neighbours = 0;
+      _inEventLoop = false;
+    }
+
+    inline void countEvent(EEventType type) { ++_eventsByType[type]; }
+    inline void countInteractionRejection() { ++_interactionRejections; }
+    inline void countLocalRejection() { ++_localRejections; }
+    inline void countPredictions(size_t predictions, size_t neighbours)
+    { _predictions += predictions; _neighbours += neighbours; }
+
+    /*! \brief Adds the time spent in its scope to one of the timers.
+
+      The PREDICTION and PLUGINS timers only count while an EVENTLOOP
+      timer is running.
+     */
+    class ScopedTimer
+    {
+    public:
+      inline ScopedTimer(SchedulerCounters& counters, Timer timer):
+	_counters(counters), _timer(timer), 
+	_active((timer == EVENTLOOP) || counters._inEventLoop)
+      {
+	if (!_active) return;
+	if (timer == EVENTLOOP) _counters._inEventLoop = true;
+	_start = std::chrono::steady_clock::now();
+      }
+
+      inline ~ScopedTimer()
+      { 
+	if (!_active) return;
+	_counters._times[_timer] += std::chrono::duration<double>(std::chrono::steady_clock::now() - _start).count(); 
+	if (_timer == EVENTLOOP) _counters._inEventLoop = false;
+      }
+
+    private:
+      SchedulerCounters& _counters;
+      Timer _timer;
+      bool _active;
+      std::chrono::steady_clock::time_point _start;
+    };
+
+    size_t getEventCount(EEventType type) const { return _eventsByType[type]; }
+    size_t getInteractionRejections() const { return _interactionRejections; }
+    size_t getLocalRejections() const { return _localRejections; }
+    double getMeanNeighbours() const { return _predictions ? double(_neighbours) / _predictions : 0; }
+    double getTime(Timer timer) const { return _times[timer]; }
+
+    /*! \brief The time in the event loop not spent predicting events
+        or in the plugin callbacks, this is mostly the execution of
+        the events.
+     */
+    double getExecutionTime() const 
+    { return _times[EVENTLOOP] - _times[PREDICTION] - _times[PLUGINS]; }
+
+    void outputXML(magnet::xml::XmlStream& XML, size_t lazyDeletionPops) const
+    {
+      using namespace magnet::xml;
+      XML << tag("SchedulerCounters");
+
+      for (size_t type(0); type < _eventsByType.size(); ++type)
+	if (_eventsByType[type])
+	  XML << tag("Events")
+	      << attr("Type") << EEventType(type)
+	      << attr("Count") << _eventsByType[type]
+	      << endtag("Events");
+
+      XML << tag("Rejections")
+	  << attr("Interaction") << _interactionRejections
+	  << attr("Local") << _localRejections
+	  << attr("LazyDeletionPops") << lazyDeletionPops
+	  << endtag("Rejections")
+	  << tag("Prediction")
+	  << attr("Count") << _predictions
+	  << attr("MeanNeighbours") << getMeanNeighbours()
+	  << endtag("Prediction")
+	  << tag("TimingSeconds")
+	  << attr("EventLoop") << _times[EVENTLOOP]
+	  << attr("Prediction") << _times[PREDICTION]
+	  << attr("Execution") << getExecutionTime()
+	  << attr("Plugins") << _times[PLUGINS]
+	  << endtag("TimingSeconds")
+	  << endtag("SchedulerCounters");
+    }
+
+    //! \brief A short summary of the counters for the periodic output.
+    std::string periodicOutput() const
+    {
+      std::ostringstream os;
+      const double total = _times[EVENTLOOP];
+      os << "<NB> " << getMeanNeighbours();
+      if (total > 0)
+	os << ", Pred/Exec/Plug% " 
+	   << int(100 * _times[PREDICTION] / total + 0.5) << "/"
+	   << int(100 * getExecutionTime() / total + 0.5) << "/"
+	   << int(100 * _times[PLUGINS] / total + 0.5);
+      return os.str();
+    }
+
+  private:
+    std::array<size_t, FINAL_ENUM_TO_CATCH_THE_COMMA> _eventsByType;
+    std::array<double, TIMER_COUNT> _times;
+    size_t _interactionRejections;
+    size_t _localRejections;
+    size_t _predictions;
+    size_t _neighbours;
+    bool _inEventLoop;
+#else
+    static const bool enabled = false;
+
+    void reset() {}
+    inline void countEvent(EEventType) {}
+    inline void countInteractionRejection() {}
+    inline void countLocalRejection() {}
+    inline void countPredictions(size_t, size_t) {}
+
+    class ScopedTimer
+    {
+    public:
+      inline ScopedTimer(SchedulerCounters&, Timer) {}
+    };
+
+    void outputXML(magnet::xml::XmlStream&, size_t) const {}
+    std::string periodicOutput() const { return ""; }
+#endif
+  };
+}
@@ -62,4 +62,18 @@ namespace dynamo {
   {
     return std::unique_ptr<IDRange>(new IDRangeRange(0, Sim->locals.size() - 1));
   }
+
+  void
+  SDumb::getParticleNeighbours(const Particle&, std::vector<size_t>& retlist) const
+  {
+    for (size_t id(0); id < Sim->N(); ++id)
+      retlist.push_back(id);
+  }
+
+  void
+  SDumb::getParticleLocals(const Particle&, std::vector<size_t>& retlist) const
+  {
+    for (size_t id(0); id < Sim->locals.size(); ++id)
+      retlist.push_back(id);
+  }
 }
@@ -108,6 +108,14 @@ namespace dynamo {
 
   std::unique_ptr<IDRange>
   SNeighbourList::getParticleNeighbours(const Particle& part) const
+  {
+    IDRangeList* range_ptr = new IDRangeList();
+    getParticleNeighbours(part, range_ptr->getContainer());
+    return std::unique_ptr<IDRange>(range_ptr);
+  }
+
+  void
+  SNeighbourList::getParticleNeighbours(const Particle& part, std::vector<size_t>& retlist) const
   {
 #ifdef DYNAMO_DEBUG
     if (!std::dynamic_pointer_cast<GNeighbourList>(Sim->globals[NBListID]))
@@ -119,9 +127,7 @@ namespace dynamo {
 				 (Sim->globals[NBListID]
 				  .get()));
   
-    IDRangeList* range_ptr = new IDRangeList();
-    nblist.getParticleNeighbours(part, range_ptr->getContainer());
-    return std::unique_ptr<IDRange>(range_ptr);
+    nblist.getParticleNeighbours(part, retlist);
   }
 
   std::unique_ptr<IDRange>
@@ -146,4 +152,11 @@ namespace dynamo {
   SNeighbourList::getParticleLocals(const Particle& part) const {
     return std::unique_ptr<IDRange>(new IDRangeRange(0, Sim->locals.size() - 1));
   }
+
+  void
+  SNeighbourList::getParticleLocals(const Particle&, std::vector<size_t>& retlist) const
+  {
+    for (size_t id(0); id < Sim->locals.size(); ++id)
+      retlist.push_back(id);
+  }
 }
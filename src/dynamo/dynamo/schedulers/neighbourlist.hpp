@@ -31,6 +31,8 @@ namespace dynamo {
     virtual std::unique_ptr<IDRange> getParticleNeighbours(const Particle&) const;
     virtual std::unique_ptr<IDRange> getParticleNeighbours(const Vector&) const;
     virtual std::unique_ptr<IDRange> getParticleLocals(const Particle&) const;
+    virtual void getParticleNeighbours(const Particle&, std::vector<size_t>&) const;
+    virtual void getParticleLocals(const Particle&, std::vector<size_t>&) const;
 
   protected:
     virtual void outputXML(magnet::xml::XmlStream&) const;
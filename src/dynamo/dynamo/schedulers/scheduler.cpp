@@ -23,6 +23,7 @@
 #include <dynamo/locals/local.hpp>
 #include <dynamo/systems/system.hpp>
 #include <dynamo/dynamics/dynamics.hpp>
+#include <dynamo/BC/BC.hpp>
 #include <dynamo/outputplugins/outputplugin.hpp>
 #include <dynamo/simulation.hpp>
 #include <dynamo/units/units.hpp>
@@ -31,6 +32,7 @@
 #include <dynamo/globals/neighbourList.hpp>
 #include <dynamo/NparticleEventData.hpp>
 #endif
+#include <magnet/thread/threadpool.hpp>
 #include <magnet/xmlwriter.hpp>
 #include <magnet/xmlreader.hpp>
 
@@ -39,6 +41,8 @@ namespace dynamo {
 			 FEL* nS):
     SimBase(tmp, aName),
     sorter(nS),
+    _eagerInvalidation(false),
+    _eventsSinceSample(0),
     _interactionRejectionCounter(0),
     _localRejectionCounter(0)
   {}
@@ -49,6 +53,17 @@ namespace dynamo {
   Scheduler::operator<<(const magnet::xml::Node& XML)
   {
     sorter = FEL::getClass(XML.getNode("Sorter"));
+
+    if (XML.hasAttribute("Invalidation"))
+      {
+	const std::string mode = XML.getAttribute("Invalidation");
+	if (mode == "Eager")
+	  _eagerInvalidation = true;
+	else if (mode == "Lazy")
+	  _eagerInvalidation = false;
+	else
+	  M_throw() << "Unknown event Invalidation mode \"" << mode << "\", should be \"Lazy\" or \"Eager\"";
+      }
   }
 
   void
@@ -61,15 +76,7 @@ namespace dynamo {
     for (const auto& interaction_ptr : Sim->interactions)
       warnings += interaction_ptr->validateState(warnings < 101, 101 - warnings);
     
-    for (size_t id1(0); id1 < Sim->particles.size(); ++id1)
-      {
-	std::unique_ptr<IDRange> ids(getParticleNeighbours(Sim->particles[id1]));
-	for (const size_t id2 : *ids)
-	  if (id2 > id1)
-	    if (Sim->getInteraction(Sim->particles[id1], Sim->particles[id2])
-		->validateState(Sim->particles[id1], Sim->particles[id2], (warnings < 101)))
-	      ++warnings;
-      }
+    warnings += Sim->validatePairStates((warnings < 101) ? 101 - warnings : 0);
     
     for(const Particle& part : Sim->particles)
       for (const shared_ptr<Local>& lcl : Sim->locals)
@@ -80,8 +87,18 @@ namespace dynamo {
     if (warnings > 100)
       derr << "Over 100 warnings of invalid states, further output was suppressed (total of " << warnings << " warnings detected)" << std::endl;
 
+    if (_eagerInvalidation)
+      dout << "Using eager event invalidation" << std::endl;
+
+    _invalidationCounters = InvalidationCounters();
+    _eventsSinceSample = 0;
+
     dout << "Building all events on collision " << Sim->eventCount << std::endl;
     rebuildList();
+
+    //The counters only cover the event loop, so they are reset after
+    //the initial build of the event list
+    _counters.reset();
   }
 
   void
@@ -92,36 +109,149 @@ namespace dynamo {
     sorter->resize(Sim->N()+1);
     eventCount.clear();
     eventCount.resize(Sim->N()+1, 0);
-
-    for (Particle& part : Sim->particles)
-      addEvents(part);
+    _eventHandles.clear();
+    if (_eagerInvalidation)
+      _eventHandles.resize(Sim->N());
+
+    if (Sim->threadPool && Sim->threadPool->getThreadCount() && concurrentPrediction())
+      addAllEventsParallel();
+    else
+      for (Particle& part : Sim->particles)
+	addEvents(part);
   
     sorter->init();
 
     rebuildSystemEvents();
   }
 
+  bool
+  Scheduler::concurrentPrediction() const
+  {
+    if (!Sim->dynamics->concurrentEvents() || !Sim->BCs->concurrentEvents())
+      return false;
+
+    for (const shared_ptr<Interaction>& ptr : Sim->interactions)
+      if (!ptr->concurrentEvents()) return false;
+
+    for (const shared_ptr<Local>& ptr : Sim->locals)
+      if (!ptr->concurrentEvents()) return false;
+
+    for (const shared_ptr<Global>& ptr : Sim->globals)
+      if (!ptr->concurrentEvents()) return false;
+
+    return true;
+  }
+
+  void
+  Scheduler::addAllEventsParallel()
+  {
+    //Bring every particle up to date first, the event prediction
+    //then only reads the particle data.
+    Sim->dynamics->updateAllParticles();
+
+    //Several blocks per thread are used to balance the load
+    const size_t blocks = std::min(Sim->N(), 4 * Sim->threadPool->getThreadCount());
+    if (!blocks) return;
+    const size_t blockSize = (Sim->N() + blocks - 1) / blocks;
+
+    SchedulerCounters::ScopedTimer timer(_counters, SchedulerCounters::PREDICTION);
+    std::vector<PredictionBuffers> buffers(blocks);
+    std::vector<std::vector<size_t> > eventEnds(blocks);
+    for (size_t block(0); block < blocks; ++block)
+      Sim->threadPool->queueTask(std::function<void()>([=, &buffers, &eventEnds]()
+	{
+	  const size_t end = std::min(Sim->N(), (block + 1) * blockSize);
+	  for (size_t ID(block * blockSize); ID < end; ++ID)
+	    {
+	      predictEvents(Sim->particles[ID], buffers[block]);
+	      ++buffers[block].predictions;
+	      buffers[block].neighbourTotal += buffers[block].neighbours.size();
+	      eventEnds[block].push_back(buffers[block].events.size());
+	    }
+	}));
+
+    Sim->threadPool->wait();
+
+    for (const PredictionBuffers& buffer : buffers)
+      _counters.countPredictions(buffer.predictions, buffer.neighbourTotal);
+
+    for (size_t block(0); block < blocks; ++block)
+      {
+	size_t ID = block * blockSize;
+	size_t eventID = 0;
+	for (const size_t eventEnd : eventEnds[block])
+	  {
+	    for (; eventID < eventEnd; ++eventID)
+	      pushParticleEvent(buffers[block].events[eventID], ID);
+	    ++ID;
+	  }
+      }
+  }
 
   void 
   Scheduler::addEvents(Particle& part)
   {  
-    Sim->dynamics->updateParticle(part);
+    SchedulerCounters::ScopedTimer timer(_counters, SchedulerCounters::PREDICTION);
+    _buffers.events.clear();
+    predictEvents(part, _buffers);
+    _counters.countPredictions(1, _buffers.neighbours.size());
+
+    for (const Event& event : _buffers.events)
+      pushParticleEvent(event, part.getID());
+  }
+
+  void 
+  Scheduler::predictEvents(Particle& part, PredictionBuffers& buffers) const
+  {
+    //Particles are only updated if required, so that no particle
+    //data is written when everything is already up to date.
+    if (!Sim->dynamics->isUpToDate(part))
+      Sim->dynamics->updateParticle(part);
 
     //Add the global events
     for (const shared_ptr<Global>& glob : Sim->globals)
       if (glob->isInteraction(part))
-	sorter->push(glob->getEvent(part), part.getID());
+	buffers.events.push_back(Event(glob->getEvent(part)));
   
     //Add the local cell events
-    std::unique_ptr<IDRange> ids(getParticleLocals(part));
-    
-    for (const size_t id2 : *ids)
-      addLocalEvent(part, id2);
+    buffers.locals.clear();
+    getParticleLocals(part, buffers.locals);
+    for (const size_t id2 : buffers.locals)
+      if (Sim->locals[id2]->isInteraction(part))
+	buffers.events.push_back(Event(Sim->locals[id2]->getEvent(part)));
+
+    //Now add the interaction events, sorting the neighbours by the
+    //Interaction they use so that each Interaction can calculate its
+    //events as a batch.
+    buffers.neighbours.clear();
+    getParticleNeighbours(part, buffers.neighbours);
+
+    for (auto& batch : buffers.interactionBatches)
+      batch.second.clear();
+
+    for (const size_t id2 : buffers.neighbours)
+      {
+	if (id2 == part.getID()) continue;
+	Particle& part2(Sim->particles[id2]);
+	if (!Sim->dynamics->isUpToDate(part2))
+	  Sim->dynamics->updateParticle(part2);
+
+	const Interaction* const interaction = Sim->getInteraction(part, part2).get();
+	auto it = buffers.interactionBatches.begin();
+	while ((it != buffers.interactionBatches.end()) && (it->first != interaction)) ++it;
+	if (it == buffers.interactionBatches.end())
+	  it = buffers.interactionBatches.insert(it, std::make_pair(interaction, std::vector<size_t>()));
+	it->second.push_back(id2);
+      }
 
-    //Now add the interaction events
-    ids = getParticleNeighbours(part);
-    for (const size_t id2 : *ids)
-      addInteractionEvent(part, id2);
+    for (const auto& batch : buffers.interactionBatches)
+      {
+	if (batch.second.empty()) continue;
+	buffers.intEvents.clear();
+	batch.first->getEvents(part, batch.second, buffers.intEvents);
+	for (const IntEvent& event : buffers.intEvents)
+	  buffers.events.push_back(Event(event, eventCount[event.getParticle2ID()]));
+      }
   }
 
   shared_ptr<Scheduler>
@@ -141,6 +271,8 @@ namespace dynamo {
   magnet::xml::XmlStream& operator<<(magnet::xml::XmlStream& XML, 
 				     const Scheduler& g)
   {
+    if (g._eagerInvalidation)
+      XML << magnet::xml::attr("Invalidation") << "Eager";
     g.outputXML(XML);
     return XML;
   }
@@ -162,7 +294,7 @@ namespace dynamo {
   Scheduler::pushEvent(const Particle& part,
 		       const Event& newevent)
   {
-    sorter->push(newevent, part.getID());
+    pushParticleEvent(newevent, part.getID());
   }
 
   void 
@@ -177,11 +309,94 @@ namespace dynamo {
     //Invalidate previous entries
     ++eventCount[part.getID()];
     sorter->clearPEL(part.getID());
+
+    if (!_eagerInvalidation || (part.getID() >= _eventHandles.size())) return;
+
+    //Remove the events with this particle from the PELs of its
+    //partners. Handles to PELs cleared since the event was pushed
+    //are skipped.
+    std::vector<std::pair<size_t, size_t> >& handles = _eventHandles[part.getID()];
+    for (const std::pair<size_t, size_t>& handle : handles)
+      if (handle.second == eventCount[handle.first])
+	{
+	  const size_t removed = sorter->removeInteractionEvents(handle.first, part.getID());
+	  if (removed)
+	    {
+	      _invalidationCounters.eagerRemovals += removed;
+	      sorter->update(handle.first);
+	    }
+	}
+    handles.clear();
+  }
+
+  void
+  Scheduler::addEventHandle(const size_t partnerID, const size_t ID) const
+  {
+    std::vector<std::pair<size_t, size_t> >& handles = _eventHandles[partnerID];
+
+    if (handles.size() == handles.capacity())
+      handles.erase(std::remove_if(handles.begin(), handles.end(), 
+				   [&](const std::pair<size_t, size_t>& handle)
+				   { return handle.second != eventCount[handle.first]; }), 
+		    handles.end());
+
+    handles.push_back(std::make_pair(ID, eventCount[ID]));
+  }
+
+  void
+  Scheduler::sampleQueueOccupancy()
+  {
+    const size_t occupancy = sorter->size();
+    size_t memory = occupancy * sizeof(Event);
+    for (const std::vector<std::pair<size_t, size_t> >& handles : _eventHandles)
+      memory += handles.capacity() * sizeof(std::pair<size_t, size_t>);
+
+    ++_invalidationCounters.occupancySamples;
+    _invalidationCounters.occupancySum += occupancy;
+    _invalidationCounters.peakOccupancy = std::max(_invalidationCounters.peakOccupancy, occupancy);
+    _invalidationCounters.peakMemory = std::max(_invalidationCounters.peakMemory, memory);
+  }
+
+  void
+  Scheduler::outputCounters(magnet::xml::XmlStream& XML) const
+  {
+    using namespace magnet::xml;
+    const InvalidationCounters& c = _invalidationCounters;
+    const double meanOccupancy = c.occupancySamples ? c.occupancySum / c.occupancySamples : 0;
+
+    dout << "Event invalidation (" << (_eagerInvalidation ? "Eager" : "Lazy") << ")"
+	 << "\nStale events popped " << c.stalePops
+	 << "\nEvents removed in place " << c.eagerRemovals
+	 << "\nMean queue occupancy " << meanOccupancy
+	 << "\nPeak queue occupancy " << c.peakOccupancy
+	 << "\nPeak event memory " << c.peakMemory / 1024 << "KiB"
+	 << std::endl;
+
+    XML << tag("EventInvalidation")
+	<< attr("Mode") << (_eagerInvalidation ? "Eager" : "Lazy")
+	<< attr("StalePops") << c.stalePops
+	<< attr("EagerRemovals") << c.eagerRemovals
+	<< attr("MeanQueueOccupancy") << meanOccupancy
+	<< attr("PeakQueueOccupancy") << c.peakOccupancy
+	<< attr("PeakEventMemoryBytes") << c.peakMemory
+	<< endtag("EventInvalidation");
+
+    _counters.outputXML(XML, c.stalePops);
   }
 
   void
   Scheduler::runNextEvent()
   {
+    SchedulerCounters::ScopedTimer timer(_counters, SchedulerCounters::EVENTLOOP);
+
+    //Sample the queue occupancy every N events, so the O(N) count
+    //is amortised to O(1) per event
+    if (++_eventsSinceSample > Sim->N())
+      {
+	_eventsSinceSample = 0;
+	sampleQueueOccupancy();
+      }
+
     sorter->sort();
 
 #ifdef DYNAMO_DEBUG
@@ -232,6 +447,8 @@ namespace dynamo {
     */
     const size_t rejectionLimit = 10;
 
+    _counters.countEvent(next_event.second.type);
+
     switch (next_event.second.type)
       {
       case INTERACTION:
@@ -277,6 +494,7 @@ namespace dynamo {
 	  //differences in event times.
 	  if ((Event.getType() == NONE) || ((Event.getdt() > next_event.second.dt) && (++_interactionRejectionCounter < rejectionLimit)))
 	    {
+	      _counters.countInteractionRejection();
 	      this->fullUpdate(p1, p2);
 	      return;
 	    }
@@ -314,8 +532,11 @@ namespace dynamo {
 	  PairEventData eventdata = Sim->interactions[Event.getInteractionID()]->runEvent(p1, p2, Event);
 	  Sim->_sigParticleUpdate(eventdata);
 	  Sim->ptrScheduler->fullUpdate(p1, p2);
-	  for (shared_ptr<OutputPlugin> & Ptr : Sim->outputPlugins)
-	    Ptr->eventUpdate(Event, eventdata);
+	  {
+	    SchedulerCounters::ScopedTimer timer(_counters, SchedulerCounters::PLUGINS);
+	    for (shared_ptr<OutputPlugin> & Ptr : Sim->outputPlugins)
+	      Ptr->eventUpdate(Event, eventdata);
+	  }
 	  break;
 	}
       case GLOBAL:
@@ -362,6 +583,7 @@ namespace dynamo {
 	  //the next event in the queue
 	  if ((iEvent.getType() == NONE) || ((iEvent.getdt() > next_event.second.dt) && (++_localRejectionCounter < rejectionLimit)))
 	    {
+	      _counters.countLocalRejection();
 	      this->fullUpdate(part);
 	      return;
 	    }
@@ -436,7 +658,7 @@ namespace dynamo {
     const IntEvent& eevent(Sim->getEvent(part1, part2));
 
     if (eevent.getType() != NONE)
-      sorter->push(Event(eevent, eventCount[id]), part1.getID());
+      pushParticleEvent(Event(eevent, eventCount[id]), part1.getID());
   }
 
   void 
@@ -450,10 +672,14 @@ namespace dynamo {
   void 
   Scheduler::lazyDeletionCleanup()
   {
+    //Only the lower 32 bits of the counters are compared, as that
+    //is all a CompactEvent stores
     std::pair<size_t, Event> next_event = sorter->next();
-    while ((next_event.second.type == INTERACTION) && (next_event.second.collCounter2 != eventCount[next_event.second.particle2ID]))
+    while ((next_event.second.type == INTERACTION) 
+	   && (uint32_t(next_event.second.collCounter2) != uint32_t(eventCount[next_event.second.particle2ID])))
       {
 	//Not valid, update the list
+	++_invalidationCounters.stalePops;
 	sorter->popNextEvent();
 	sorter->update(next_event.first);
 	sorter->sort();      
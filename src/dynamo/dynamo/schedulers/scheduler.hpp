@@ -18,6 +18,7 @@
 #pragma once
 #include <dynamo/base.hpp>
 #include <dynamo/schedulers/sorters/sorter.hpp>
+#include <dynamo/schedulers/counters.hpp>
 #include <dynamo/interactions/intEvent.hpp>
 #include <dynamo/globals/globEvent.hpp>
 #include <magnet/function/delegate.hpp>
@@ -96,6 +97,9 @@ namespace dynamo {
 
     const shared_ptr<FEL>& getSorter() const { return sorter; }
 
+    //! \brief Replaces the sorter, must be called before initialisation.
+    void setSorter(const shared_ptr<FEL>& nS) { sorter = nS; }
+
     void rebuildSystemEvents() const;
 
     void addInteractionEvent(const Particle&, const size_t&) const;
@@ -105,9 +109,59 @@ namespace dynamo {
     virtual std::unique_ptr<IDRange> getParticleNeighbours(const Particle&) const = 0;
     virtual std::unique_ptr<IDRange> getParticleNeighbours(const Vector&) const = 0;
     virtual std::unique_ptr<IDRange> getParticleLocals(const Particle&) const = 0;
+
+    /*! \brief Appends the IDs of the particles in the neighbourhood
+        of a particle to the passed container.
+
+	Unlike the \ref IDRange returning version, this does not
+	allocate if the container already has sufficient capacity and
+	avoids a virtual call per ID. It is used in the event
+	prediction hot path with a reused buffer.
+     */
+    virtual void getParticleNeighbours(const Particle&, std::vector<size_t>&) const = 0;
+
+    /*! \brief Appends the IDs of the \ref Local s which may interact
+        with a particle to the passed container.
+
+	\sa getParticleNeighbours(const Particle&, std::vector<size_t>&)
+     */
+    virtual void getParticleLocals(const Particle&, std::vector<size_t>&) const = 0;
     
     const std::vector<size_t>& getEventCounts() const { return eventCount; }
 
+    /*! \brief Counters used to compare the lazy and eager event
+        invalidation strategies.
+     */
+    struct InvalidationCounters
+    {
+      InvalidationCounters():
+	stalePops(0), eagerRemovals(0), occupancySamples(0),
+	occupancySum(0), peakOccupancy(0), peakMemory(0)
+      {}
+
+      //! \brief Invalid events discarded as they reached the top of the FEL.
+      size_t stalePops;
+      //! \brief Invalid events removed from the PELs in place.
+      size_t eagerRemovals;
+      size_t occupancySamples;
+      double occupancySum;
+      //! \brief The largest number of events sampled in the PELs.
+      size_t peakOccupancy;
+      //! \brief The largest sampled memory (in bytes) used to store
+      //! the events and event handles.
+      size_t peakMemory;
+    };
+
+    //! \brief Selects eager or lazy invalidation, must be set before initialisation.
+    void setEagerInvalidation(bool eager) { _eagerInvalidation = eager; }
+
+    const InvalidationCounters& getInvalidationCounters() const { return _invalidationCounters; }
+
+    const SchedulerCounters& getCounters() const { return _counters; }
+
+    //! \brief Writes the InvalidationCounters and SchedulerCounters to the output XML.
+    void outputCounters(magnet::xml::XmlStream&) const;
+
   protected:
     /*! \brief Performs the lazy deletion algorithm to find the next
       valid event in the queue.
@@ -118,8 +172,108 @@ namespace dynamo {
      */
     void lazyDeletionCleanup();
 
+    /*! \brief Pushes an event into a PEL of the sorter, recording an
+        event handle for the partner particle of interaction events
+        if eager invalidation is enabled.
+     */
+    inline void pushParticleEvent(const Event& event, const size_t ID) const
+    {
+      sorter->push(event, ID);
+      if (_eagerInvalidation && (event.type == INTERACTION))
+	addEventHandle(event.particle2ID, ID);
+    }
+
+    /*! \brief Records that the PEL of particle ID may contain an
+        interaction event with the particle partnerID.
+
+	Handles to PELs which have since been cleared are compacted
+	out before the handle list would need to grow, so the number
+	of handles per particle stays bounded by its current events.
+     */
+    void addEventHandle(const size_t partnerID, const size_t ID) const;
+
+    //! \brief Samples the number of events stored and their memory use.
+    void sampleQueueOccupancy();
+
     mutable shared_ptr<FEL> sorter;
     mutable std::vector<size_t> eventCount;
+
+    /*! \brief If set, the interaction events of a particle are
+        removed from the PELs of its partners as soon as the particle
+        is invalidated, instead of being lazily discarded when they
+        reach the top of the FEL.
+     */
+    bool _eagerInvalidation;
+
+    /*! \brief The event handles of each particle for eager
+        invalidation.
+
+	For each particle, this stores the IDs of the particles whose
+	PELs may hold an interaction event with it, along with the
+	eventCount of the owning particle when the event was
+	pushed. If the eventCount has since changed, the owning PEL
+	has been cleared and the handle is stale.
+     */
+    mutable std::vector<std::vector<std::pair<size_t, size_t> > > _eventHandles;
+
+    InvalidationCounters _invalidationCounters;
+    size_t _eventsSinceSample;
+
+    SchedulerCounters _counters;
+
+    /*! \brief The working storage used to predict the events of a
+        particle.
+
+	These are reused to avoid any allocations in the event
+	prediction hot path.
+     */
+    struct PredictionBuffers
+    {
+      //! \brief The IDs of the neighbours and Local's of the particle.
+      std::vector<size_t> neighbours;
+      std::vector<size_t> locals;
+      //! \brief The neighbours grouped by the Interaction they use.
+      std::vector<std::pair<const Interaction*, std::vector<size_t> > > interactionBatches;
+      std::vector<IntEvent> intEvents;
+      //! \brief The predicted events of the particle.
+      std::vector<Event> events;
+      //! \brief Counts of the predictions made and neighbours
+      //! tested, used by addAllEventsParallel().
+      size_t predictions = 0;
+      size_t neighbourTotal = 0;
+    };
+
+    /*! \brief Calculates the events of a particle, appending them to
+        PredictionBuffers::events.
+
+	The neighbours are grouped by their Interaction so that each
+	Interaction may calculate its events as a batch (see
+	Interaction::getEvents).
+
+	If every particle is up to date, this does not modify any
+	state outside of the passed buffers and may be called
+	concurrently as long as concurrentPrediction() is true.
+     */
+    void predictEvents(Particle&, PredictionBuffers&) const;
+
+    /*! \brief Tests if the Dynamics, the BoundaryCondition and every
+        Interaction, Local and Global allow events to be calculated
+        concurrently.
+     */
+    bool concurrentPrediction() const;
+
+    /*! \brief Predicts the events of all particles using the
+        Simulation::threadPool and pushes them into the sorter.
+
+	Each task predicts the events of a contiguous block of
+	particles into its own buffers. These are then pushed into the
+	sorter in particle order, so the resulting event list is
+	identical to a serial rebuild.
+     */
+    void addAllEventsParallel();
+
+    //! \brief Reused buffers for addEvents().
+    PredictionBuffers _buffers;
   
     size_t _interactionRejectionCounter;
     size_t _localRejectionCounter;
@@ -18,6 +18,7 @@
 #pragma once
 
 #include <dynamo/schedulers/sorters/event.hpp>
+#include <dynamo/schedulers/sorters/compactevent.hpp>
 #include <magnet/xmlwriter.hpp>
 #include <magnet/containers/MinMaxHeap.hpp>
 
@@ -28,11 +29,14 @@ namespace dynamo {
     MinMaxHeaps.  The top element is set to HUGE_VAL, whenever the
     queue is cleared, or pop'd empty. This means no conditional logic
     is required to deal with the comparison of empty queues.
+
+    \tparam E The type used to store the events, either \ref Event
+    or \ref CompactEvent.
   */
-  template<size_t Size>
-  class PELMinMax: public magnet::containers::MinMaxHeap<Event,Size>
+  template<size_t Size, class E = Event>
+  class PELMinMax: public magnet::containers::MinMaxHeap<E,Size>
   {
-    typedef magnet::containers::MinMaxHeap<Event,Size> Base;
+    typedef magnet::containers::MinMaxHeap<E,Size> Base;
   public:
     PELMinMax() { 
       clear(); 
@@ -61,26 +65,49 @@ namespace dynamo {
     }
   
     inline void stream(const double& ndt) {
-      for(Event& dat : *this)
+      for(E& dat : *this)
 	dat.dt -= ndt;
     }
 
     inline void push(const Event& __x) {
+      const E event(__x);
       if (!Base::full())
-	Base::insert(__x);
+	Base::insert(event);
       else 
 	{
-	  if (__x < Base::bottom())
-	    Base::replaceMax(__x);
-	  Base::unsafe_bottom().type = RECALCULATE;
+	  if (event < Base::bottom())
+	    Base::replaceMax(event);
+	  Base::unsafe_bottom().setType(RECALCULATE);
 	}
     }
 
     inline void rescaleTimes(const double& scale) { 
-      for (Event& dat : *this)
+      for (E& dat : *this)
 	dat.dt *= scale;
     }
 
+    /*! \brief Removes any interaction events with the passed
+        particle, returning the number of events removed.
+
+	The heap holds at most Size events, so the remaining events
+	are simply reinserted.
+     */
+    inline size_t removeInteractionEvents(const size_t& ID2) {
+      E kept[Size];
+      size_t count(0);
+      for (const E& event : *this)
+	if ((event.getType() != INTERACTION) || (event.getParticle2ID() != ID2))
+	  kept[count++] = event;
+
+      const size_t removed = Base::size() - count;
+      if (!removed) return 0;
+
+      clear();
+      for (size_t i(0); i < count; ++i)
+	Base::insert(kept[i]);
+      return removed;
+    }
+
     inline void swap(PELMinMax& rhs) {
       Base::swap(rhs);
     }
@@ -90,8 +117,8 @@ namespace dynamo {
 namespace std
 {
   /*! \brief Template specialisation of the std::swap function for PELHeap*/
-  template<size_t Size>
-  void swap(dynamo::PELMinMax<Size>& lhs, dynamo::PELMinMax<Size>& rhs)
+  template<size_t Size, class E>
+  void swap(dynamo::PELMinMax<Size, E>& lhs, dynamo::PELMinMax<Size, E>& rhs)
   {
     lhs.swap(rhs);
   }
@@ -28,23 +28,23 @@
 #include <iostream>
 
 namespace dynamo {
-  template<size_t Size>
+  template<size_t Size, class E>
   class PELMinMax;
 
   class PELSingleEvent;
 
   template<class T> struct FELBoundedPQName;
 
-  template<>
-  struct FELBoundedPQName<PELHeap>
+  template<class E>
+  struct FELBoundedPQName<PELHeapT<E> >
   {
-    inline static std::string name() { return "BoundedPQ"; }
+    inline static std::string name() { return "BoundedPQ" + PELEventName<E>::suffix(); }
   };
 
-  template<size_t I>
-  struct FELBoundedPQName<PELMinMax<I> >
+  template<size_t I, class E>
+  struct FELBoundedPQName<PELMinMax<I, E> >
   {
-    inline static std::string name() { return std::string("BoundedPQMinMax") + boost::lexical_cast<std::string>(I); }
+    inline static std::string name() { return std::string("BoundedPQMinMax") + boost::lexical_cast<std::string>(I) + PELEventName<E>::suffix(); }
   };
 
   template<>
@@ -237,6 +237,16 @@ namespace dynamo {
     }
 
     inline void clearPEL(const size_t& ID) { Min[ID+1].data.clear(); }
+    inline size_t removeInteractionEvents(const size_t& ID, const size_t& ID2) { return Min[ID+1].data.removeInteractionEvents(ID2); }
+
+    inline size_t size() const
+    {
+      size_t count(0);
+      for (const eventQEntry& dat : Min)
+	count += dat.data.size();
+      return count;
+    }
+
     inline void popNextPELEvent(const size_t& ID) { Min[ID+1].data.pop(); }
     inline void popNextEvent() { Min[CBT[1]].data.pop(); }
     virtual bool empty() const { return Min[CBT[1]].data.empty(); }
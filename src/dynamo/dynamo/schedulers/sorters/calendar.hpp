@@ -0,0 +1,514 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <dynamo/schedulers/sorters/event.hpp>
+#include <dynamo/schedulers/sorters/sorter.hpp>
+#include <dynamo/schedulers/sorters/heapPEL.hpp>
+#include <magnet/exception.hpp>
+#include <magnet/xmlwriter.hpp>
+#include <boost/lexical_cast.hpp>
+#include <string>
+#include <vector>
+#include <limits>
+#include <cmath>
+#include <iostream>
+
+namespace dynamo {
+  template<size_t Size, class E>
+  class PELMinMax;
+
+  class PELSingleEvent;
+
+  template<class T> struct FELCalendarName;
+
+  template<class E>
+  struct FELCalendarName<PELHeapT<E> >
+  {
+    inline static std::string name() { return "Calendar" + PELEventName<E>::suffix(); }
+  };
+
+  template<size_t I, class E>
+  struct FELCalendarName<PELMinMax<I, E> >
+  {
+    inline static std::string name() { return std::string("CalendarMinMax") + boost::lexical_cast<std::string>(I) + PELEventName<E>::suffix(); }
+  };
+
+  template<>
+  struct FELCalendarName<PELSingleEvent>
+  {
+    inline static std::string name() { return "CalendarSingleEvent"; }
+  };
+
+  /*! \brief An adaptive calendar queue Future Event List.
+
+    The PELs are binned by the time of their next event into "days"
+    of width \ref _width. The days are mapped onto a circular array of
+    buckets (a "year"), and the PELs of the current day are sorted
+    exactly using a complete binary tree. Unlike \ref FELBoundedPQ
+    there is no overflow list; PELs which lie beyond the current year
+    simply remain in their bucket until their day comes around.
+
+    The day width is re-tuned online. The mean spacing between
+    consecutive events leaving the queue is measured and, every N
+    pops, the day width is reset to \ref _targetOccupancy times this
+    spacing if it has drifted by more than a factor of two. The
+    re-binning is O(N) and happens at most once every N pops, so
+    insertion and removal remain O(1) amortised.
+  */
+  template<typename T = PELHeap>
+  class FELCalendar: public FEL
+  {
+  private:
+    struct eventQEntry
+    {
+      T data;
+      int next;
+      int previous;
+      //! The calendar day this PEL is filed under.
+      long long day;
+    };
+
+    //! The day used to file PELs which contain no finite events.
+    static const long long INF_DAY = std::numeric_limits<long long>::max();
+
+    //! The desired number of events per day.
+    static constexpr double _targetOccupancy = 3.0;
+
+    //Calendar variables
+    std::vector<int> _buckets;
+    int _infinite;
+    size_t _bucketed;
+    long long _currentDay;
+    double _width;
+    double pecTime;
+
+    //Tuning statistics
+    double _lastEventTime;
+    double _spacingSum;
+    size_t _spacingCount;
+    size_t _popsSinceCheck;
+    size_t _retunes;
+    size_t _yearSkips;
+
+    //Binary tree variables
+    std::vector<unsigned long> CBT;
+    std::vector<unsigned long> Leaf;
+    std::vector<eventQEntry> Min;
+    size_t NP, N;
+
+  public:
+    FELCalendar(): _retunes(0), _yearSkips(0) { clear(); }
+
+    ~FELCalendar()
+    {
+      std::cout << "Calendar retunes = " << _retunes
+		<< ", Year skips = " << _yearSkips << std::endl;
+    }
+
+    void resize(const size_t& a)
+    {
+      clear();
+      N = a;
+      CBT.resize(2 * N);
+      Leaf.resize(N + 1);
+      Min.resize(N + 1);
+    }
+
+    void clear()
+    {
+      Min.clear();
+      CBT.clear();
+      Leaf.clear();
+      _buckets.clear();
+      _infinite = -1;
+      _bucketed = 0;
+      _currentDay = 0;
+      _width = 1;
+      N = 0;
+      NP = 0;
+      pecTime = 0.0;
+      resetStatistics(0);
+    }
+
+    inline void stream(const double& ndt) { pecTime += ndt; }
+
+    void init() { init(false); }
+
+    void rebuild() { init(true); }
+
+    void init(bool quiet)
+    {
+      //Make an initial guess for the day width from the spread of
+      //the queued events, the online tuning will correct it later.
+      double minVal(HUGE_VAL), maxVal(-HUGE_VAL);
+      size_t counter(0);
+      for (size_t i(1); i <= N; ++i)
+	{
+	  const double dt = Min[i].data.getdt();
+	  if (std::isinf(dt)) continue;
+	  minVal = std::min(minVal, dt);
+	  maxVal = std::max(maxVal, dt);
+	  ++counter;
+	}
+
+      if ((counter > 1) && (maxVal > minVal))
+	_width = _targetOccupancy * (maxVal - minVal) / counter;
+      else
+	{
+	  if (!quiet)
+	    std::cerr << "The event queue doesn't have enough VALID events in it to"
+	      "\ninstrument the calendar queue, using a day width of 1 until"
+	      "\nthe online tuning corrects it." << std::endl;
+	  _width = 1;
+	}
+
+      //The number of buckets is a power of two so the day to bucket
+      //mapping is a mask
+      size_t nbuckets = 16;
+      while (nbuckets < N) nbuckets *= 2;
+      _buckets.assign(nbuckets, -1);
+
+      resetStatistics((counter > 0) ? minVal : pecTime);
+
+      if (!quiet)
+	std::cout << "Calendar buckets = " << nbuckets
+		  << " Day width = " << _width
+		  << std::endl;
+
+      rebin();
+
+      if (!quiet)
+	std::cout << "Ready for simulation." << std::endl;
+    }
+
+    inline void push(const Event& tmpVal, const size_t& pID)
+    {
+#ifdef DYNAMO_DEBUG
+      if (std::isnan(tmpVal.dt))
+	M_throw() << "NaN value pushed into the sorter! Should be Inf I guess?";
+#endif
+
+      tmpVal.dt += pecTime;
+      Min[pID + 1].data.push(tmpVal);
+    }
+
+    inline void update(const size_t& pID)
+    {
+      deleteFromEventQ(pID + 1);
+      insertInEventQ(pID + 1);
+    }
+
+    inline void clearPEL(const size_t& ID) { Min[ID+1].data.clear(); }
+    inline size_t removeInteractionEvents(const size_t& ID, const size_t& ID2) { return Min[ID+1].data.removeInteractionEvents(ID2); }
+
+    inline size_t size() const
+    {
+      size_t count(0);
+      for (const eventQEntry& dat : Min)
+	count += dat.data.size();
+      return count;
+    }
+
+    inline void popNextPELEvent(const size_t& ID) { Min[ID+1].data.pop(); }
+
+    inline void popNextEvent()
+    {
+      if (!NP) return;
+
+      //Collect the spacing between events leaving the queue
+      const double t = Min[CBT[1]].data.getdt();
+      if (std::isfinite(t))
+	{
+	  if (t > _lastEventTime)
+	    {
+	      _spacingSum += t - _lastEventTime;
+	      _lastEventTime = t;
+	    }
+	  ++_spacingCount;
+	}
+      ++_popsSinceCheck;
+
+      Min[CBT[1]].data.pop();
+    }
+
+    virtual bool empty() const { return !NP || Min[CBT[1]].data.empty(); }
+
+    virtual std::pair<size_t, Event> next() const
+    {
+      //Only PELs without events remain, return a NONE event
+      if (!NP) return std::pair<size_t, Event>(0, Event());
+
+      Event nextevent = Min[CBT[1]].data.top();
+      nextevent.dt -= pecTime;
+      return std::pair<size_t, Event>(CBT[1] - 1, nextevent);
+    }
+
+    inline void sort()
+    {
+      if (_popsSinceCheck > N) retune();
+      orderNextEvent();
+    }
+
+    inline void rescaleTimes(const double& factor)
+    {
+      for (eventQEntry& dat : Min)
+	dat.data.rescaleTimes(factor);
+
+      //The days are invariant under the rescaling if the width is
+      //rescaled too
+      pecTime *= factor;
+      _width *= factor;
+      _lastEventTime *= factor;
+      _spacingSum *= factor;
+    }
+
+  private:
+    inline void resetStatistics(const double& time)
+    {
+      _lastEventTime = time;
+      _spacingSum = 0;
+      _spacingCount = 0;
+      _popsSinceCheck = 0;
+    }
+
+    inline long long getDay(const double& t) const
+    {
+      const double day = std::floor(t / _width);
+      //Events in the past (negative time events) are filed under the
+      //current day
+      if (!(day > _currentDay)) return _currentDay;
+      //Clamp days which are too far in the future to represent, they
+      //are found by the year skipping in orderNextEvent()
+      if (day >= double(INF_DAY / 2)) return INF_DAY / 2;
+      return static_cast<long long>(day);
+    }
+
+    inline int& getList(const long long& day)
+    { return (day == INF_DAY) ? _infinite : _buckets[day & (_buckets.size() - 1)]; }
+
+    /*! \brief Compare the measured event spacing against the day
+        width, and re-bin the calendar if it has drifted too far.
+     */
+    inline void retune()
+    {
+      const double meanSpacing = _spacingSum / _spacingCount;
+      const double year = _width * _buckets.size();
+      resetStatistics(_lastEventTime);
+
+      if (!(meanSpacing > 0) || std::isinf(meanSpacing))
+	return;
+
+      const double ratio = _targetOccupancy * meanSpacing / _width;
+      //Also re-bin if the peculiar time is becoming large enough to
+      //degrade the precision of the event times
+      if ((ratio > 2) || (ratio < 0.5) || (std::abs(pecTime) > 1000 * year))
+	{
+	  _width = _targetOccupancy * meanSpacing;
+	  ++_retunes;
+	  rebin();
+	}
+    }
+
+    /*! \brief Remove every PEL from the calendar and file them again
+        using the current day width.
+     */
+    inline void rebin()
+    {
+      //Rebase the event times to stop the peculiar time growing
+      //without bound
+      for (eventQEntry& dat : Min)
+	dat.data.stream(pecTime);
+      _lastEventTime -= pecTime;
+      pecTime = 0;
+
+      std::fill(_buckets.begin(), _buckets.end(), -1);
+      _infinite = -1;
+      _bucketed = 0;
+      NP = 0;
+
+      double minVal(HUGE_VAL);
+      for (size_t i(1); i <= N; ++i)
+	minVal = std::min(minVal, Min[i].data.getdt());
+
+      _currentDay = std::numeric_limits<long long>::min();
+      if (!std::isinf(minVal)) _currentDay = getDay(minVal);
+
+      for (size_t i(1); i <= N; ++i)
+	insertInEventQ(i);
+
+      orderNextEvent();
+    }
+
+    ///////////////////////////CALENDAR IMPLEMENTATION
+    inline void insertInEventQ(int p)
+    {
+      const double dt = Min[p].data.getdt();
+      const long long day = std::isinf(dt) ? INF_DAY : getDay(dt);
+      Min[p].day = day;
+
+      if (day == _currentDay)
+	{
+	  Insert(p);
+	  return;
+	}
+
+      if (day != INF_DAY) ++_bucketed;
+      int& head = getList(day);
+      Min[p].previous = -1;
+      Min[p].next = head;
+      if (head != -1)
+	Min[head].previous = p;
+      head = p;
+    }
+
+    inline void deleteFromEventQ(const int& e)
+    {
+      if (Min[e].day == _currentDay)
+	{
+	  Delete(e);
+	  return;
+	}
+
+      if (Min[e].day != INF_DAY) --_bucketed;
+      unlink(e);
+    }
+
+    inline void unlink(const int& e)
+    {
+      const int prev = Min[e].previous, next = Min[e].next;
+      if (prev == -1)
+	getList(Min[e].day) = next;
+      else
+	Min[prev].next = next;
+
+      if (next != -1)
+	Min[next].previous = prev;
+    }
+
+    inline void orderNextEvent()
+    {
+      size_t emptyDays = 0;
+      while (!NP && _bucketed)
+	{
+	  if (++emptyDays > _buckets.size())
+	    {
+	      //A whole year has passed without an event, the day width
+	      //is too small. Jump directly to the next occupied day.
+	      _currentDay = INF_DAY;
+	      for (size_t i(1); i <= N; ++i)
+		if (Min[i].day != INF_DAY)
+		  _currentDay = std::min(_currentDay, Min[i].day);
+	      ++_yearSkips;
+	    }
+	  else
+	    ++_currentDay;
+
+	  //Move all of today's PELs into the binary tree
+	  for (int e = getList(_currentDay); e != -1;)
+	    {
+	      const int next = Min[e].next;
+	      if (Min[e].day == _currentDay)
+		{
+		  unlink(e);
+		  --_bucketed;
+		  Insert(e);
+		}
+	      e = next;
+	    }
+	}
+    }
+
+    ///////////////////////////BINARY TREE IMPLEMENTATION
+    inline void UpdateCBT(const unsigned int& i)
+    {
+      unsigned int f = Leaf[i] / 2;
+
+      for(; (f > 0) && (CBT[f] == i); f /= 2)
+	{
+	  unsigned int l = CBT[f*2],
+	    r = CBT[f*2+1];
+	  CBT[f] = (Min[r].data > Min[l].data) ? l : r;
+	}
+
+      //Walk up finding the winners till it doesn't change or you hit
+      //the top of the tree
+      for( ; f>0; f /= 2)
+	{
+	  unsigned int w = CBT[f], /* old winner */
+	    l = CBT[f*2],
+	    r = CBT[f*2+1];
+
+	  CBT[f] = (Min[r].data > Min[l].data) ? l : r;
+
+	  if (CBT[f] == w) return; /* end of the event time comparisons */
+	}
+    }
+
+    inline void Insert(const unsigned int& i)
+    {
+      if (NP)
+	{
+	  int j = CBT[NP];
+	  CBT [NP*2] = j;
+	  CBT [NP*2+1] = i;
+	  Leaf[j] = NP*2;
+	  Leaf[i]= NP*2+1;
+	  ++NP;
+	  UpdateCBT(j);
+	}
+      else
+	{
+	  CBT[1]=i;
+	  Leaf[i]=1;
+	  ++NP;
+	}
+    }
+
+    inline void Delete(const unsigned int& i)
+    {
+      if (NP < 2) { CBT[1]=0; Leaf[0]=1; --NP; return; }
+
+      int l = NP * 2 - 1;
+
+      if (CBT[l-1] == i)
+	{
+	  Leaf[CBT[l]] = l/2;
+	  CBT[l/2] =CBT[l];
+	  UpdateCBT(CBT[l]);
+	  --NP;
+	  return;
+	}
+
+      Leaf[CBT[l-1]] = l/2;
+      CBT[l/2] = CBT[l-1];
+      UpdateCBT(CBT[l-1]);
+
+      if (CBT[l] != i)
+	{
+	  CBT[Leaf[i]] = CBT[l];
+	  Leaf[CBT[l]] = Leaf[i];
+	  UpdateCBT(CBT[l]);
+	}
+
+      --NP;
+    }
+
+    virtual void outputXML(magnet::xml::XmlStream& XML) const
+    { XML << magnet::xml::attr("Type") << FELCalendarName<T>::name(); }
+  };
+}
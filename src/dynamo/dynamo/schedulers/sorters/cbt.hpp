@@ -82,6 +82,16 @@ namespace dynamo {
     }
 
     inline void clearPEL(const size_t& ID) { Min[ID+1].clear(); }
+    inline size_t removeInteractionEvents(const size_t& ID, const size_t& ID2) { return Min[ID+1].removeInteractionEvents(ID2); }
+
+    inline size_t size() const
+    {
+      size_t count(0);
+      for (const PELHeap& pDat : Min)
+	count += pDat.size();
+      return count;
+    }
+
     inline void popNextPELEvent(const size_t& ID) { Min[ID+1].pop(); }
     inline void popNextEvent() { Min[CBT[1]].pop(); }
     inline bool empty() const { return Min[CBT[1]].empty(); }
@@ -0,0 +1,118 @@
+/*  dynamo:- Event driven molecular dynamics simulator 
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <dynamo/schedulers/sorters/event.hpp>
+#include <magnet/exception.hpp>
+#include <cstdint>
+#include <cmath>
+#include <limits>
+#include <string>
+
+namespace dynamo {
+  /*! \brief A 16 byte encoding of an \ref Event, used to store events
+      in the PELs of the "Compact" sorters.
+
+      An \ref Event is 32 bytes with padding. This packs the partner
+      ID and the event type into one 32 bit word and keeps a 32 bit
+      event counter, so twice as many events fit into each cache line
+      of the PELs. The cost is that particle IDs are limited to
+      \ref maxID, and only the lower 32 bits of the event counter are
+      kept (see Scheduler::lazyDeletionCleanup).
+
+      Only the event types which are stored in the sorters (NONE,
+      INTERACTION, GLOBAL, LOCAL, SYSTEM and RECALCULATE) can be
+      encoded.
+   */
+  class CompactEvent
+  {
+    static const uint32_t typeBits = 3;
+    static const uint32_t IDMask = (uint32_t(1) << (32 - typeBits)) - 1;
+
+  public:
+    //! \brief The largest ID which can be stored.
+    static const size_t maxID = IDMask;
+
+    inline CompactEvent():
+      dt(HUGE_VAL),
+      _IDType(IDMask),
+      _collCounter2(std::numeric_limits<uint32_t>::max())
+    {}
+
+    inline CompactEvent(const Event& event):
+      dt(event.dt),
+      _IDType(uint32_t(event.extraID) & IDMask),
+      _collCounter2(uint32_t(event.collCounter2))
+    {
+      if ((event.type != NONE) && (event.extraID > maxID))
+	M_throw() << "Cannot store an event with ID " << event.extraID 
+		  << " in a compact event, the maximum ID is " << maxID;
+      setType(event.type);
+    }
+
+    inline operator Event() const
+    { return Event(dt, getType(), getParticle2ID(), _collCounter2); }
+
+    inline bool operator< (const CompactEvent& ip) const throw()
+    { return dt < ip.dt; }
+
+    inline bool operator> (const CompactEvent& ip) const throw()
+    { return dt > ip.dt; }
+
+    inline EEventType getType() const 
+    {
+      static const EEventType types[] = {NONE, INTERACTION, GLOBAL, LOCAL, SYSTEM, RECALCULATE};
+      return types[_IDType >> (32 - typeBits)];
+    }
+
+    inline void setType(const EEventType type)
+    {
+      uint32_t code;
+      switch (type)
+	{
+	case NONE:        code = 0; break;
+	case INTERACTION: code = 1; break;
+	case GLOBAL:      code = 2; break;
+	case LOCAL:       code = 3; break;
+	case SYSTEM:      code = 4; break;
+	case RECALCULATE: code = 5; break;
+	default:
+	  M_throw() << "Cannot store an event of type " << type << " in a compact event";
+	}
+      _IDType = (_IDType & IDMask) | (code << (32 - typeBits));
+    }
+
+    inline size_t getParticle2ID() const { return _IDType & IDMask; }
+
+    double dt;
+
+  private:
+    uint32_t _IDType;
+    uint32_t _collCounter2;
+  };
+
+  /*! \brief The suffix added to the sorter names for PELs storing
+      the passed event type.
+   */
+  template<class E> struct PELEventName;
+
+  template<> struct PELEventName<Event>
+  { inline static std::string suffix() { return ""; } };
+
+  template<> struct PELEventName<CompactEvent>
+  { inline static std::string suffix() { return "Compact"; } };
+}
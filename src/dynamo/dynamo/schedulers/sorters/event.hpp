@@ -89,6 +89,11 @@ namespace dynamo {
 
     inline void stream(const double& ndt) throw() { dt -= ndt; }
 
+    //! \brief Accessors shared with \ref CompactEvent for use in the PELs.
+    inline EEventType getType() const { return type; }
+    inline void setType(const EEventType ntype) { type = ntype; }
+    inline size_t getParticle2ID() const { return particle2ID; }
+
     mutable double dt;
     unsigned long collCounter2;
     EEventType type;
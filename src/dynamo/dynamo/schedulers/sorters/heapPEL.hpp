@@ -17,14 +17,23 @@
 
 #pragma once
 #include <dynamo/schedulers/sorters/event.hpp>
+#include <dynamo/schedulers/sorters/compactevent.hpp>
 #include <queue>
 
 namespace dynamo {
-  class PELHeap: public std::priority_queue<Event, std::vector<Event>, std::greater<Event> >
+  /*! \brief A binary heap used for Particle Event Lists.
+      
+      \tparam E The type used to store the events, either \ref Event
+      or \ref CompactEvent.
+   */
+  template<class E>
+  class PELHeapT: public std::priority_queue<E, std::vector<E>, std::greater<E> >
   {
-    typedef std::priority_queue<Event, std::vector<Event>, std::greater<Event> > Base;
+    typedef std::priority_queue<E, std::vector<E>, std::greater<E> > Base;
+    using Base::c;
+    using Base::comp;
   public:
-    inline bool operator> (const PELHeap& ip) const { 
+    inline bool operator> (const PELHeapT& ip) const { 
       //If the other is empty this can never be longer
       //If this is empty and the other isn't its always longer
       //Otherwise compare
@@ -35,7 +44,7 @@ namespace dynamo {
       c.clear();
     }
     
-    inline bool operator< (const PELHeap& ip) const {
+    inline bool operator< (const PELHeapT& ip) const {
       return (ip > *this);
     }
 
@@ -44,24 +53,39 @@ namespace dynamo {
     }
   
     inline void stream(const double& ndt) {
-      for (Event& dat : c)
+      for (E& dat : c)
 	dat.dt -= ndt;
     }
 
     inline void rescaleTimes(const double& scale) { 
-      for (Event& dat : c)
+      for (E& dat : c)
 	dat.dt *= scale;
     }
 
-    inline void swap(PELHeap& rhs) {
+    /*! \brief Removes any interaction events with the passed
+        particle, returning the number of events removed.
+     */
+    inline size_t removeInteractionEvents(const size_t& ID2) {
+      const size_t oldsize = c.size();
+      c.erase(std::remove_if(c.begin(), c.end(), [&](const E& event) 
+			     { return (event.getType() == INTERACTION) && (event.getParticle2ID() == ID2); }), c.end());
+      if (c.size() != oldsize)
+	std::make_heap(c.begin(), c.end(), comp);
+      return oldsize - c.size();
+    }
+
+    inline void swap(PELHeapT& rhs) {
       std::swap(c, rhs.c);
     }
   };
+
+  typedef PELHeapT<Event> PELHeap;
+  typedef PELHeapT<CompactEvent> PELCompactHeap;
 }
 
 namespace std
 {
   /*! \brief Template specialisation of the std::swap function for pList*/
-  template<> inline void swap(dynamo::PELHeap& lhs, dynamo::PELHeap& rhs)
+  template<class E> inline void swap(dynamo::PELHeapT<E>& lhs, dynamo::PELHeapT<E>& rhs)
   { lhs.swap(rhs); }
 }
@@ -72,6 +72,17 @@ namespace dynamo {
     inline void rescaleTimes(const double& scale) throw()
     { _event.dt *= scale; }
 
+    /*! \brief Removes an interaction event with the passed particle.
+
+	As the later events of the particle are not stored, the event
+	is converted into a RECALCULATE event in place.
+     */
+    inline size_t removeInteractionEvents(const size_t& ID2) {
+      if ((_event.type != INTERACTION) || (_event.particle2ID != ID2)) return 0;
+      _event.type = RECALCULATE;
+      return 1;
+    }
+
     inline void swap(PELSingleEvent& rhs)
     { std::swap(_event, rhs._event); }
   };
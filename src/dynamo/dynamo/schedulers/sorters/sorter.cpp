@@ -42,6 +42,32 @@ namespace dynamo {
       return shared_ptr<FEL>(new FELBoundedPQ<PELMinMax<7> >());
     if (std::string(XML.getAttribute("Type")) == FELBoundedPQName<PELMinMax<8> >::name())
       return shared_ptr<FEL>(new FELBoundedPQ<PELMinMax<8> >());
+    if (std::string(XML.getAttribute("Type")) == FELBoundedPQName<PELCompactHeap>::name())
+      return shared_ptr<FEL>(new FELBoundedPQ<PELCompactHeap>());
+    if (std::string(XML.getAttribute("Type")) == FELBoundedPQName<PELMinMax<2, CompactEvent> >::name())
+      return shared_ptr<FEL>(new FELBoundedPQ<PELMinMax<2, CompactEvent> >());
+    if (std::string(XML.getAttribute("Type")) == FELBoundedPQName<PELMinMax<3, CompactEvent> >::name())
+      return shared_ptr<FEL>(new FELBoundedPQ<PELMinMax<3, CompactEvent> >());
+    if (std::string(XML.getAttribute("Type")) == FELBoundedPQName<PELMinMax<4, CompactEvent> >::name())
+      return shared_ptr<FEL>(new FELBoundedPQ<PELMinMax<4, CompactEvent> >());
+    if (std::string(XML.getAttribute("Type")) == FELCalendarName<PELHeap>::name())
+      return shared_ptr<FEL>(new FELCalendar<>());
+    if (std::string(XML.getAttribute("Type")) == FELCalendarName<PELSingleEvent>::name())
+      return shared_ptr<FEL>(new FELCalendar<PELSingleEvent>());
+    if (std::string(XML.getAttribute("Type")) == FELCalendarName<PELMinMax<2> >::name())
+      return shared_ptr<FEL>(new FELCalendar<PELMinMax<2> >());
+    if (std::string(XML.getAttribute("Type")) == FELCalendarName<PELMinMax<3> >::name())
+      return shared_ptr<FEL>(new FELCalendar<PELMinMax<3> >());
+    if (std::string(XML.getAttribute("Type")) == FELCalendarName<PELMinMax<4> >::name())
+      return shared_ptr<FEL>(new FELCalendar<PELMinMax<4> >());
+    if (std::string(XML.getAttribute("Type")) == FELCalendarName<PELCompactHeap>::name())
+      return shared_ptr<FEL>(new FELCalendar<PELCompactHeap>());
+    if (std::string(XML.getAttribute("Type")) == FELCalendarName<PELMinMax<2, CompactEvent> >::name())
+      return shared_ptr<FEL>(new FELCalendar<PELMinMax<2, CompactEvent> >());
+    if (std::string(XML.getAttribute("Type")) == FELCalendarName<PELMinMax<3, CompactEvent> >::name())
+      return shared_ptr<FEL>(new FELCalendar<PELMinMax<3, CompactEvent> >());
+    if (std::string(XML.getAttribute("Type")) == FELCalendarName<PELMinMax<4, CompactEvent> >::name())
+      return shared_ptr<FEL>(new FELCalendar<PELMinMax<4, CompactEvent> >());
     else if (std::string(XML.getAttribute("Type")) == std::string("CBT"))
       return shared_ptr<FEL>(new FELCBT());
     else 
@@ -50,6 +50,16 @@ namespace dynamo {
     virtual void   popNextPELEvent(const size_t&) = 0;
     virtual void   popNextEvent() = 0;
 
+    /*! \brief Removes the interaction events with particle ID2 from
+        the PEL of particle ID, returning the number of events removed.
+
+	The PEL is not resorted, update(ID) must be called afterwards.
+     */
+    virtual size_t removeInteractionEvents(const size_t& ID, const size_t& ID2) = 0;
+
+    //! \brief The total number of events stored in the PELs.
+    virtual size_t size() const = 0;
+
     static shared_ptr<FEL> getClass(const magnet::xml::Node&);
 
     friend magnet::xml::XmlStream& operator<<(magnet::xml::XmlStream&, const FEL&);
@@ -95,4 +95,12 @@ namespace dynamo {
   {
     return std::unique_ptr<IDRange>(new IDRangeNone());
   }
+
+  void
+  SSystemOnly::getParticleNeighbours(const Particle&, std::vector<size_t>&) const
+  {}
+
+  void
+  SSystemOnly::getParticleLocals(const Particle&, std::vector<size_t>&) const
+  {}
 }
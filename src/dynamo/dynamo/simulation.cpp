@@ -26,9 +26,17 @@
 #include <dynamo/species/species.hpp>
 #include <dynamo/topology/topology.hpp>
 #include <dynamo/globals/global.hpp>
+#include <dynamo/globals/neighbourList.hpp>
 #include <dynamo/interactions/interaction.hpp>
+#include <dynamo/ranges/IDRange.hpp>
+#include <dynamo/ranges/IDPairRange.hpp>
 #include <dynamo/outputplugins/misc.hpp>
 #include <dynamo/globals/PBCSentinel.hpp>
+#include <dynamo/interactions/captures.hpp>
+#include <dynamo/binaryConfig.hpp>
+#include <dynamo/streamingConfig.hpp>
+#include <magnet/thread/threadpool.hpp>
+#include <magnet/thread/backgroundworker.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/iostreams/device/file.hpp>
 #include <boost/iostreams/filtering_stream.hpp>
@@ -39,6 +47,9 @@
 #include <dynamo/BC/BC.hpp>
 #include <iomanip>
 #include <set>
+#include <map>
+#include <limits>
+#include <algorithm>
 
 //! The configuration file version, a version mismatch prevents an XML file load.
 static const std::string configFileVersion("1.5.0");
@@ -57,7 +68,9 @@ namespace dynamo
     lastRunMFT(0.0),
     simID(0),
     replexExchangeNumber(0),
-    status(START)
+    threadPool(NULL),
+    status(START),
+    _classCount(0)
   {}
 
   namespace {
@@ -74,6 +87,47 @@ namespace dynamo
 	return (*lhs) < (*rhs);
       }
     };
+
+    /*! \brief Writes a file under a temporary name, then renames it
+        to the final path.
+
+	Readers of the final path only ever see complete files. If
+	the write or rename fails, the temporary file is removed.
+     */
+    void writeViaPartFile(const std::string& fileName, const std::function<void(const std::string&)>& write)
+    {
+      const std::string partName = fileName + ".part";
+      try {
+	write(partName);
+	boost::filesystem::rename(partName, fileName);
+      } catch (...)
+	{
+	  boost::system::error_code ec;
+	  boost::filesystem::remove(partName, ec);
+	  throw;
+	}
+    }
+
+    /*! \brief Writes a string to a (possibly bzip2 compressed) file.
+     */
+    void writeTextFile(const std::string& fileName, const std::string& compressedName, const std::function<void(std::ostream&)>& write)
+    {
+      namespace io = boost::iostreams;
+      io::file_sink sink(fileName);
+      if (!sink.is_open())
+	M_throw() << "Failed to open " << fileName << " for writing";
+
+      io::filtering_ostream os;
+      if (std::string(compressedName.end()-4, compressedName.end()) == ".bz2")
+	os.push(io::bzip2_compressor());
+      os.push(sink);
+      write(os);
+      if (!os)
+	M_throw() << "Failed to write " << fileName;
+
+      //Close the file, writing the end of the compressed stream
+      os.reset();
+    }
   }
 
   void
@@ -99,20 +153,8 @@ namespace dynamo
     for (shared_ptr<Species>& ptr : species)
       ptr->initialise();
 
-    unsigned int count = 0;
-    //Now confirm that every species has only one species type!
-    for (const Particle& part : particles)
-      {
-	for (shared_ptr<Species>& ptr : species)
-	  if (ptr->isSpecies(part)) { count++; break; }
-	
-	if (count < 1)
-	  M_throw() << "Particle ID=" << part.getID() << " has no species";
-	
-	if (count > 1)
-	  M_throw() << "Particle ID=" << part.getID() << " has more than one species";
-	count = 0;
-      }
+    //Now confirm that every particle has exactly one species, and cache it
+    species.buildCache(particles);
     
     //Now confirm that there are not more counts from each species
     //than there are particles
@@ -134,6 +176,8 @@ namespace dynamo
 
     status = SPECIES_INIT;
 
+    buildInteractionTable();
+
     //Check that each particle has a representative interaction
     for (const Particle& particle : particles)
       try {
@@ -148,14 +192,7 @@ namespace dynamo
 
     status = DYNAMICS_INIT;
 
-    for (size_t ID1 = 0; ID1 < N(); ++ID1)
-      for (size_t ID2 = ID1; ID2 < N(); ++ID2)
-	try {
-	  getInteraction(particles[ID1], particles[ID2]);
-	} catch (...)
-	  {
-	    M_throw() << "There is no Interaction defined between particle ID=" << ID1 << " and particle ID=" << ID2 << ". Each particle pairing must have an Interaction defined";
-	  }
+    checkPairInteractions();
     
     {
       size_t ID=0;
@@ -204,6 +241,14 @@ namespace dynamo
 
     status = GLOBAL_INIT;
 
+    //The capture maps are built once the neighbour lists are
+    //available, so only neighbouring pairs need to be tested.
+    for (shared_ptr<Interaction>& ptr : interactions)
+      {
+	ICapture* capture = dynamic_cast<ICapture*>(ptr.get());
+	if (capture) capture->initCaptureMap();
+      }
+
     //Search to check if a ticker System is needed
     for (shared_ptr<OutputPlugin>& Ptr : outputPlugins)
       if (std::dynamic_pointer_cast<OPTicker>(Ptr))
@@ -248,11 +293,7 @@ namespace dynamo
   IntEvent 
   Simulation::getEvent(const Particle& p1, const Particle& p2) const
   {
-    for (const shared_ptr<Interaction>& ptr : interactions)
-      if (ptr->isInteraction(p1,p2))
-	return ptr->getEvent(p1,p2);
-    
-    M_throw() << "Could not find the right interaction to test for";
+    return getInteraction(p1, p2)->getEvent(p1, p2);
   }
 
   void 
@@ -278,9 +319,175 @@ namespace dynamo
     return maxval;
   }
 
+  void
+  Simulation::buildInteractionTable()
+  {
+    _particleClass.clear();
+    _interactionTable.clear();
+    _idSpecificInteractions.clear();
+    _classCount = 0;
+
+    //Collect the IDRanges which determine the tabulated interactions
+    std::vector<const IDRange*> ranges;
+    std::vector<bool> tabulated(interactions.size());
+    for (size_t ID(0); ID < interactions.size(); ++ID)
+      {
+	std::vector<const IDRange*> intRanges;
+	tabulated[ID] = interactions[ID]->getRange()->getIDRanges(intRanges);
+	if (tabulated[ID])
+	  ranges.insert(ranges.end(), intRanges.begin(), intRanges.end());
+	else
+	  _idSpecificInteractions.push_back(ID);
+      }
+
+    std::sort(ranges.begin(), ranges.end());
+    ranges.erase(std::unique(ranges.begin(), ranges.end()), ranges.end());
+
+    //Sort the particles into classes by their IDRange membership,
+    //storing two members of each class to evaluate the table with
+    std::map<std::vector<bool>, size_t> classIDs;
+    std::vector<std::vector<size_t> > members;
+    _particleClass.resize(N());
+    std::vector<bool> signature(ranges.size());
+    for (const Particle& part : particles)
+      {
+	for (size_t i(0); i < ranges.size(); ++i)
+	  signature[i] = ranges[i]->isInRange(part);
+	
+	auto it = classIDs.insert(std::make_pair(signature, classIDs.size())).first;
+	_particleClass[part.getID()] = it->second;
+	if (it->second == members.size())
+	  members.push_back(std::vector<size_t>());
+	if (members[it->second].size() < 2)
+	  members[it->second].push_back(part.getID());
+      }
+
+    _classCount = classIDs.size();
+
+    //Guard against pathological range definitions which generate
+    //too many classes for the table to be useful
+    const size_t maxClasses = 1024;
+    if (_classCount > maxClasses)
+      {
+	dout << "Too many particle classes (" << _classCount 
+	     << ") for the interaction lookup table, using a linear search" << std::endl;
+	_particleClass.clear();
+	_classCount = 0;
+	return;
+      }
+
+    const size_t npos = std::numeric_limits<size_t>::max();
+    _interactionTable.resize(_classCount * _classCount, npos);
+    for (size_t c1(0); c1 < _classCount; ++c1)
+      for (size_t c2(0); c2 < _classCount; ++c2)
+	{
+	  //Find two distinct representative particles for this pair
+	  //of classes. If there are none, this pairing cannot occur.
+	  const size_t ID1 = members[c1][0];
+	  size_t ID2 = members[c2][0];
+	  if (c1 == c2)
+	    {
+	      if (members[c1].size() < 2) continue;
+	      ID2 = members[c1][1];
+	    }
+
+	  for (size_t ID(0); ID < interactions.size(); ++ID)
+	    if (tabulated[ID] && interactions[ID]->isInteraction(particles[ID1], particles[ID2]))
+	      {
+		_interactionTable[c1 * _classCount + c2] = ID;
+		break;
+	      }
+	}
+
+    dout << "Interaction lookup table built for " << _classCount << " particle classes, "
+	 << _idSpecificInteractions.size() << " Interactions are ID specific" << std::endl;
+  }
+
+  void
+  Simulation::checkPairInteractions() const
+  {
+    //Without an interaction table, every pair (including each
+    //particle with itself) must be tested
+    if (!_classCount)
+      {
+	for (size_t ID1 = 0; ID1 < N(); ++ID1)
+	  for (size_t ID2 = ID1; ID2 < N(); ++ID2)
+	    try {
+	      getInteraction(particles[ID1], particles[ID2]);
+	    } catch (...)
+	      {
+		M_throw() << "There is no Interaction defined between particle ID=" << ID1 << " and particle ID=" << ID2 << ". Each particle pairing must have an Interaction defined";
+	      }
+	return;
+      }
+
+    //The table does not cover the self-interactions of particles,
+    //so these are always tested individually.
+    for (const Particle& part : particles)
+      try {
+	getInteraction(part, part);
+      } catch (...)
+	{
+	  M_throw() << "There is no Interaction defined between particle ID=" << part.getID() << " and particle ID=" << part.getID() << ". Each particle pairing must have an Interaction defined";
+	}
+
+    //Every member of a pair of classes with a tabulated Interaction
+    //is covered by it. The pairings of the remaining classes may
+    //still be covered by ID specific Interactions, so these are
+    //tested individually.
+    std::vector<std::vector<size_t> > classMembers;
+    const size_t npos = std::numeric_limits<size_t>::max();
+    for (size_t c1(0); c1 < _classCount; ++c1)
+      for (size_t c2(c1); c2 < _classCount; ++c2)
+	{
+	  if ((_interactionTable[c1 * _classCount + c2] != npos)
+	      && (_interactionTable[c2 * _classCount + c1] != npos))
+	    continue;
+
+	  if (classMembers.empty())
+	    {
+	      classMembers.resize(_classCount);
+	      for (const Particle& part : particles)
+		classMembers[_particleClass[part.getID()]].push_back(part.getID());
+	    }
+
+	  for (size_t i(0); i < classMembers[c1].size(); ++i)
+	    for (size_t j((c1 == c2) ? i + 1 : 0); j < classMembers[c2].size(); ++j)
+	      {
+		const size_t ID1 = std::min(classMembers[c1][i], classMembers[c2][j]);
+		const size_t ID2 = std::max(classMembers[c1][i], classMembers[c2][j]);
+		try {
+		  getInteraction(particles[ID1], particles[ID2]);
+		} catch (...)
+		  {
+		    M_throw() << "There is no Interaction defined between particle ID=" << ID1 << " and particle ID=" << ID2 << ". Each particle pairing must have an Interaction defined";
+		  }
+	      }
+	}
+  }
+
   const shared_ptr<Interaction>&
   Simulation::getInteraction(const Particle& p1, const Particle& p2) const 
   {
+    if (_classCount && (p1.getID() != p2.getID()))
+      {
+	const size_t tabulatedID = _interactionTable[_particleClass[p1.getID()] * _classCount + _particleClass[p2.getID()]];
+
+	//Any ID specific interactions which take precedence over the
+	//tabulated interaction must still be tested
+	for (const size_t ID : _idSpecificInteractions)
+	  {
+	    if (ID > tabulatedID) break;
+	    if (interactions[ID]->isInteraction(p1, p2))
+	      return interactions[ID];
+	  }
+
+	if (tabulatedID < interactions.size())
+	  return interactions[tabulatedID];
+
+	M_throw() << "Could not find an Interaction between particles " << p1.getID() << " and " << p2.getID() << ". All particle pairings must have a corresponding Interaction defined.";
+      }
+
     for (const shared_ptr<Interaction>& ptr : interactions)
       if (ptr->isInteraction(p1,p2))
 	return ptr;
@@ -288,8 +495,34 @@ namespace dynamo
     M_throw() << "Could not find an Interaction between particles " << p1.getID() << " and " << p2.getID() << ". All particle pairings must have a corresponding Interaction defined.";
   }
 
+  void
+  Simulation::SpeciesContainer::buildCache(const std::vector<Particle>& particles)
+  {
+    invalidateCache();
+
+    std::vector<uint32_t> cache(particles.size());
+    for (const Particle& part : particles)
+      {
+	size_t ID(0);
+	for (; ID < size(); ++ID)
+	  if ((*this)[ID]->isSpecies(part)) break;
+	
+	if (ID == size())
+	  M_throw() << "Particle ID=" << part.getID() << " has no species";
+
+	for (size_t ID2(ID + 1); ID2 < size(); ++ID2)
+	  if ((*this)[ID2]->isSpecies(part))
+	    M_throw() << "Particle ID=" << part.getID() << " has more than one species";
+
+	cache[part.getID()] = ID;
+      }
+
+    _particleSpecies.swap(cache);
+    _particles = &particles;
+  }
+
   const shared_ptr<Species>& 
-  Simulation::SpeciesContainer::operator()(const Particle& p1) const 
+  Simulation::SpeciesContainer::findSpecies(const Particle& p1) const 
   {
     for (const shared_ptr<Species>& ptr : *this)
       if (ptr->isSpecies(p1)) return ptr;
@@ -328,31 +561,27 @@ namespace dynamo
     using namespace magnet::xml;
     Document doc;
     
-    namespace io = boost::iostreams;
-    
-    dout << "Reading the XML input file, " << fileName << ", into memory" << std::endl;
+    dout << "Reading the XML input file, " << fileName << std::endl;
     if (!boost::filesystem::exists(fileName))
       M_throw() << "Could not find the XML file named " << fileName
 		<< "\nPlease check the file exists.";
-    { //This scopes out the file objects
-      
-      //We use the boost iostreams library to load the file into a
-      //string which may be compressed.
-      
-      //We make our filtering iostream
-      io::filtering_istream inputFile;
-      
-      //Now check if we should add a decompressor filter
-      if (std::string(fileName.end()-8, fileName.end()) == ".xml.bz2")
-	inputFile.push(io::bzip2_decompressor());
-      else if (!(std::string(fileName.end()-4, fileName.end()) == ".xml"))
-	M_throw() << "Unrecognized extension for xml file";
-
-      //Finally, add the file as a source
-      inputFile.push(io::file_source(fileName));
-	  
-      io::copy(inputFile, io::back_inserter(doc.getStoredXMLData()));
-    }
+
+    //Binary configuration files are memory mapped, only their XML
+    //metadata is parsed
+    std::unique_ptr<BinaryConfigReader> binaryConfig;
+    //The particle data of XML configuration files is parsed as the
+    //file is decompressed, only the metadata is loaded into the DOM
+    std::unique_ptr<StreamingConfigReader> streamConfig;
+    if (isBinaryConfigFile(fileName))
+      {
+	binaryConfig.reset(new BinaryConfigReader(fileName));
+	doc.getStoredXMLData() = binaryConfig->getXMLData();
+      }
+    else
+      {
+	streamConfig.reset(new StreamingConfigReader(fileName));
+	doc.getStoredXMLData().swap(streamConfig->getXMLData());
+      }
 
     dout << "Parsing the XML" << std::endl;
     try {
@@ -386,6 +615,18 @@ namespace dynamo
 
     _properties << mainNode;
 
+    if (binaryConfig)
+      {
+	const Node particleData = mainNode.getNode("ParticleData");
+	_properties.loadParticleData([&](const std::string& name)
+				     { return binaryConfig->getFloat64Array(particleData, "PropertyArray", name, 1); },
+				     particleData.getAttribute("N").as<size_t>());
+      }
+    else
+      _properties.loadParticleData([&](const std::string& name)
+				   { return streamConfig->getFloat64Array(name, 1); },
+				   streamConfig->getParticles().size());
+
     //Load the Primary cell's size
     primaryCellSize << simNode.getNode("SimulationSize");
     primaryCellSize /= units.unitLength();
@@ -399,7 +640,13 @@ namespace dynamo
     
     BCs = BoundaryCondition::getClass(simNode.getNode("BC"), this);
     dynamics = Dynamics::getClass(simNode.getNode("Dynamics"), this);
-    dynamics->loadParticleXMLData(mainNode);
+    if (binaryConfig)
+      dynamics->loadParticleBinaryData(*binaryConfig, mainNode.getNode("ParticleData"));
+    else
+      {
+	dynamics->loadParticleStreamData(*streamConfig, mainNode.getNode("ParticleData"));
+	streamConfig.reset();
+      }
 
     if (simNode.hasNode("Topology"))
       {
@@ -448,19 +695,10 @@ namespace dynamo
   }
 
   void
-  Simulation::writeXMLfile(std::string fileName, bool applyBC, bool round)
+  Simulation::writeXMLfile(std::string fileName, bool applyBC, bool round, bool async)
   {
-    namespace io = boost::iostreams;
-    io::filtering_ostream coutputFile;
-
-    if (std::string(fileName.end()-4, fileName.end()) == ".bz2")
-      coutputFile.push(io::bzip2_compressor());
-  
-    coutputFile.push(io::file_sink(fileName));
-  
     namespace xml = magnet::xml;
-    xml::XmlStream XML(coutputFile);
-    XML.setFormatXML(true);
+    namespace io = boost::iostreams;
 
     dynamics->updateAllParticles();
 
@@ -468,12 +706,128 @@ namespace dynamo
     _properties.rescaleUnit(Property::Units::L, 1.0 / units.unitLength());
     _properties.rescaleUnit(Property::Units::T, 1.0 / units.unitTime());
     _properties.rescaleUnit(Property::Units::M, 1.0 / units.unitMass());
+
+    const int precision = std::numeric_limits<double>::digits10 + 2 - 4 * round;
     
-    XML << std::setprecision(std::numeric_limits<double>::digits10 + 2 - 4 * round)
-	<< xml::prolog()
-	<< xml::tag("DynamOconfig")
-	<< xml::attr("version") << configFileVersion
-	<< xml::tag("Simulation");
+    if (isBinaryConfigFile(fileName))
+      {
+	//The particle data is stored as raw arrays, so rounding only
+	//applies to the XML metadata.
+	shared_ptr<const BinaryConfigWriter> writer(new BinaryConfigWriter(dynamics->getParticleSnapshot(applyBC)));
+
+	std::ostringstream os;
+	{
+	  xml::XmlStream XML(os);
+	  XML.setFormatXML(true);
+	  XML << std::setprecision(precision)
+	      << xml::prolog()
+	      << xml::tag("DynamOconfig")
+	      << xml::attr("version") << configFileVersion;
+	  outputConfigXML(XML);
+	  writer->outputXML(XML);
+	  XML << xml::endtag("DynamOconfig");
+	}
+	const std::string xmlData = os.str();
+
+	if (async)
+	  {
+	    if (!_backgroundWriter)
+	      _backgroundWriter.reset(new magnet::thread::BackgroundWorker);
+
+	    _backgroundWriter->queueTask(std::function<void()>([=]()
+	      {
+		writeViaPartFile(fileName, [&](const std::string& partName)
+				 { writer->write(partName, xmlData); });
+	      }));
+	  }
+	else
+	  {
+	    writer->write(fileName, xmlData);
+	    dout << "Config written to " << fileName << std::endl;
+	  }
+      }
+    else if (async)
+      {
+	//Only the small Simulation/Property header is formatted here,
+	//the particle data is copied and formatted on the background
+	//thread.
+	std::ostringstream os;
+	std::string header;
+	{
+	  xml::XmlStream XML(os);
+	  XML.setFormatXML(true);
+	  XML << std::setprecision(precision)
+	      << xml::tag("DynamOconfig")
+	      << xml::attr("version") << configFileVersion
+	      << xml::chardata();
+	  //Discard the opening tag (the background thread writes it),
+	  //but keep the stream state so the header is indented correctly
+	  os.str("");
+	  outputConfigXML(XML);
+	  header = os.str();
+	}
+	
+	shared_ptr<Dynamics::ParticleSnapshot> snapshot = dynamics->getParticleSnapshot(applyBC);
+
+	if (!_backgroundWriter)
+	  _backgroundWriter.reset(new magnet::thread::BackgroundWorker);
+	
+	_backgroundWriter->queueTask(std::function<void()>([=]()
+	  {
+	    writeViaPartFile(fileName, [&](const std::string& partName)
+	      {
+		writeTextFile(partName, fileName, [&](std::ostream& os)
+		  {
+		    xml::XmlStream XML(os);
+		    XML.setFormatXML(true);
+		    XML << std::setprecision(precision)
+			<< xml::prolog()
+			<< xml::tag("DynamOconfig")
+			<< xml::attr("version") << configFileVersion
+			<< xml::chardata()
+			<< header;
+		    snapshot->outputXML(XML);
+		    XML << xml::endtag("DynamOconfig");
+		  });
+	      });
+	  }));
+      }
+    else
+      {
+	io::filtering_ostream coutputFile;
+
+	if (std::string(fileName.end()-4, fileName.end()) == ".bz2")
+	  coutputFile.push(io::bzip2_compressor());
+	
+	coutputFile.push(io::file_sink(fileName));
+	
+	xml::XmlStream XML(coutputFile);
+	XML.setFormatXML(true);
+	
+	XML << std::setprecision(precision)
+	    << xml::prolog()
+	    << xml::tag("DynamOconfig")
+	    << xml::attr("version") << configFileVersion;
+
+	outputConfigXML(XML);
+	dynamics->outputParticleXMLData(XML, applyBC);
+
+	XML << xml::endtag("DynamOconfig");
+
+	dout << "Config written to " << fileName << std::endl;
+      }
+
+    //Rescale the properties back to the simulation units
+    _properties.rescaleUnit(Property::Units::L, units.unitLength());
+    _properties.rescaleUnit(Property::Units::T, units.unitTime());
+    _properties.rescaleUnit(Property::Units::M, units.unitMass());
+  }
+
+  void
+  Simulation::outputConfigXML(magnet::xml::XmlStream& XML)
+  {
+    namespace xml = magnet::xml;
+    XML << xml::tag("Simulation");
     
     //Allow this block to fail if need be
     if (getOutputPlugin<OPMisc>())
@@ -482,7 +836,7 @@ namespace dynamo
 	if (!std::isinf(mft) && !std::isnan(mft))
 	  XML << xml::attr("lastMFT") << mft;
 	else
-	  XML << xml::attr("lastMFT") << lastRunMFT;
+	  XML << xml::attr("lastMFT") << lastRunMFT / units.unitTime();
       }
 
     XML << xml::tag("Scheduler")
@@ -541,17 +895,13 @@ namespace dynamo
 	<< xml::endtag("Dynamics")
 	<< xml::endtag("Simulation")
 	<< _properties;
+  }
 
-    dynamics->outputParticleXMLData(XML, applyBC);
-
-    XML << xml::endtag("DynamOconfig");
-
-    dout << "Config written to " << fileName << std::endl;
-
-    //Rescale the properties back to the simulation units
-    _properties.rescaleUnit(Property::Units::L, units.unitLength());
-    _properties.rescaleUnit(Property::Units::T, units.unitTime());
-    _properties.rescaleUnit(Property::Units::M, units.unitMass());
+  void
+  Simulation::waitForBackgroundWrites()
+  {
+    if (_backgroundWriter)
+      _backgroundWriter->wait();
   }
   
   void 
@@ -615,6 +965,70 @@ namespace dynamo
     return intECurrent;
   }
 
+  void
+  Simulation::reorderParticles(const std::vector<size_t>& order)
+  {
+    if (order.size() != N())
+      M_throw() << "The reordering has " << order.size() 
+		<< " entries, but there are " << N() << " particles";
+
+    dynamics->updateAllParticles();
+
+    std::vector<Particle> reordered;
+    reordered.reserve(N());
+    for (size_t ID(0); ID < N(); ++ID)
+      {
+	const Particle& part = particles[order[ID]];
+#ifdef DYNAMO_DEBUG
+	if (species(part) != species(particles[ID]))
+	  M_throw() << "Reordering particle " << part.getID() << " to ID " << ID 
+		    << " would change its Species";
+#endif
+	reordered.push_back(Particle(part.getPosition(), part.getVelocity(), ID));
+	if (!part.testState(Particle::DYNAMIC))
+	  reordered.back().clearState(Particle::DYNAMIC);
+	if (!part.testState(Particle::ALIVE))
+	  reordered.back().clearState(Particle::ALIVE);
+      }
+    particles.swap(reordered);
+
+    //Track the original IDs of the particles
+    if (_externalIDs.empty())
+      for (size_t ID(0); ID < N(); ++ID)
+	_externalIDs.push_back(ID);
+
+    reorderParticleData(_externalIDs, order);
+    _internalIDs.resize(N());
+    for (size_t ID(0); ID < N(); ++ID)
+      _internalIDs[_externalIDs[ID]] = ID;
+
+    //Permute the per-particle data
+    reorderParticleData(_particleClass, order);
+    _properties.particlesReordered(order);
+    dynamics->particlesReordered(order);
+    for (shared_ptr<Interaction>& interaction : interactions)
+      interaction->particlesReordered(order);
+    for (shared_ptr<OutputPlugin>& plugin : outputPlugins)
+      plugin->particlesReordered(order);
+    species.buildCache(particles);
+
+    //Rebuild the neighbour lists, the neighbour list used by the
+    //scheduler will also rebuild the event list
+    bool eventsRebuilt = false;
+    for (shared_ptr<Global>& glob : globals)
+      {
+	shared_ptr<GNeighbourList> nblist = std::dynamic_pointer_cast<GNeighbourList>(glob);
+	if (nblist)
+	  {
+	    nblist->reinitialise();
+	    eventsRebuilt |= nblist->usedInScheduler();
+	  }
+      }
+
+    if (!eventsRebuilt)
+      ptrScheduler->rebuildList();
+  }
+
   void 
   Simulation::setCOMVelocity(const Vector COMVelocity)
   {  
@@ -686,14 +1100,11 @@ namespace dynamo
     dynamics->updateAllParticles();
 
     size_t errors = 0;
-    std::vector<Particle>::const_iterator iPtr1, iPtr2;
   
     for (const shared_ptr<Interaction>& interaction_ptr : interactions)
       errors += interaction_ptr->validateState();
 
-    for (iPtr1 = particles.begin(); iPtr1 != particles.end(); ++iPtr1)
-      for (iPtr2 = iPtr1 + 1; iPtr2 != particles.end(); ++iPtr2)
-	errors += getInteraction(*iPtr1, *iPtr2)->validateState(*iPtr1, *iPtr2);
+    errors += validatePairStates();
 
     for (const Particle& part : particles)
       for (const shared_ptr<Local>& lcl : locals)
@@ -703,40 +1114,157 @@ namespace dynamo
     return errors;
   }
 
+  size_t
+  Simulation::validatePairStates(size_t max_reports) const
+  {
+    bool concurrent = dynamics->concurrentEvents() && BCs->concurrentEvents();
+    for (const shared_ptr<Interaction>& interaction_ptr : interactions)
+      concurrent = concurrent && interaction_ptr->concurrentEvents();
+
+    //Pairs outside of their interaction distance cannot be in an
+    //invalid state (captured pairs are checked by
+    //ICapture::validateState). The invalid pairs are collected
+    //silently first, then reported in order.
+    std::vector<std::vector<std::pair<size_t, size_t> > > invalid(getPairBlockCount());
+    forEachPair(getLongestInteraction(), concurrent,
+		[&](size_t block, const Particle& p1, const Particle& p2)
+		{
+		  if (getInteraction(p1, p2)->validateState(p1, p2, false))
+		    invalid[block].push_back(std::make_pair(p1.getID(), p2.getID()));
+		});
+
+    size_t errors = 0;
+    for (const auto& pairs : invalid)
+      for (const auto& pair : pairs)
+	{
+	  const Particle& p1 = particles[pair.first];
+	  const Particle& p2 = particles[pair.second];
+	  getInteraction(p1, p2)->validateState(p1, p2, errors < max_reports);
+	  ++errors;
+	}
+
+    return errors;
+  }
+
+  size_t
+  Simulation::getPairBlockCount() const
+  {
+    if (threadPool && threadPool->getThreadCount())
+      return std::max(size_t(1), std::min(N(), 4 * threadPool->getThreadCount()));
+    return 1;
+  }
+
   void
-  Simulation::outputData(std::string filename)
+  Simulation::forEachPair(double maxdist, bool concurrent, const std::function<void(size_t, const Particle&, const Particle&)>& func) const
+  {
+    //Find a neighbour list which can supply all of the pairs
+    const GNeighbourList* nblist = NULL;
+    if (status >= GLOBAL_INIT)
+      for (const shared_ptr<Global>& glob : globals)
+	{
+	  const GNeighbourList* ptr = dynamic_cast<const GNeighbourList*>(glob.get());
+	  if (ptr && (ptr->getMaxSupportedInteractionLength() >= maxdist)
+	      && (ptr->getRange()->size() == N()))
+	    {
+	      nblist = ptr;
+	      break;
+	    }
+	}
+
+    const size_t blocks = getPairBlockCount();
+    const size_t blockSize = (N() + blocks - 1) / blocks;
+    auto processBlock = [=, &func](size_t block)
+      {
+	std::vector<size_t> neighbours;
+	const size_t end = std::min(N(), (block + 1) * blockSize);
+	for (size_t ID1(block * blockSize); ID1 < end; ++ID1)
+	  if (nblist)
+	    {
+	      neighbours.clear();
+	      nblist->getParticleNeighbours(particles[ID1], neighbours);
+	      //Visit the neighbours in order and only once, even if the
+	      //neighbour list wraps around a small periodic system
+	      std::sort(neighbours.begin(), neighbours.end());
+	      neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+	      for (const size_t ID2 : neighbours)
+		if (ID2 > ID1)
+		  func(block, particles[ID1], particles[ID2]);
+	    }
+	  else
+	    for (size_t ID2(ID1 + 1); ID2 < N(); ++ID2)
+	      func(block, particles[ID1], particles[ID2]);
+      };
+
+    if (concurrent && threadPool && threadPool->getThreadCount())
+      {
+	for (size_t block(0); block < blocks; ++block)
+	  threadPool->queueTask(std::function<void()>(std::bind(processBlock, block)));
+	threadPool->wait();
+      }
+    else
+      for (size_t block(0); block < blocks; ++block)
+	processBlock(block);
+  }
+
+  void
+  Simulation::outputData(std::string filename, bool async)
   {
     if (status < INITIALISED)
       M_throw() << "Cannot output data when not initialised!";
 
     namespace io = boost::iostreams;
+    namespace xml = magnet::xml;
+
+    //The output plugins must be formatted here, but in asynchronous
+    //mode the compression and writing is left to the background
+    //thread.
+    std::ostringstream buffer;
     io::filtering_ostream coutputFile;
-  
-    if (std::string(filename.end()-4, filename.end()) == ".bz2")
-      coutputFile.push(io::bzip2_compressor());
-  
-    coutputFile.push(io::file_sink(filename));
+    if (!async)
+      {
+	if (std::string(filename.end()-4, filename.end()) == ".bz2")
+	  coutputFile.push(io::bzip2_compressor());
+	
+	coutputFile.push(io::file_sink(filename));
+      }
     
-    namespace xml = magnet::xml;
-    xml::XmlStream XML(coutputFile);
-    XML.setFormatXML(true);
+    {
+      xml::XmlStream XML(async ? static_cast<std::ostream&>(buffer) : coutputFile);
+      XML.setFormatXML(true);
     
-    XML << std::setprecision(std::numeric_limits<double>::digits10 + 2)
-	<< xml::prolog() << xml::tag("OutputData");
+      XML << std::setprecision(std::numeric_limits<double>::digits10 + 2)
+	  << xml::prolog() << xml::tag("OutputData");
   
-    //Output the data and delete the outputplugins
-    for (shared_ptr<OutputPlugin> & Ptr : outputPlugins)
-      Ptr->output(XML);
+      //Output the data and delete the outputplugins
+      for (shared_ptr<OutputPlugin> & Ptr : outputPlugins)
+	Ptr->output(XML);
   
-    for (shared_ptr<Interaction> & Ptr : interactions)
-      Ptr->outputData(XML);
+      for (shared_ptr<Interaction> & Ptr : interactions)
+	Ptr->outputData(XML);
 
-    for (shared_ptr<Local> & Ptr : locals)
-      Ptr->outputData(XML);
+      for (shared_ptr<Local> & Ptr : locals)
+	Ptr->outputData(XML);
 
-    XML << xml::endtag("OutputData");
+      XML << xml::endtag("OutputData");
+    }
 
-    dout << "Output written to " << filename << std::endl;
+    if (!async)
+      {
+	dout << "Output written to " << filename << std::endl;
+	return;
+      }
+
+    shared_ptr<std::string> data(new std::string(buffer.str()));
+    if (!_backgroundWriter)
+      _backgroundWriter.reset(new magnet::thread::BackgroundWorker);
+    
+    _backgroundWriter->queueTask(std::function<void()>([=]()
+      {
+	writeViaPartFile(filename, [&](const std::string& partName)
+	  {
+	    writeTextFile(partName, filename, [&](std::ostream& os) { os << *data; });
+	  });
+      }));
   }
 
   void 
@@ -23,8 +23,13 @@
 #include <dynamo/units/units.hpp>
 #include <magnet/function/delegate.hpp>
 #include <random>
+#include <functional>
+#include <limits>
+#include <cstdint>
 #include <vector>
 
+namespace magnet { namespace thread { class ThreadPool; class BackgroundWorker; } }
+
 namespace dynamo
 {  
   class Scheduler;
@@ -113,10 +118,49 @@ namespace dynamo
     };
 
     /*! \brief A class which allows easy selection of Species.
+
+      The index of the Species of each particle is cached when the
+      Simulation is initialised, so looking up the Species of a
+      particle is a single indexed load. The cache is dropped when
+      Species are added or removed, and is not used if the number of
+      particles no longer matches it.
     */
     struct SpeciesContainer: public Container<Species>
     {
-      const shared_ptr<Species>& operator()(const Particle&) const;
+      SpeciesContainer(): _particles(NULL) {}
+
+      inline const shared_ptr<Species>& operator()(const Particle& p) const
+      {
+	//Fall back to a search if the cache is not valid
+	if (_particles && (_particleSpecies.size() == _particles->size())
+	    && (p.getID() < _particleSpecies.size()))
+	  return Base::operator[](_particleSpecies[p.getID()]);
+	return findSpecies(p);
+      }
+
+      /*! \brief Rebuilds the cache of the Species of each particle.
+
+	Throws if a particle does not belong to exactly one Species.
+       */
+      void buildCache(const std::vector<Particle>&);
+
+      //! \brief Drops the cache, until buildCache() is called again.
+      void invalidateCache() { _particleSpecies.clear(); _particles = NULL; }
+
+      void push_back(const shared_ptr<Species>& sp)
+      { invalidateCache(); Base::push_back(sp); }
+
+      void clear()
+      { invalidateCache(); Base::clear(); }
+
+      Base::iterator erase(Base::iterator it)
+      { invalidateCache(); return Base::erase(it); }
+
+    private:
+      const shared_ptr<Species>& findSpecies(const Particle&) const;
+
+      std::vector<uint32_t> _particleSpecies;
+      const std::vector<Particle>* _particles;
     };
 
   public:
@@ -216,6 +260,35 @@ namespace dynamo
     */
     size_t checkSystem();
 
+    /*! \brief Validates the state of every pair of particles which
+        may be interacting, returning the number of invalid pairs.
+
+	Only the first \a max_reports invalid pairs are reported.
+
+	\sa forEachPair
+     */
+    size_t validatePairStates(size_t max_reports = std::numeric_limits<size_t>::max()) const;
+
+    /*! \brief Calls a function for each pair of particles (with
+        ID1 < ID2) which may be within a distance \a maxdist.
+
+	If a GNeighbourList which covers every particle and supports
+	this distance has been initialised, it is used to find the
+	pairs in O(N) time. Otherwise every pair of particles is
+	visited.
+
+	The particles are split into getPairBlockCount() blocks of
+	consecutive IDs, and the index of the block of the first
+	particle is passed to \a func. This allows results to be
+	collected per block without any locking. If \a concurrent is
+	set, the blocks are processed in parallel on the \ref
+	threadPool, so \a func must be thread safe.
+     */
+    void forEachPair(double maxdist, bool concurrent, const std::function<void(size_t, const Particle&, const Particle&)>& func) const;
+
+    //! \brief The number of blocks forEachPair splits the particles into.
+    size_t getPairBlockCount() const;
+
     void addSystemTicker();
     
     double getSimVolume() const;
@@ -255,14 +328,20 @@ namespace dynamo
       will either be created or overwritten). The filename must end in
       either ".xml" for uncompressed xml files or ".bz2" for bzip2
       compressed configuration files.
+
+      \param async If true, the XML is compressed and written to disk
+      on a background thread (see writeXMLfile).
     */
-    void outputData(std::string filename = "output.xml.bz2");
+    void outputData(std::string filename = "output.xml.bz2", bool async = false);
 
     /*! \brief Loads a Simulation from the passed XML file.
 
       \param filename The path to the XML file to load. The filename
-     must end in either ".xml" for uncompressed xml files or ".bz2"
-     for bzip2 compressed configuration files.
+     must end in either ".xml" for uncompressed xml files, ".bz2"
+     for bzip2 compressed configuration files, or ".dbin" for binary
+     configuration files (see BinaryConfigReader). The particle data
+     of XML files is parsed as the file is read, without holding the
+     whole file in memory (see StreamingConfigReader).
     */
     void loadXMLfile(std::string filename);
     
@@ -270,15 +349,28 @@ namespace dynamo
 
       \param filename The path to the XML file to write (this file
       will either be created or overwritten). The filename must end in
-      either ".xml" for uncompressed xml files or ".bz2" for bzip2
-      compressed configuration files.
+      either ".xml" for uncompressed xml files, ".bz2" for bzip2
+      compressed configuration files, or ".dbin" for binary
+      configuration files (see BinaryConfigWriter).
 
       \param round If true, the data in the XML file will be written
       out at 2 s.f. lower precision to round all the values. This is
       used in the test harness to remove rounding error ready for a
       comparison to a "correct" configuration file.
+
+      \param async If true, only a copy of the particle data is taken
+      here, and the XML formatting, compression and writing are
+      carried out on a background thread while the simulation
+      continues. The file is written under a temporary name and
+      renamed once complete. If the previous background write has
+      not finished, this call waits until it has.
+    */
+    void writeXMLfile(std::string filename, bool applyBC = true, bool round = false, bool async = false);
+
+    /*! \brief Wait until all background writes started by
+      writeXMLfile or outputData have completed.
     */
-    void writeXMLfile(std::string filename, bool applyBC = true, bool round = false);
+    void waitForBackgroundWrites();
 
     /*! \brief The Ensemble of the Simulation. */
     shared_ptr<Ensemble> ensemble;
@@ -388,6 +480,16 @@ namespace dynamo
      */
     size_t replexExchangeNumber;
 
+    /*! \brief A ThreadPool which may be used to parallelise the
+        expensive setup stages of the Simulation (e.g., the building
+        of the event list).
+
+      This is NULL if the Simulation must run serially, e.g., when
+      the Simulation is itself being run in a ThreadPool by the
+      EReplicaExchangeSimulation engine.
+     */
+    magnet::thread::ThreadPool* threadPool;
+
     /*! \brief The current phase of the Simulation.
      */
     ESimulationStatus status;
@@ -395,6 +497,37 @@ namespace dynamo
     Units units;    
 
     void replexerSwap(Simulation&);
+
+    /*! \brief Reorders the storage of the Particle's.
+
+      After the call, the particle with ID i is the particle which
+      previously had the ID order[i]. The particle data, the
+      per-particle Property's, the orientation data and any
+      per-particle data of the Interaction's and OutputPlugin's are
+      permuted to match, then the neighbour lists and Scheduler are
+      rebuilt.
+
+      The caller must only exchange particles which have identical
+      membership of every IDRange in the Simulation, as the ranges
+      are defined by the particle IDs.
+
+      The original ID of each particle is tracked so that
+      configuration files and other output report the original IDs
+      (see \ref getExternalID()).
+     */
+    void reorderParticles(const std::vector<size_t>& order);
+
+    /*! \brief Returns the original ID of the particle with the
+        passed ID (before any \ref reorderParticles()).
+     */
+    size_t getExternalID(size_t ID) const
+    { return _externalIDs.empty() ? ID : _externalIDs[ID]; }
+
+    /*! \brief Returns the current ID of the particle with the passed
+        original ID.
+     */
+    size_t getInternalID(size_t externalID) const
+    { return _internalIDs.empty() ? externalID : _internalIDs[externalID]; }
     
     /*! \brief Signal on particle changes.
       
@@ -407,6 +540,54 @@ namespace dynamo
 
   private:
     size_t _nextPrint;
+
+    /*! \brief The thread carrying out the asynchronous writes of
+        writeXMLfile and outputData. 
+
+	This is created on the first asynchronous write.
+     */
+    shared_ptr<magnet::thread::BackgroundWorker> _backgroundWriter;
+
+    /*! \brief Writes the Simulation and Property tags of the
+        configuration file.
+     */
+    void outputConfigXML(magnet::xml::XmlStream& XML);
+
+    /*! \brief Builds the particle class lookup table used to
+        accelerate getInteraction().
+
+	Particles are grouped into classes which have identical
+	membership of every IDRange used by the Interaction
+	IDPairRanges. For each pair of classes, the first Interaction
+	whose IDPairRange is determined by IDRange membership alone is
+	stored. Interactions with ID specific IDPairRanges (e.g.,
+	chains) cannot be tabulated, these are tested in order before
+	the tabulated Interaction is returned.
+     */
+    void buildInteractionTable();
+
+    /*! \brief Checks that every pairing of particles has an
+        Interaction.
+
+	Using the interaction table, only the pairings of particle
+	classes without a tabulated Interaction have to be tested pair
+	by pair.
+     */
+    void checkPairInteractions() const;
+
+    //! \brief The class of each particle for the interaction table.
+    std::vector<size_t> _particleClass;
+    //! \brief The number of particle classes.
+    size_t _classCount;
+    //! \brief The first class-based Interaction for each pair of classes.
+    std::vector<size_t> _interactionTable;
+    //! \brief The IDs of the Interactions which cannot be tabulated.
+    std::vector<size_t> _idSpecificInteractions;
+
+    //! \brief The original ID of each particle, empty if unordered.
+    std::vector<size_t> _externalIDs;
+    //! \brief The current ID of each original particle ID.
+    std::vector<size_t> _internalIDs;
   };
 
 }
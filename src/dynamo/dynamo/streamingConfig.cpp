@@ -0,0 +1,486 @@
+/*  dynamo:- Event driven molecular dynamics simulator 
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <dynamo/streamingConfig.hpp>
+#include <magnet/exception.hpp>
+#include <boost/iostreams/device/file.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/iostreams/filter/bzip2.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+namespace dynamo {
+  namespace {
+    inline bool isSpace(const char c)
+    { return (c == ' ') || (c == '\t') || (c == '\n') || (c == '\r'); }
+
+    inline bool startsWith(const char* begin, const char* end, const char* str)
+    {
+      const size_t length = std::strlen(str);
+      return (size_t(end - begin) >= length) && !std::strncmp(begin, str, length);
+    }
+
+    /*! \brief Skips whitespace and comments, returning the start of
+        the next tag or NULL if more data is needed.
+     */
+    const char* skipMisc(const char* p, const char* end)
+    {
+      for (;;)
+	{
+	  while ((p != end) && isSpace(*p)) ++p;
+
+	  //Not enough data to tell if this is a comment
+	  if (size_t(end - p) < 4) return NULL;
+
+	  if (*p != '<')
+	    M_throw() << "Unexpected text in the ParticleData tag:\n" << std::string(p, std::min(p + 80, end));
+
+	  if (!startsWith(p, end, "<!--")) return p;
+
+	  const char* commentEnd = "-->";
+	  p = std::search(p + 4, end, commentEnd, commentEnd + 3);
+	  if (p == end) return NULL;
+	  p += 3;
+	}
+    }
+  }
+
+  struct StreamingConfigReader::Tag
+  {
+    struct Attribute
+    {
+      const char* name;
+      size_t nameLength;
+      const char* value;
+      size_t valueLength;
+
+      bool is(const char* str) const
+      { return (std::strlen(str) == nameLength) && !std::strncmp(name, str, nameLength); }
+
+      //! \brief Parses the value as a double, returning false if it is not a number.
+      bool toDouble(double& result) const
+      {
+	char* valueEnd;
+	result = std::strtod(value, &valueEnd);
+	return valueLength && (valueEnd == value + valueLength);
+      }
+
+      std::string describe() const
+      { return std::string(name, nameLength) + "=\"" + std::string(value, valueLength) + "\""; }
+
+      double asDouble() const
+      {
+	double result;
+	if (!toDouble(result))
+	  M_throw() << "Failed to parse the value of the attribute " << describe();
+	return result;
+      }
+    };
+
+    const char* name;
+    size_t nameLength;
+    //! \brief Set for an end tag (</name>).
+    bool closing;
+    //! \brief Set for an empty element tag (<name/>).
+    bool empty;
+    std::vector<Attribute> attributes;
+
+    bool is(const char* str) const
+    { return (std::strlen(str) == nameLength) && !std::strncmp(name, str, nameLength); }
+
+    const Attribute* getAttribute(const char* str) const
+    {
+      for (const Attribute& attr : attributes)
+	if (attr.is(str)) return &attr;
+      return NULL;
+    }
+
+    /*! \brief Loads the x, y, z (or 0, 1, 2) attributes of the tag,
+        followed by w if four components are requested.
+     */
+    void getVector(double* values, const size_t components, const size_t ID) const
+    {
+      for (size_t iDim(0); iDim < components; ++iDim)
+	{
+	  char attrName[2] = "x";
+	  attrName[0] = (iDim < NDIM) ? 'x' + iDim : 'w';
+	  const Attribute* attr = getAttribute(attrName);
+	  if (!attr && (iDim < NDIM))
+	    {
+	      attrName[0] = '0' + iDim;
+	      attr = getAttribute(attrName);
+	    }
+
+	  if (!attr)
+	    M_throw() << "The " << std::string(name, nameLength) << " tag of particle " << ID 
+		      << " is missing the " << attrName << " attribute";
+	  values[iDim] = attr->asDouble();
+	}
+    }
+
+    /*! \brief Parses the tag starting at p, returning the end of the
+        tag or NULL if more data is needed.
+     */
+    const char* parse(const char* p, const char* end)
+    {
+      const char* const start = p;
+      ++p;
+      closing = (p != end) && (*p == '/');
+      if (closing) ++p;
+
+      name = p;
+      while ((p != end) && !isSpace(*p) && (*p != '/') && (*p != '>')) ++p;
+      if (p == end) return NULL;
+      nameLength = p - name;
+
+      empty = false;
+      attributes.clear();
+      for (;;)
+	{
+	  while ((p != end) && isSpace(*p)) ++p;
+	  if (p == end) return NULL;
+	  
+	  if (*p == '>') return p + 1;
+
+	  if (*p == '/')
+	    {
+	      if (p + 1 == end) return NULL;
+	      if (p[1] != '>' || closing) break;
+	      empty = true;
+	      return p + 2;
+	    }
+
+	  if (closing) break;
+
+	  Attribute attr;
+	  attr.name = p;
+	  while ((p != end) && !isSpace(*p) && (*p != '=') && (*p != '/') && (*p != '>')) ++p;
+	  attr.nameLength = p - attr.name;
+	  while ((p != end) && isSpace(*p)) ++p;
+	  if (p == end) return NULL;
+	  if ((*p != '=') || !attr.nameLength) break;
+	  ++p;
+	  while ((p != end) && isSpace(*p)) ++p;
+	  if (p == end) return NULL;
+	  const char quote = *p;
+	  if ((quote != '"') && (quote != '\'')) break;
+	  attr.value = ++p;
+	  p = std::find(p, end, quote);
+	  if (p == end) return NULL;
+	  attr.valueLength = p - attr.value;
+	  ++p;
+	  attributes.push_back(attr);
+	}
+
+      M_throw() << "Malformed tag in the ParticleData section:\n" << std::string(start, std::min(start + 80, end));
+    }
+  };
+
+  StreamingConfigReader::StreamingConfigReader(const std::string& fileName, const size_t blockSize):
+    _N(0),
+    _outOfSequence(false)
+  {
+    namespace io = boost::iostreams;
+    io::filtering_istream inputFile;
+    
+    if (std::string(fileName.end()-8, fileName.end()) == ".xml.bz2")
+      inputFile.push(io::bzip2_decompressor());
+    else if (!(std::string(fileName.end()-4, fileName.end()) == ".xml"))
+      M_throw() << "Unrecognized extension for config file (expected .xml, .xml.bz2 or .dbin)";
+
+    inputFile.push(io::file_source(fileName));
+
+    //The unparsed data is held in buffer[begin, end)
+    std::vector<char> buffer(blockSize);
+    size_t begin = 0, end = 0;
+    bool eof = false;
+
+    //Moves the unparsed data to the start of the buffer and reads
+    //another block, returning false at the end of the file
+    auto refill = [&]() -> bool
+      {
+	if (eof) return false;
+
+	std::copy(buffer.begin() + begin, buffer.begin() + end, buffer.begin());
+	end -= begin;
+	begin = 0;
+
+	//A single tag may be larger than the buffer
+	if (buffer.size() - end <= blockSize / 2)
+	  buffer.resize(buffer.size() + blockSize);
+
+	inputFile.read(&buffer[end], buffer.size() - end);
+	if (inputFile.bad())
+	  M_throw() << "Failed while reading the config file " << fileName;
+	const size_t read = inputFile.gcount();
+	end += read;
+	eof = !read;
+	return read;
+      };
+
+    const std::string startTag("<ParticleData");
+    std::vector<Tag> tags(1);
+    bool inParticleData = false;
+    refill();
+    for (;;)
+      {
+	const char* const data = buffer.data();
+	const char* const stop = data + end;
+	
+	if (!inParticleData)
+	  {
+	    //Copy the metadata up to the ParticleData tag
+	    const char* p = data + begin;
+	    for (;;)
+	      {
+		p = std::search(p, stop, startTag.begin(), startTag.end());
+		if (size_t(stop - p) <= startTag.size()) break;
+		const char next = p[startTag.size()];
+		if (isSpace(next) || (next == '/') || (next == '>')) break;
+		++p;
+	      }
+
+	    if (size_t(stop - p) <= startTag.size())
+	      {
+		//Keep enough data to find a ParticleData tag split
+		//between two blocks
+		const size_t keep = std::min(end - begin, startTag.size());
+		_xmlData.append(data + begin, stop - keep);
+		begin = end - keep;
+		if (!refill())
+		  {
+		    _xmlData.append(buffer.data() + begin, buffer.data() + end);
+		    break;
+		  }
+		continue;
+	      }
+
+	    _xmlData.append(data + begin, p);
+	    begin = p - data;
+	    const char* tagEnd = tags[0].parse(p, stop);
+	    if (!tagEnd)
+	      {
+		if (!refill())
+		  M_throw() << "The config file " << fileName << " ended inside the ParticleData tag";
+		continue;
+	      }
+
+	    //The ParticleData tag is kept, but emptied
+	    if (tags[0].empty)
+	      _xmlData.append(p, tagEnd);
+	    else
+	      {
+		_xmlData.append(p, tagEnd - 1);
+		_xmlData.append("/>");
+		inParticleData = true;
+	      }
+	    begin = tagEnd - data;
+	  }
+	else
+	  {
+	    const char* p = skipMisc(data + begin, stop);
+	    const char* tagEnd = NULL;
+	    if (p && startsWith(p, stop, "</"))
+	      {
+		tagEnd = tags[0].parse(p, stop);
+		if (tagEnd && !tags[0].is("ParticleData"))
+		  M_throw() << "Unexpected end tag </" << std::string(tags[0].name, tags[0].nameLength) 
+			    << "> in the ParticleData tag";
+		inParticleData = !tagEnd;
+	      }
+	    else if (p)
+	      tagEnd = parseParticle(p, stop, tags);
+
+	    if (tagEnd)
+	      begin = tagEnd - data;
+	    else if (!refill())
+	      M_throw() << "The config file " << fileName << " ended inside the ParticleData tag";
+	  }
+      }
+
+    _N = _particles.size();
+  }
+
+  const char* 
+  StreamingConfigReader::parseParticle(const char* begin, const char* end, std::vector<Tag>& tags)
+  {
+    //The tags are parsed into the (reused) tags vector, and only
+    //loaded once the whole Pt tag is available
+    size_t nTags = 0;
+    auto nextTag = [&]() -> Tag&
+      {
+	if (nTags == tags.size()) tags.push_back(Tag());
+	return tags[nTags++];
+      };
+
+    const char* p = nextTag().parse(begin, end);
+    if (!p) return NULL;
+
+    if (!tags[0].is("Pt") || tags[0].closing)
+      M_throw() << "Unexpected tag <" << std::string(tags[0].name, tags[0].nameLength) << "> in the ParticleData tag";
+
+    if (!tags[0].empty)
+      for (;;)
+	{
+	  p = skipMisc(p, end);
+	  if (!p) return NULL;
+	  const size_t child = nTags;
+	  p = nextTag().parse(p, end);
+	  if (!p) return NULL;
+	  
+	  if (tags[child].closing)
+	    {
+	      if (!tags[child].is("Pt"))
+		M_throw() << "Unexpected end tag </" << std::string(tags[child].name, tags[child].nameLength) 
+			  << "> in a Pt tag";
+	      --nTags;
+	      break;
+	    }
+
+	  //The child tags only have attributes, so skip to their end tag
+	  if (!tags[child].empty)
+	    {
+	      p = skipMisc(p, end);
+	      if (!p) return NULL;
+	      p = nextTag().parse(p, end);
+	      if (!p) return NULL;
+	      const Tag& childEnd = tags[--nTags];
+	      if (!childEnd.closing || (childEnd.nameLength != tags[child].nameLength) 
+		  || std::strncmp(childEnd.name, tags[child].name, childEnd.nameLength))
+		M_throw() << "Unexpected content in the " << std::string(tags[child].name, tags[child].nameLength) 
+			  << " tag of a Pt tag";
+	    }
+	}
+
+    //The whole tag is available, now load the particle
+    const size_t ID = _particles.size();
+    Vector pos, vel;
+    bool hasPos = false, hasVel = false, isStatic = false;
+
+    for (const Tag::Attribute& attr : tags[0].attributes)
+      if (attr.is("ID"))
+	{
+	  char* valueEnd;
+	  if ((std::strtoull(attr.value, &valueEnd, 10) != ID) || (valueEnd != attr.value + attr.valueLength))
+	    _outOfSequence = true;
+	}
+      else if (attr.is("Static"))
+	isStatic = true;
+      else
+	{
+	  //Values which are not numbers are only an error if the
+	  //attribute is used (see getFloat64Array)
+	  double value;
+	  if (attr.toDouble(value))
+	    addValues(attr.name, attr.nameLength, ID, &value, 1);
+	  else
+	    {
+	      ParticleArray& array = getArray(attr.name, attr.nameLength, 1);
+	      if (array.error.empty())
+		{
+		  std::ostringstream os;
+		  os << "Failed to parse the value of the attribute " << attr.describe() << " of particle " << ID;
+		  array.error = os.str();
+		  std::vector<double>().swap(array.values);
+		}
+	    }
+	}
+
+    if (!tags[0].getAttribute("ID"))
+      _outOfSequence = true;
+
+    for (size_t i(1); i < nTags; ++i)
+      {
+	const Tag& child = tags[i];
+	double values[4];
+	if (child.is("P"))
+	  {
+	    child.getVector(&pos[0], NDIM, ID);
+	    hasPos = true;
+	  }
+	else if (child.is("V"))
+	  {
+	    child.getVector(&vel[0], NDIM, ID);
+	    hasVel = true;
+	  }
+	else if (child.is("O"))
+	  {
+	    child.getVector(values, NDIM, ID);
+	    addValues("O", 1, ID, values, NDIM);
+	  }
+	else if (child.is("U"))
+	  {
+	    child.getVector(values, 4, ID);
+	    addValues("U", 1, ID, values, 4);
+	  }
+      }
+
+    if (!hasPos || !hasVel)
+      M_throw() << "Particle " << ID << " is missing its position (P) or velocity (V) tag";
+
+    _particles.push_back(Particle(pos, vel, ID));
+    if (isStatic)
+      _particles.back().clearState(Particle::DYNAMIC);
+
+    return p;
+  }
+
+  StreamingConfigReader::ParticleArray&
+  StreamingConfigReader::getArray(const char* name, size_t nameLength, size_t components)
+  {
+    for (ParticleArray& array : _arrays)
+      if ((array.components == components) && (array.name.size() == nameLength)
+	  && !array.name.compare(0, nameLength, name, nameLength))
+	return array;
+
+    _arrays.push_back(ParticleArray{std::string(name, nameLength), components, std::vector<double>(), false, std::string()});
+    return _arrays.back();
+  }
+
+  void 
+  StreamingConfigReader::addValues(const char* name, size_t nameLength, size_t ID, const double* values, size_t components)
+  {
+    ParticleArray& array = getArray(name, nameLength, components);
+    if (!array.error.empty()) return;
+
+    //If a particle was missing a value, the array cannot be used
+    if (array.values.size() != ID * components)
+      {
+	array.incomplete = true;
+	array.values.resize(ID * components);
+      }
+
+    array.values.insert(array.values.end(), values, values + components);
+  }
+
+  const double* 
+  StreamingConfigReader::getFloat64Array(const std::string& name, size_t components) const
+  {
+    for (const ParticleArray& array : _arrays)
+      if ((array.name == name) && (array.components == components))
+	{
+	  if (!array.error.empty())
+	    M_throw() << array.error;
+	  return (!array.incomplete && (array.values.size() == _N * components)) 
+	    ? array.values.data() : NULL;
+	}
+
+    return NULL;
+  }
+}
@@ -0,0 +1,110 @@
+/*  dynamo:- Event driven molecular dynamics simulator 
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <dynamo/particle.hpp>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace dynamo {
+  /*! \brief Reads an XML configuration file (".xml" or ".xml.bz2")
+      without holding the whole file in memory.
+
+    The file is decompressed in blocks, and the Pt tags of the
+    ParticleData section are parsed as they arrive, straight into
+    Particle-s and arrays of their per-particle attributes. Everything
+    else (the metadata, which is small) is kept as XML text, with the
+    ParticleData tag emptied, to be parsed into a DOM as usual.
+
+    The peak memory usage is then set by the particle data itself,
+    instead of the size of the uncompressed file plus its DOM.
+
+    Per-particle attributes of the Pt tags (e.g., the values of
+    per-particle Property-s) and the orientation data (the O and U
+    tags) are made available as arrays, in the same way as
+    BinaryConfigReader. An array is only available if every particle
+    has a value for it. Attributes which are not numbers (e.g.,
+    annotations) are ignored, unless their values are requested.
+   */
+  class StreamingConfigReader
+  {
+  public:
+    /*! \brief Reads the configuration file.
+
+      \param fileName The path to the ".xml" or ".xml.bz2" file.
+      \param blockSize The amount of decompressed data to read at a
+      time.
+     */
+    StreamingConfigReader(const std::string& fileName, size_t blockSize = 1 << 20);
+
+    //! \brief The XML metadata, with the Pt tags removed.
+    std::string& getXMLData() { return _xmlData; }
+
+    /*! \brief The particles, in the order of the file, with their
+        IDs set to their position in the file and in the units of
+        the file.
+     */
+    std::vector<Particle>& getParticles() { return _particles; }
+
+    //! \brief True if the ID attributes of the Pt tags did not match their order.
+    bool particlesOutOfSequence() const { return _outOfSequence; }
+
+    /*! \brief Returns the values of a Pt attribute (components = 1),
+	the angular velocities ("O", components = 3), or the
+	orientations ("U", components = 4, stored x, y, z, w) of all
+	particles, or NULL if they are not available. Throws if the
+	values are not all numbers.
+     */
+    const double* getFloat64Array(const std::string& name, size_t components) const;
+
+  private:
+    struct ParticleArray
+    {
+      std::string name;
+      size_t components;
+      std::vector<double> values;
+      //! \brief Set if a particle was missing a value.
+      bool incomplete;
+      //! \brief Describes the first value which was not a number.
+      std::string error;
+    };
+
+    //! \brief A tag of the ParticleData section, defined in streamingConfig.cpp.
+    struct Tag;
+
+    ParticleArray& getArray(const char* name, size_t nameLength, size_t components);
+
+    /*! \brief Stores the values of an attribute or tag of the
+        particle ID in the named array.
+     */
+    void addValues(const char* name, size_t nameLength, size_t ID, const double* values, size_t components);
+
+    /*! \brief Parses a Pt tag (and its children) starting at
+        begin, returning the end of the parsed text or NULL if the
+        tag is not complete.
+     */
+    const char* parseParticle(const char* begin, const char* end, std::vector<Tag>& tags);
+
+    std::string _xmlData;
+    std::vector<Particle> _particles;
+    std::vector<ParticleArray> _arrays;
+    //! \brief The number of particles in the file.
+    size_t _N;
+    bool _outOfSequence;
+  };
+}
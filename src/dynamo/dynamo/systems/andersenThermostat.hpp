@@ -53,6 +53,11 @@ namespace dynamo {
       std::swap(setFrequency, s.setFrequency);
     }
   
+    virtual void getIDRanges(std::vector<const IDRange*>& ranges) const
+    {
+      ranges.push_back(range.get());
+    }
+
   protected:
     virtual void outputXML(magnet::xml::XmlStream&) const;
     mutable double meanFreeTime;
@@ -0,0 +1,189 @@
+/*  dynamo:- Event driven molecular dynamics simulator 
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <dynamo/systems/mortonReorder.hpp>
+#include <dynamo/systems/sleep.hpp>
+#include <dynamo/units/units.hpp>
+#include <dynamo/BC/BC.hpp>
+#include <dynamo/species/species.hpp>
+#include <dynamo/topology/topology.hpp>
+#include <dynamo/interactions/interaction.hpp>
+#include <dynamo/interactions/swsequence.hpp>
+#include <dynamo/locals/local.hpp>
+#include <dynamo/globals/global.hpp>
+#include <dynamo/dynamics/dynamics.hpp>
+#include <dynamo/schedulers/scheduler.hpp>
+#include <dynamo/outputplugins/outputplugin.hpp>
+#include <dynamo/NparticleEventData.hpp>
+#include <magnet/math/morton_number.hpp>
+#include <magnet/xmlwriter.hpp>
+#include <magnet/xmlreader.hpp>
+#include <algorithm>
+#include <map>
+
+namespace dynamo {
+  namespace {
+    /*! \brief The number of Morton cells in each dimension used to
+        sort the particles.
+     */
+    const size_t mortonGridSize = 1024;
+  }
+
+  SysMortonReorder::SysMortonReorder(const magnet::xml::Node& XML, dynamo::Simulation* tmp): 
+    System(tmp)
+  {
+    operator<<(XML);
+    type = NON_EVENT;
+  }
+
+  SysMortonReorder::SysMortonReorder(dynamo::Simulation* tmp, std::string name, double timestep):
+    System(tmp),
+    _timestep(timestep)
+  {
+    type = NON_EVENT;
+    sysName = name;
+  }
+
+  size_t
+  SysMortonReorder::getMortonNumber(Vector pos) const
+  {
+    Sim->BCs->applyBC(pos);
+
+    magnet::math::MortonNumber<3> coords;
+    for (size_t iDim(0); iDim < NDIM; ++iDim)
+      {
+	const double scaled = (pos[iDim] / Sim->primaryCellSize[iDim] + 0.5) * mortonGridSize;
+	coords[iDim] = std::min(size_t(std::max(scaled, 0.0)), mortonGridSize - 1);
+      }
+
+    return coords.getMortonNum();
+  }
+
+  void 
+  SysMortonReorder::runEvent() const
+  {
+    double locdt = dt;
+    Sim->systemTime += locdt;
+    Sim->ptrScheduler->stream(locdt);
+    Sim->stream(locdt);
+    //Does not increment the event counter, as it is not an event of
+    //the dynamics
+    Sim->dynamics->updateAllParticles();
+
+    //Sort the members of each class along the Morton curve
+    std::vector<size_t> order(Sim->N());
+    std::vector<std::pair<size_t, size_t> > keys;
+    for (const std::vector<size_t>& members : _classes)
+      {
+	keys.clear();
+	for (const size_t& ID : members)
+	  keys.push_back(std::make_pair(getMortonNumber(Sim->particles[ID].getPosition()), ID));
+
+	std::sort(keys.begin(), keys.end());
+
+	for (size_t i(0); i < members.size(); ++i)
+	  order[members[i]] = keys[i].second;
+      }
+
+    //The next event must be set before the event list is rebuilt
+    dt = _timestep;
+
+    Sim->reorderParticles(order);
+
+    for (shared_ptr<OutputPlugin>& Ptr : Sim->outputPlugins)
+      Ptr->eventUpdate(*this, NEventData(), locdt); 
+  }
+
+  void 
+  SysMortonReorder::initialise(size_t nID)
+  {
+    ID = nID;
+    dt = _timestep;
+
+    if (!Sim->topology.empty())
+      M_throw() << "The MortonReorder System cannot be used with Topology, as molecules are defined by the particle IDs";
+
+    for (const shared_ptr<System>& system : Sim->systems)
+      if (std::dynamic_pointer_cast<SSleep>(system))
+	M_throw() << "The MortonReorder System cannot be used with the Sleep System";
+
+    //Collect every IDRange in the simulation, particles with
+    //identical membership of all of them may be exchanged
+    std::vector<const IDRange*> ranges;
+    for (const shared_ptr<Species>& species : Sim->species)
+      ranges.push_back(species->getRange().get());
+    
+    for (const shared_ptr<Interaction>& interaction : Sim->interactions)
+      {
+	if (!interaction->getRange()->getIDRanges(ranges))
+	  M_throw() << "The MortonReorder System cannot be used with the Interaction \"" 
+		    << interaction->getName() << "\", as its IDPairRange depends on the particle IDs";
+
+	if (std::dynamic_pointer_cast<ISWSequence>(interaction))
+	  M_throw() << "The MortonReorder System cannot be used with the Interaction \"" 
+		    << interaction->getName() << "\", as its sequence depends on the particle IDs";
+      }
+
+    for (const shared_ptr<Local>& local : Sim->locals)
+      ranges.push_back(local->getRange().get());
+
+    for (const shared_ptr<Global>& global : Sim->globals)
+      ranges.push_back(global->getRange().get());
+
+    for (const shared_ptr<System>& system : Sim->systems)
+      system->getIDRanges(ranges);
+
+    ranges.erase(std::remove(ranges.begin(), ranges.end(), static_cast<const IDRange*>(NULL)), ranges.end());
+    std::sort(ranges.begin(), ranges.end());
+    ranges.erase(std::unique(ranges.begin(), ranges.end()), ranges.end());
+
+    _classes.clear();
+    std::map<std::vector<bool>, size_t> classIDs;
+    std::vector<bool> signature(ranges.size());
+    for (const Particle& part : Sim->particles)
+      {
+	for (size_t i(0); i < ranges.size(); ++i)
+	  signature[i] = ranges[i]->isInRange(part);
+
+	auto it = classIDs.insert(std::make_pair(signature, classIDs.size())).first;
+	if (it->second == _classes.size())
+	  _classes.push_back(std::vector<size_t>());
+	_classes[it->second].push_back(part.getID());
+      }
+
+    dout << "Morton reordering " << Sim->N() << " particles in " 
+	 << _classes.size() << " classes, every " 
+	 << _timestep / Sim->units.unitTime() << " time units" << std::endl;
+  }
+
+  void 
+  SysMortonReorder::operator<<(const magnet::xml::Node& XML)
+  {
+    _timestep = XML.getAttribute("TimeStep").as<double>() * Sim->units.unitTime();
+    sysName = XML.getAttribute("Name");
+  }
+
+  void 
+  SysMortonReorder::outputXML(magnet::xml::XmlStream& XML) const
+  {
+    XML << magnet::xml::tag("System")
+	<< magnet::xml::attr("Type") << "MortonReorder"
+	<< magnet::xml::attr("Name") << sysName
+	<< magnet::xml::attr("TimeStep") << _timestep / Sim->units.unitTime()
+	<< magnet::xml::endtag("System");
+  }
+}
@@ -0,0 +1,64 @@
+/*  dynamo:- Event driven molecular dynamics simulator 
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <dynamo/systems/system.hpp>
+#include <dynamo/simulation.hpp>
+#include <magnet/math/vector.hpp>
+#include <vector>
+
+namespace dynamo {
+  /*! \brief An event which periodically reorders the particles along
+      a Morton (Z-order) curve.
+
+      As the system evolves, particles which were stored close
+      together in \ref Simulation::particles diffuse apart, and the
+      neighbour list then gathers particles from scattered
+      locations in memory. This event sorts the particles by the
+      Morton number of their position, so that particles which are
+      close in space are also close in memory.
+
+      Particles are only exchanged with particles that have
+      identical membership of every IDRange in the Simulation, so
+      the ranges remain valid. The original particle IDs are still
+      used in the output (see Simulation::reorderParticles()).
+   */
+  class SysMortonReorder: public System
+  {
+  public:
+    SysMortonReorder(const magnet::xml::Node& XML, dynamo::Simulation*);
+    SysMortonReorder(dynamo::Simulation*, std::string name, double timestep);
+
+    virtual void runEvent() const;
+
+    virtual void initialise(size_t);
+
+    virtual void operator<<(const magnet::xml::Node&);
+
+  protected:
+    virtual void outputXML(magnet::xml::XmlStream&) const;
+
+    size_t getMortonNumber(Vector) const;
+
+    double _timestep;
+
+    /*! \brief The IDs of the particles in each class of particles
+        which may be exchanged.
+     */
+    std::vector<std::vector<size_t> > _classes;
+  };
+}
@@ -23,7 +23,10 @@
 #include <dynamo/species/species.hpp>
 #include <dynamo/NparticleEventData.hpp>
 #include <dynamo/ranges/include.hpp>
-#include <dynamo/dynamics/dynamics.hpp>
+#include <dynamo/dynamics/include.hpp>
+#include <dynamo/BC/LEBC.hpp>
+#include <dynamo/locals/oscillatingplate.hpp>
+#include <dynamo/globals/waker.hpp>
 #include <dynamo/schedulers/scheduler.hpp>
 #include <dynamo/outputplugins/outputplugin.hpp>
 #include <magnet/xmlwriter.hpp>
@@ -97,6 +100,10 @@ namespace dynamo {
 	SDat.L1partChanges.push_back(ParticleEventData(Sim->particles[partID], *species, RESCALE));
     
     Sim->dynamics->updateAllParticles();
+
+    //This must be tested before the velocities are changed
+    const bool rescaleEvents = canRescaleEventTimes();
+
     Sim->dynamics->rescaleSystemKineticEnergy(_kT / currentkT);
     
     //We must set the centre of mass velocity back to zero (assuming
@@ -111,17 +118,77 @@ namespace dynamo {
     scaleFactor += std::log(currentkT);
 
     Sim->_sigParticleUpdate(SDat);
-  
-    //Only 1ParticleEvents occur
-    for (const ParticleEventData& PDat : SDat.L1partChanges)
-      Sim->ptrScheduler->fullUpdate(Sim->particles[PDat.getParticleID()]);
+
+    //If every event time is inversely proportional to the particle
+    //speeds, the existing event list can simply be rescaled instead
+    //of being rebuilt from scratch.
+    if (rescaleEvents)
+      Sim->ptrScheduler->rescaleTimes(std::sqrt(currentkT / _kT));
+    else
+      //Only 1ParticleEvents occur
+      for (const ParticleEventData& PDat : SDat.L1partChanges)
+	Sim->ptrScheduler->fullUpdate(Sim->particles[PDat.getParticleID()]);
   
     for (shared_ptr<OutputPlugin>& Ptr : Sim->outputPlugins)
       Ptr->eventUpdate(*this, SDat, locdt); 
 
     dt = _timestep;
 
-    Sim->ptrScheduler->rebuildList();
+    if (!rescaleEvents)
+      Sim->ptrScheduler->rebuildList();
+  }
+
+  bool
+  SysRescale::canRescaleEventTimes() const
+  {
+    //Dynamics with external fields or time-dependent parameters have
+    //event times which do not scale with the velocities.
+    if (!std::dynamic_pointer_cast<DynNewtonian>(Sim->dynamics)
+	|| std::dynamic_pointer_cast<DynGravity>(Sim->dynamics)
+	|| std::dynamic_pointer_cast<DynCompression>(Sim->dynamics))
+      return false;
+
+    //The shearing boundary moves at a fixed rate
+    if (std::dynamic_pointer_cast<BCLeesEdwards>(Sim->BCs))
+      return false;
+
+    for (const shared_ptr<Local>& local : Sim->locals)
+      if (std::dynamic_pointer_cast<LOscillatingPlate>(local))
+	return false;
+
+    for (const shared_ptr<Global>& global : Sim->globals)
+      if (std::dynamic_pointer_cast<GWaker>(global))
+	return false;
+
+    //Infinite mass or inertia particles are not rescaled, so they
+    //must be at rest. The centre of mass velocity is reset after the
+    //rescaling, so it must also be negligible for all velocities to
+    //be scaled by the same factor.
+    Vector sumMV(0,0,0);
+    double sumMass(0), sumMV2(0);
+    for (const Particle& part : Sim->particles)
+      {
+	if (Sim->dynamics->hasOrientationData()
+	    && std::isinf(Sim->species(part)->getScalarMomentOfInertia(part.getID()))
+	    && (Sim->dynamics->getRotData(part).angularVelocity.nrm2() != 0))
+	  return false;
+
+	const double mass = Sim->species(part)->getMass(part.getID());
+	if (std::isinf(mass))
+	  {
+	    if (part.getVelocity().nrm2() != 0)
+	      return false;
+	    continue;
+	  }
+
+	Vector pos(part.getPosition()), vel(part.getVelocity());
+	Sim->BCs->applyBC(pos, vel);
+	sumMV += vel * mass;
+	sumMass += mass;
+	sumMV2 += mass * vel.nrm2();
+      }
+
+    return (sumMV / sumMass).nrm2() <= 1e-20 * sumMV2 / sumMass;
   }
 
   void 
@@ -46,6 +46,15 @@ namespace dynamo {
   
     inline const long double& getScaleFactor() const {return scaleFactor; }
 
+    /*! \brief Tests if the scheduled event times can be rescaled
+        instead of rebuilding the event list after a rescaling.
+
+	This requires that all event times are inversely proportional
+	to the particle velocities, and that every particle velocity
+	is scaled by the same factor.
+     */
+    bool canRescaleEventTimes() const;
+
   protected:
     virtual void outputXML(magnet::xml::XmlStream&) const;
 
@@ -28,6 +28,7 @@ namespace dynamo {
   SysSnapshot::SysSnapshot(dynamo::Simulation* nSim, double nPeriod, std::string nName, std::string format, bool applyBC):
     System(nSim),
     _applyBC(applyBC),
+    _async(false),
     _format(format),
     _saveCounter(0)
   {
@@ -47,6 +48,7 @@ namespace dynamo {
   SysSnapshot::SysSnapshot(dynamo::Simulation* nSim, size_t nPeriod, std::string nName, std::string format, bool applyBC):
     System(nSim),
     _applyBC(applyBC),
+    _async(false),
     _format(format),
     _saveCounter(0)
   {
@@ -101,13 +103,13 @@ namespace dynamo {
   
     std::string filename = magnet::string::search_replace("Snapshot."+_format+".xml.bz2", "%COUNT", boost::lexical_cast<std::string>(_saveCounter));
     filename = magnet::string::search_replace(filename, "%ID", boost::lexical_cast<std::string>(Sim->simID));
-    Sim->writeXMLfile(filename, _applyBC);
+    Sim->writeXMLfile(filename, _applyBC, false, _async);
     
     dout << "Printing SNAPSHOT" << std::endl;
     
     filename = magnet::string::search_replace("Snapshot.output."+_format+".xml.bz2", "%COUNT", boost::lexical_cast<std::string>(_saveCounter++));
     filename = magnet::string::search_replace(filename, "%ID", boost::lexical_cast<std::string>(Sim->simID));
-    Sim->outputData(filename);
+    Sim->outputData(filename, _async);
   }
 
   void 
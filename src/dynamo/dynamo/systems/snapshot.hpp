@@ -37,12 +37,18 @@ namespace dynamo {
     void increasedt(double);
 
     const double& getPeriod() const { return _period; }
+
+    /*! \brief Write the snapshots on a background thread, see
+        Simulation::writeXMLfile.
+     */
+    void setAsync(bool async) { _async = async; }
     
     virtual void replicaExchange(System& os) { 
       SysSnapshot& s = static_cast<SysSnapshot&>(os);
       std::swap(dt, s.dt);
       std::swap(_period, s._period);
       std::swap(_applyBC, s._applyBC);
+      std::swap(_async, s._async);
       std::swap(_format, s._format);
       std::swap(_saveCounter, s._saveCounter);
     }
@@ -55,6 +61,7 @@ namespace dynamo {
 
     double _period;
     bool _applyBC;
+    bool _async;
     std::string _format;
     mutable size_t _saveCounter;
     size_t _eventPeriod;
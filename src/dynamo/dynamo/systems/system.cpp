@@ -23,6 +23,7 @@
 #include <dynamo/systems/umbrella.hpp>
 #include <dynamo/systems/visualizer.hpp>
 #include <dynamo/systems/sleep.hpp>
+#include <dynamo/systems/mortonReorder.hpp>
 #include <dynamo/particle.hpp>
 #include <dynamo/interactions/intEvent.hpp>
 #include <dynamo/globals/globEvent.hpp>
@@ -80,6 +81,8 @@ namespace dynamo {
       return shared_ptr<System>(new SSleep(XML, Sim));
     else if (!XML.getAttribute("Type").getValue().compare("RotateGravity"))
       return shared_ptr<System>(new SysRotateGravity(XML, Sim));
+    else if (!XML.getAttribute("Type").getValue().compare("MortonReorder"))
+      return shared_ptr<System>(new SysMortonReorder(XML, Sim));
     else
       M_throw() << XML.getAttribute("Type").getValue()
 		<< ", Unknown type of System event encountered";
@@ -18,12 +18,14 @@
 #pragma once
 #include <dynamo/base.hpp>
 #include <dynamo/eventtypes.hpp>
+#include <vector>
 
 namespace magnet { namespace xml { class Node; class XmlStream; } }
 namespace dynamo {
   class IntEvent;
   class GlobalEvent;
   class NEventData;
+  class IDRange;
 
   class System: public dynamo::SimBase
   {
@@ -64,6 +66,14 @@ namespace dynamo {
       M_throw() << "The System \"" << getName() << "\"Not replica exchange safe";
     }
 
+    /*! \brief Appends the IDRange's which select the particles this
+        System acts on.
+
+	This is used to determine which particles are treated
+	identically by the System.
+     */
+    virtual void getIDRanges(std::vector<const IDRange*>&) const {}
+
   protected:
     virtual void outputXML(magnet::xml::XmlStream&) const = 0;
 
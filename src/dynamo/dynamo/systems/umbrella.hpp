@@ -33,6 +33,12 @@ namespace dynamo {
 
     virtual void operator<<(const magnet::xml::Node&);
 
+    virtual void getIDRanges(std::vector<const IDRange*>& ranges) const
+    {
+      ranges.push_back(range1.get());
+      ranges.push_back(range2.get());
+    }
+
   protected:
     virtual void outputXML(magnet::xml::XmlStream&) const;
 
@@ -0,0 +1,299 @@
+/*  dynamo:- Event driven molecular dynamics simulator 
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*! \file dynabench.cpp 
+ 
+  \brief Contains the main() function for dynabench, the DynamO
+  performance benchmark.
+
+  A fixed set of systems is generated in memory using the packer
+  modes of dynamod, and each is run for a fixed number of events. The
+  start up time, events per second and peak resident set size of each
+  system are reported, both on screen and as an XML file, so that the
+  performance of different builds, machines, schedulers and sorters
+  can be compared.
+
+  Each system is run in a child process, so that its peak memory
+  usage is measured independently of the other systems.
+*/
+
+#include <dynamo/simulation.hpp>
+#include <dynamo/inputplugins/include.hpp>
+#include <dynamo/schedulers/include.hpp>
+#include <dynamo/schedulers/sorters/sorter.hpp>
+#include <magnet/stream/formattedostream.hpp>
+#include <magnet/memUsage.hpp>
+#include <magnet/xmlwriter.hpp>
+#include <magnet/xmlreader.hpp>
+#include <boost/program_options.hpp>
+#include <boost/algorithm/string/join.hpp>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace po = boost::program_options;
+
+namespace {
+  //! \brief A benchmark system, packed using the dynamod arguments.
+  struct BenchmarkSystem
+  {
+    std::string name;
+    std::vector<std::string> packerArgs;
+  };
+
+  const std::vector<BenchmarkSystem> benchmarkSystems = {
+    {"HardSpheres0.1", {"-m", "0", "-d", "0.1"}},
+    {"HardSpheres0.5", {"-m", "0", "-d", "0.5"}},
+    {"HardSpheres0.9", {"-m", "0", "-d", "0.9"}},
+    {"SquareWell0.5", {"-m", "1", "-d", "0.5"}},
+    {"PolymerRods", {"-m", "14", "--i2", "10"}},
+    {"LeesEdwards0.5", {"-m", "4", "-d", "0.5"}},
+    {"GranularGravity", {"-m", "22", "-d", "0.5"}},
+    //The lines are randomly placed, -C sets the number of particles
+    {"HardLines", {"-m", "9", "-d", "0.5", "-C", "1000"}},
+  };
+
+  //! \brief The measurements of a single benchmark run.
+  struct BenchmarkResult
+  {
+    size_t N;
+    size_t events;
+    double startupSeconds;
+    double runSeconds;
+    double peakRSSKB;
+  };
+
+  BenchmarkResult runBenchmark(const BenchmarkSystem& system, const po::variables_map& options)
+  {
+    std::vector<std::string> args = system.packerArgs;
+    if (options.count("NCells") && (std::find(args.begin(), args.end(), "-C") == args.end()))
+      {
+	args.push_back("-C");
+	args.push_back(std::to_string(options["NCells"].as<unsigned long>()));
+      }
+
+    po::variables_map vm;
+    po::options_description packerOpts;
+    packerOpts.add(dynamo::IPPacker::getOptions());
+    packerOpts.add(dynamo::IPPacker::getPackerParameters());
+    po::store(po::command_line_parser(args).options(packerOpts).run(), vm);
+    po::notify(vm);
+
+    auto start = std::chrono::steady_clock::now();
+
+    dynamo::Simulation sim;
+    sim.ranGenerator.seed(options["random-seed"].as<unsigned int>());
+
+    dynamo::IPPacker plug(vm, &sim);
+    plug.initialise();
+    dynamo::InputPlugin(&sim, "Rescaler").zeroMomentum();
+    dynamo::InputPlugin(&sim, "Rescaler").rescaleVels(1.0);
+
+    if (options.count("sorter"))
+      {
+	magnet::xml::Document doc;
+	doc.getStoredXMLData() = "<Sorter Type=\"" + options["sorter"].as<std::string>() + "\"/>";
+	doc.parseData();
+	sim.ptrScheduler->setSorter(dynamo::FEL::getClass(doc.getNode("Sorter")));
+      }
+
+    if (options.count("eager-invalidation"))
+      sim.ptrScheduler->setEagerInvalidation(true);
+
+    sim.endEventCount = options["events"].as<size_t>();
+    sim.addOutputPlugin("Misc");
+    sim.initialise();
+
+    auto running = std::chrono::steady_clock::now();
+    while (sim.runSimulationStep(true)) {}
+    auto end = std::chrono::steady_clock::now();
+
+    BenchmarkResult result;
+    result.N = sim.N();
+    result.events = sim.eventCount;
+    result.startupSeconds = std::chrono::duration<double>(running - start).count();
+    result.runSeconds = std::chrono::duration<double>(end - running).count();
+    result.peakRSSKB = magnet::process_mem_usage();
+    return result;
+  }
+
+  /*! \brief Runs a benchmark in a child process, returning false if
+      the benchmark failed.
+   */
+  bool runBenchmarkIsolated(const BenchmarkSystem& system, const po::variables_map& options, BenchmarkResult& result)
+  {
+    int fds[2];
+    if (pipe(fds))
+      M_throw() << "Failed to create a pipe for the benchmark process";
+
+    std::cout.flush();
+    std::cerr.flush();
+    const pid_t pid = fork();
+    if (pid < 0)
+      M_throw() << "Failed to fork the benchmark process";
+
+    if (!pid)
+      {
+	close(fds[0]);
+	int status = 0;
+	try {
+	  const BenchmarkResult childResult = runBenchmark(system, options);
+	  if (write(fds[1], &childResult, sizeof(childResult)) != sizeof(childResult))
+	    status = 1;
+	} catch (std::exception& cep) {
+	  std::cerr << "Benchmark " << system.name << " failed: " << cep.what() << std::endl;
+	  status = 1;
+	}
+	std::cout.flush();
+	std::cerr.flush();
+	close(fds[1]);
+	_exit(status);
+      }
+
+    close(fds[1]);
+    const bool received = (read(fds[0], &result, sizeof(result)) == sizeof(result));
+    close(fds[0]);
+
+    int status;
+    waitpid(pid, &status, 0);
+    return received && WIFEXITED(status) && !WEXITSTATUS(status);
+  }
+}
+
+int
+main(int argc, char *argv[])
+{
+  std::cout << "dynabench  Copyright (C) 2013  Marcus N Campbell Bannerman\n"
+	    << "This program comes with ABSOLUTELY NO WARRANTY.\n"
+	    << "This is free software, and you are welcome to redistribute it\n"
+	    << "under certain conditions. See the licence you obtained with\n"
+	    << "the code\n";
+
+  try 
+    {
+      std::string systemList;
+      for (const BenchmarkSystem& system : benchmarkSystems)
+	systemList += "\n  " + system.name + " (dynamod " + boost::algorithm::join(system.packerArgs, " ") + ")";
+
+      po::options_description opts("Options");
+      opts.add_options()
+	("help,h", "Produces this message.")
+	("events,e", po::value<size_t>()->default_value(100000), "Number of events to run for each system.")
+	("system,s", po::value<std::vector<std::string> >(), ("Run only the named system, may be given multiple times. The systems are:" + systemList).c_str())
+	("NCells,C", po::value<unsigned long>(), "Number of unit cells per dimension, used to change the size of the crystal packed systems.")
+	("sorter", po::value<std::string>(), "The type of Sorter (FEL) to use, e.g., BoundedPQMinMax3, CalendarMinMax3Compact or CBT.")
+	("eager-invalidation", "Use eager event invalidation in the scheduler.")
+	("random-seed", po::value<unsigned int>()->default_value(1), "Seed value for the random number generator.")
+	("out-data-file,o", po::value<std::string>()->default_value("dynabench.xml"), "File to write the benchmark results to.")
+	("in-process", "Run the systems in this process instead of separate child processes. The peak memory usage is then the running maximum over the systems.")
+	;
+
+      po::variables_map vm;
+      po::store(po::command_line_parser(argc, argv).options(opts).run(), vm);
+      po::notify(vm);
+
+      if (vm.count("help"))
+	{
+	  std::cout << "Usage : dynabench <OPTIONS>\n"
+		    << " Runs a fixed set of benchmark systems and reports their performance.\n"
+		    << opts;
+	  return 1;
+	}
+
+      std::vector<BenchmarkSystem> systems;
+      if (vm.count("system"))
+	for (const std::string& name : vm["system"].as<std::vector<std::string> >())
+	  {
+	    auto it = std::find_if(benchmarkSystems.begin(), benchmarkSystems.end(), 
+				   [&](const BenchmarkSystem& system) { return system.name == name; });
+	    if (it == benchmarkSystems.end())
+	      M_throw() << "Unknown benchmark system \"" << name << "\"";
+	    systems.push_back(*it);
+	  }
+      else
+	systems = benchmarkSystems;
+
+      std::ofstream outputFile(vm["out-data-file"].as<std::string>().c_str());
+      magnet::xml::XmlStream XML(outputFile);
+      XML.setFormatXML(true);
+      XML << std::setprecision(std::numeric_limits<double>::digits10 + 2)
+	  << magnet::xml::prolog() << magnet::xml::tag("DynaBench")
+	  << magnet::xml::attr("Events") << vm["events"].as<size_t>()
+	  << magnet::xml::attr("Seed") << vm["random-seed"].as<unsigned int>()
+	  << magnet::xml::attr("Sorter") << (vm.count("sorter") ? vm["sorter"].as<std::string>() : "Default")
+	  << magnet::xml::attr("EagerInvalidation") << bool(vm.count("eager-invalidation"));
+
+      std::vector<std::pair<std::string, BenchmarkResult> > results;
+      bool failed = false;
+      for (const BenchmarkSystem& system : systems)
+	{
+	  std::cout << "\n##### Running " << system.name << " #####" << std::endl;
+	  BenchmarkResult result;
+	  if (vm.count("in-process"))
+	    result = runBenchmark(system, vm);
+	  else if (!runBenchmarkIsolated(system, vm, result))
+	    {
+	      failed = true;
+	      XML << magnet::xml::tag("System")
+		  << magnet::xml::attr("Name") << system.name
+		  << magnet::xml::attr("Failed") << true
+		  << magnet::xml::endtag("System");
+	      continue;
+	    }
+
+	  results.push_back(std::make_pair(system.name, result));
+	  XML << magnet::xml::tag("System")
+	      << magnet::xml::attr("Name") << system.name
+	      << magnet::xml::attr("PackerArgs") << boost::algorithm::join(system.packerArgs, " ")
+	      << magnet::xml::attr("N") << result.N
+	      << magnet::xml::attr("Events") << result.events
+	      << magnet::xml::attr("StartupSeconds") << result.startupSeconds
+	      << magnet::xml::attr("RunSeconds") << result.runSeconds
+	      << magnet::xml::attr("EventsPerSec") << result.events / result.runSeconds
+	      << magnet::xml::attr("PeakRSSKB") << result.peakRSSKB
+	      << magnet::xml::endtag("System");
+	}
+
+      XML << magnet::xml::endtag("DynaBench");
+
+      std::cout << "\n" << std::left << std::setw(20) << "System" 
+		<< std::right << std::setw(8) << "N"
+		<< std::setw(14) << "Startup(s)"
+		<< std::setw(14) << "Events/s"
+		<< std::setw(16) << "PeakRSS(MB)" << "\n";
+      for (const auto& result : results)
+	std::cout << std::left << std::setw(20) << result.first 
+		  << std::right << std::setw(8) << result.second.N
+		  << std::setw(14) << std::fixed << std::setprecision(3) << result.second.startupSeconds
+		  << std::setw(14) << std::setprecision(0) << result.second.events / result.second.runSeconds
+		  << std::setw(16) << std::setprecision(1) << result.second.peakRSSKB / 1024
+		  << "\n";
+
+      return failed;
+    }
+  catch (std::exception& cep)
+    {
+      std::cout.flush();
+      magnet::stream::FormattedOStream os(std::cerr, magnet::console::bold() + magnet::console::red_fg() + "Main(): " + magnet::console::reset());
+      os << cep.what() << std::endl;
+      return 1;
+    }
+}
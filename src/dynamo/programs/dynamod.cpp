@@ -59,6 +59,7 @@ main(int argc, char *argv[])
 	("round", "Output the XML config file with one less digit of accuracy to remove rounding errors (used in the test harness).")
 	("unwrapped", "Don't apply the boundary conditions of the system when writing out the particle positions.")
 	("check", "Runs tests on the configuration to ensure the system is not in an invalid state.")
+	("convert", "Converts the config file to the format of the output file (selected by its extension, e.g., .xml.bz2 or .dbin) without initialising or altering the system.")
 	;
 
       loadopts.add_options()
@@ -72,38 +73,7 @@ main(int argc, char *argv[])
       allopts.add(loadopts);
       allopts.add(dynamo::IPPacker::getOptions());
       
-      hiddenopts.add_options()
-	("b1", "boolean option one.")
-	("b2", "boolean option two.")
-	("i1", po::value<size_t>(), "integer option one.")
-	("i2", po::value<size_t>(), "integer option two.")
-	("i3", po::value<size_t>(), "integer option three.")
-	("i4", po::value<size_t>(), "integer option four.")
-	("s1", po::value<std::string>(), "string option one.")
-	("s2", po::value<std::string>(), "string option two.")
-	("f1", po::value<double>(), "double option one.")
-	("f2", po::value<double>(), "double option two.")
-	("f3", po::value<double>(), "double option three.")
-	("f4", po::value<double>(), "double option four.")
-	("f5", po::value<double>(), "double option five.")
-	("f6", po::value<double>(), "double option six.")
-	("f7", po::value<double>(), "double option seven.")
-	("f8", po::value<double>(), "double option eight.")
-	("f9", po::value<double>(), "double option nine.")
-	("f10", po::value<double>(), "double option ten.")
-	("NCells,C", po::value<unsigned long>()->default_value(7),
-	 "Default number of unit cells per dimension, used for crystal packing of particles.")
-	("xcell,x", po::value<unsigned long>(),
-	 "Number of unit cells in the x dimension.")
-	("ycell,y", po::value<unsigned long>(),
-	 "Number of unit cells in the y dimension.")
-	("zcell,z", po::value<unsigned long>(),
-	 "Number of unit cells in the z dimension.")
-	("rectangular-box", "Force the simulation box to be deformed so "
-	 "that the x,y,z cells also specify the box aspect ratio.")
-	("density,d", po::value<double>()->default_value(0.5),
-	 "System number density.")
-	;
+      hiddenopts.add(dynamo::IPPacker::getPackerParameters());
 
       allopts.add(hiddenopts);
 
@@ -150,6 +120,18 @@ main(int argc, char *argv[])
       else
 	sim.loadXMLfile(vm["config-file"].as<string>());
 
+      if (vm.count("convert"))
+	{
+	  if (!vm.count("config-file"))
+	    {
+	      cout << "A configuration file must be passed to convert" << std::endl;
+	      return 1;
+	    }
+
+	  sim.writeXMLfile(vm["out-config-file"].as<string>(), false, vm.count("round"));
+	  return 0;
+	}
+
       sim.endEventCount = 0;
 
       if (vm.count("thermostat"))
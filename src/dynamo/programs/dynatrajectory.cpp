@@ -0,0 +1,116 @@
+/*  dynamo:- Event driven molecular dynamics simulator 
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*! \file dynatrajectory.cpp 
+ 
+  \brief Contains the main() function for dynatrajectory, which reads
+  the binary trajectory files written by the BinaryTrajectory output
+  plugin.
+
+  The records (or a range of events) are converted back to the text
+  format of the Trajectory output plugin, either streamed to the
+  standard output or written to a file.
+*/
+
+#include <dynamo/outputplugins/binarytrajectory.hpp>
+#include <magnet/stream/formattedostream.hpp>
+#include <boost/program_options.hpp>
+#include <fstream>
+#include <iostream>
+#include <limits>
+
+namespace po = boost::program_options;
+
+int
+main(int argc, char *argv[])
+{
+  //The text output may be sent to stdout, so the banner goes to stderr
+  std::cerr << "dynatrajectory  Copyright (C) 2013  Marcus N Campbell Bannerman\n"
+	    << "This program comes with ABSOLUTELY NO WARRANTY.\n"
+	    << "This is free software, and you are welcome to redistribute it\n"
+	    << "under certain conditions. See the licence you obtained with\n"
+	    << "the code\n";
+
+  try 
+    {
+      po::options_description opts("Options");
+      opts.add_options()
+	("help,h", "Produces this message.")
+	("info,i", "Only print a summary of the file.")
+	("start,s", po::value<uint64_t>()->default_value(0), "The event count of the first event to convert.")
+	("end,e", po::value<uint64_t>()->default_value(std::numeric_limits<uint64_t>::max()), "The event count after the last event to convert.")
+	("out-file,o", po::value<std::string>(), "File to write the text trajectory to (defaults to the standard output).")
+	;
+
+      po::options_description hiddenopts;
+      hiddenopts.add_options()
+	("trajectory-file", po::value<std::string>(), "Binary trajectory file to read.")
+	;
+
+      po::options_description all;
+      all.add(opts).add(hiddenopts);
+
+      po::positional_options_description p;
+      p.add("trajectory-file", 1);
+
+      po::variables_map vm;
+      po::store(po::command_line_parser(argc, argv).options(all).positional(p).run(), vm);
+      po::notify(vm);
+
+      if (vm.count("help") || !vm.count("trajectory-file"))
+	{
+	  std::cout << "Usage : dynatrajectory <OPTIONS> trajectory.dtrj\n"
+		    << " Converts a binary trajectory file to the text trajectory format.\n"
+		    << opts;
+	  return 1;
+	}
+
+      dynamo::BinaryTrajectoryReader reader(vm["trajectory-file"].as<std::string>());
+
+      if (vm.count("info"))
+	{
+	  std::cout << "Records: " << reader.size() << "\n"
+		    << "Indexed: " << (reader.hasIndex() ? "yes" : "no") << "\n";
+	  if (reader.size())
+	    std::cout << "Events:  " << reader[0].eventCount << " to " << reader[reader.size() - 1].eventCount << "\n"
+		      << "Time:    " << reader[0].time << " to " << reader[reader.size() - 1].time << "\n";
+	  return 0;
+	}
+
+      const size_t first = reader.findEvent(vm["start"].as<uint64_t>());
+      const uint64_t end = vm["end"].as<uint64_t>();
+      const size_t last = (end == std::numeric_limits<uint64_t>::max()) ? reader.size() : reader.findEvent(end);
+
+      if (vm.count("out-file"))
+	{
+	  std::ofstream outputFile(vm["out-file"].as<std::string>().c_str());
+	  if (!outputFile)
+	    M_throw() << "Failed to open " << vm["out-file"].as<std::string>() << " for writing";
+	  reader.writeText(outputFile, first, last);
+	}
+      else
+	reader.writeText(std::cout, first, last);
+
+      return 0;
+    }
+  catch (std::exception& cep)
+    {
+      std::cout.flush();
+      magnet::stream::FormattedOStream os(std::cerr, magnet::console::bold() + magnet::console::red_fg() + "Main(): " + magnet::console::reset());
+      os << cep.what() << std::endl;
+      return 1;
+    }
+}
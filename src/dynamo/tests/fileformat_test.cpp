@@ -0,0 +1,510 @@
+#define BOOST_TEST_MODULE Fileformat_test
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <dynamo/simulation.hpp>
+#include <dynamo/BC/include.hpp>
+#include <dynamo/ranges/include.hpp>
+#include <dynamo/inputplugins/cells/include.hpp>
+#include <dynamo/species/sphericalTop.hpp>
+#include <dynamo/dynamics/newtonian.hpp>
+#include <dynamo/schedulers/include.hpp>
+#include <dynamo/schedulers/sorters/include.hpp>
+#include <dynamo/inputplugins/include.hpp>
+#include <dynamo/interactions/lines.hpp>
+#include <dynamo/interactions/hardsphere.hpp>
+#include <dynamo/species/point.hpp>
+#include <dynamo/outputplugins/binarytrajectory.hpp>
+#include <dynamo/streamingConfig.hpp>
+#include <magnet/xmlreader.hpp>
+#include <boost/filesystem.hpp>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <regex>
+#include <sstream>
+
+std::mt19937 RNG;
+typedef dynamo::FELBoundedPQ<dynamo::PELMinMax<3> > DefaultSorter;
+
+dynamo::Vector getRandVelVec()
+{
+  //See http://mathworld.wolfram.com/SpherePointPicking.html
+  std::normal_distribution<> normal_dist(0.0, (1.0 / sqrt(double(NDIM))));
+  
+  dynamo::Vector tmpVec;
+  for (size_t iDim = 0; iDim < NDIM; iDim++)
+    tmpVec[iDim] = normal_dist(RNG);
+  
+  return tmpVec;
+}
+
+/* A system of lines, so that the configuration has orientation data,
+   with a per-particle property "D" and a static particle. */
+void init(dynamo::Simulation& Sim)
+{
+  RNG.seed(std::random_device()());
+  Sim.ranGenerator.seed(std::random_device()());
+
+  const size_t N = 100;
+  const double density = 0.1;
+  Sim.dynamics = dynamo::shared_ptr<dynamo::Dynamics>(new dynamo::DynNewtonian(&Sim));
+  Sim.BCs = dynamo::shared_ptr<dynamo::BoundaryCondition>(new dynamo::BCPeriodic(&Sim));
+  Sim.ptrScheduler = dynamo::shared_ptr<dynamo::SNeighbourList>(new dynamo::SNeighbourList(&Sim, new DefaultSorter()));
+  
+  dynamo::CURandom packroutine(N, dynamo::Vector(1,1,1), new dynamo::UParticle());
+  packroutine.initialise();
+  std::vector<dynamo::Vector> latticeSites(packroutine.placeObjects(dynamo::Vector (0,0,0)));
+  double particleDiam = std::cbrt(density / N);
+  Sim.interactions.push_back(dynamo::shared_ptr<dynamo::Interaction>(new dynamo::ILines(&Sim, particleDiam, 1.0, new dynamo::IDPairRangeAll(), "Bulk")));
+  Sim.addSpecies(dynamo::shared_ptr<dynamo::Species>(new dynamo::SpSphericalTop(&Sim, new dynamo::IDRangeAll(&Sim), 1.0, "Bulk", 0, particleDiam * particleDiam / 12.0)));
+  Sim.units.setUnitLength(particleDiam);
+
+  unsigned long nParticles = 0;
+  Sim.particles.reserve(latticeSites.size());
+  for (const dynamo::Vector & position : latticeSites)
+    Sim.particles.push_back(dynamo::Particle(position, getRandVelVec() * Sim.units.unitVelocity(), nParticles++));
+  Sim.particles[3].clearState(dynamo::Particle::DYNAMIC);
+
+  Sim.dynamics->initOrientations();
+
+  dynamo::shared_ptr<dynamo::ParticleProperty> D(new dynamo::ParticleProperty(N, dynamo::Property::Units::Length(), "D", 0));
+  std::uniform_real_distribution<> uniform(0.5, 1.5);
+  for (size_t i(0); i < N; ++i)
+    D->getProperty(i) = uniform(RNG) * particleDiam;
+  Sim._properties.push(D);
+
+  Sim.ensemble = dynamo::Ensemble::loadEnsemble(Sim);
+}
+
+/* Checks the particle data of two simulations is the same, to a
+   relative tolerance (in percent). */
+void checkSameParticles(dynamo::Simulation& Sim1, dynamo::Simulation& Sim2, const double tolerance = 1e-10)
+{
+  BOOST_REQUIRE_EQUAL(Sim1.N(), Sim2.N());
+  BOOST_REQUIRE(Sim1.dynamics->hasOrientationData());
+  BOOST_REQUIRE(Sim2.dynamics->hasOrientationData());
+  dynamo::shared_ptr<dynamo::Property> D1 = Sim1._properties.getProperty("D", dynamo::Property::Units::Length());
+  dynamo::shared_ptr<dynamo::Property> D2 = Sim2._properties.getProperty("D", dynamo::Property::Units::Length());
+
+  for (size_t i(0); i < Sim1.N(); ++i)
+    {
+      const dynamo::Particle& p1 = Sim1.particles[i];
+      const dynamo::Particle& p2 = Sim2.particles[i];
+      for (size_t iDim(0); iDim < NDIM; ++iDim)
+	{
+	  BOOST_CHECK_CLOSE(p1.getPosition()[iDim] / Sim1.units.unitLength(), p2.getPosition()[iDim] / Sim2.units.unitLength(), tolerance);
+	  BOOST_CHECK_CLOSE(p1.getVelocity()[iDim] / Sim1.units.unitVelocity(), p2.getVelocity()[iDim] / Sim2.units.unitVelocity(), tolerance);
+	  BOOST_CHECK_CLOSE(Sim1.dynamics->getRotData(i).angularVelocity[iDim], Sim2.dynamics->getRotData(i).angularVelocity[iDim], tolerance);
+	}
+      BOOST_CHECK_SMALL((Sim1.dynamics->getRotData(i).orientation.imaginary() - Sim2.dynamics->getRotData(i).orientation.imaginary()).nrm(), 1e-12);
+      BOOST_CHECK_SMALL(Sim1.dynamics->getRotData(i).orientation.real() - Sim2.dynamics->getRotData(i).orientation.real(), 1e-12);
+      BOOST_CHECK_EQUAL(p1.testState(dynamo::Particle::DYNAMIC), p2.testState(dynamo::Particle::DYNAMIC));
+      BOOST_CHECK_CLOSE(D1->getProperty(i) / Sim1.units.unitLength(), D2->getProperty(i) / Sim2.units.unitLength(), tolerance);
+    }
+}
+
+std::string readFile(const std::string& fileName)
+{
+  std::ifstream file(fileName.c_str());
+  std::ostringstream os;
+  os << file.rdbuf();
+  return os.str();
+}
+
+void writeFile(const std::string& fileName, const std::string& data)
+{
+  std::ofstream file(fileName.c_str());
+  file << data;
+}
+
+BOOST_AUTO_TEST_CASE( Streaming_Config )
+{
+  {
+    dynamo::Simulation Sim;
+    init(Sim);
+    Sim.writeXMLfile("Streaming.xml");
+    Sim.writeXMLfile("Streaming.xml.bz2");
+  }
+
+  dynamo::Simulation Sim, SimBz2;
+  Sim.loadXMLfile("Streaming.xml");
+  SimBz2.loadXMLfile("Streaming.xml.bz2");
+  checkSameParticles(Sim, SimBz2);
+
+  //Rewrite the file using the other features of XML: comments (also
+  //containing tags), both quote styles, non-empty tags for the
+  //particle data, tags split over lines, and extra attributes which
+  //are not numbers
+  std::string data = readFile("Streaming.xml");
+  data = std::regex_replace(data, std::regex("<Pt ([^>]*)ID=\"([0-9]+)\""), "<!-- A <Pt> in a comment -->\n<Pt Note=\"not a number\" $1\n  ID='$2'");
+  data = std::regex_replace(data, std::regex("<P ([^/]*)/>"), "<P $1 ><!-- The position --></P>");
+  data = std::regex_replace(data, std::regex("<V x=\"([^\"]*)\""), "<V x='$1'");
+  data = std::regex_replace(data, std::regex("<U ([^/]*)/>"), "<U\n  $1></U>");
+  writeFile("StreamingAnnotated.xml", data);
+
+  dynamo::Simulation SimAnnotated;
+  SimAnnotated.loadXMLfile("StreamingAnnotated.xml");
+  checkSameParticles(Sim, SimAnnotated);
+
+  //Tiny blocks split every tag between blocks
+  dynamo::StreamingConfigReader reference("StreamingAnnotated.xml");
+  for (const size_t blockSize : {1, 3, 7, 64})
+    {
+      dynamo::StreamingConfigReader reader("StreamingAnnotated.xml", blockSize);
+      BOOST_CHECK_EQUAL(reader.getXMLData(), reference.getXMLData());
+      BOOST_REQUIRE_EQUAL(reader.getParticles().size(), Sim.N());
+      for (size_t i(0); i < Sim.N(); ++i)
+	{
+	  BOOST_CHECK_EQUAL((reader.getParticles()[i].getPosition() - reference.getParticles()[i].getPosition()).nrm(), 0);
+	  BOOST_CHECK_EQUAL((reader.getParticles()[i].getVelocity() - reference.getParticles()[i].getVelocity()).nrm(), 0);
+	}
+      BOOST_CHECK(!reader.particlesOutOfSequence());
+
+      for (const auto& array : std::vector<std::pair<std::string, size_t> >{{"D", 1}, {"O", 3}, {"U", 4}})
+	{
+	  const double* values = reader.getFloat64Array(array.first, array.second);
+	  const double* referenceValues = reference.getFloat64Array(array.first, array.second);
+	  BOOST_REQUIRE(values && referenceValues);
+	  BOOST_CHECK(std::equal(values, values + Sim.N() * array.second, referenceValues));
+	}
+
+      //Unused attributes which are not numbers only fail if requested
+      BOOST_CHECK_THROW(reader.getFloat64Array("Note", 1), std::exception);
+      BOOST_CHECK(!reader.getFloat64Array("Missing", 1));
+    }
+
+  //The metadata is kept, with the ParticleData tag emptied
+  magnet::xml::Document doc;
+  doc.getStoredXMLData() = reference.getXMLData();
+  doc.parseData();
+  magnet::xml::Node particleData = doc.getNode("DynamOconfig").getNode("ParticleData");
+  BOOST_CHECK(particleData.hasAttribute("OrientationData"));
+  BOOST_CHECK(!particleData.hasNode("Pt"));
+  BOOST_CHECK(doc.getNode("DynamOconfig").getNode("Properties").hasNode("Property"));
+
+  //A property value which is not a number, and a truncated file, are errors
+  writeFile("StreamingBadProperty.xml", std::regex_replace(data, std::regex(" D=\"[^\"]*\""), " D=\"abc\"", std::regex_constants::format_first_only));
+  dynamo::Simulation SimBadProperty;
+  BOOST_CHECK_THROW(SimBadProperty.loadXMLfile("StreamingBadProperty.xml"), std::exception);
+
+  writeFile("StreamingTruncated.xml", data.substr(0, data.size() / 2));
+  BOOST_CHECK_THROW(dynamo::StreamingConfigReader("StreamingTruncated.xml"), std::exception);
+}
+
+BOOST_AUTO_TEST_CASE( Binary_Config )
+{
+  {
+    dynamo::Simulation Sim;
+    init(Sim);
+    Sim.writeXMLfile("Binary.xml");
+  }
+
+  dynamo::Simulation Sim;
+  Sim.loadXMLfile("Binary.xml");
+  Sim.writeXMLfile("Binary.dbin");
+
+  dynamo::Simulation SimBinary;
+  SimBinary.loadXMLfile("Binary.dbin");
+  checkSameParticles(Sim, SimBinary, 0);
+
+  //The round trip back to XML is exact
+  SimBinary.writeXMLfile("BinaryRoundTrip.xml");
+  BOOST_CHECK(readFile("Binary.xml") == readFile("BinaryRoundTrip.xml"));
+
+  //Truncated files are errors, whether the header, the arrays or
+  //the metadata is cut short
+  const std::string data = readFile("Binary.dbin");
+  for (const size_t length : {size_t(0), size_t(16), data.size() / 2, data.size() - 1})
+    {
+      writeFile("BinaryTruncated.dbin", data.substr(0, length));
+      dynamo::Simulation SimTruncated;
+      BOOST_CHECK_THROW(SimTruncated.loadXMLfile("BinaryTruncated.dbin"), std::exception);
+    }
+}
+
+/* A system of hard spheres where the unit of momentum is one, as the
+   text trajectory output does not scale the impulses. */
+void initHardSpheres(dynamo::Simulation& Sim)
+{
+  RNG.seed(std::random_device()());
+  Sim.ranGenerator.seed(std::random_device()());
+
+  const double density = 0.5;
+  Sim.dynamics = dynamo::shared_ptr<dynamo::Dynamics>(new dynamo::DynNewtonian(&Sim));
+  Sim.BCs = dynamo::shared_ptr<dynamo::BoundaryCondition>(new dynamo::BCPeriodic(&Sim));
+  Sim.ptrScheduler = dynamo::shared_ptr<dynamo::SNeighbourList>(new dynamo::SNeighbourList(&Sim, new DefaultSorter()));
+
+  std::unique_ptr<dynamo::UCell> packptr(new dynamo::CUFCC(std::array<long, 3>{{5,5,5}}, dynamo::Vector(1,1,1), new dynamo::UParticle()));
+  packptr->initialise();
+  std::vector<dynamo::Vector> latticeSites(packptr->placeObjects(dynamo::Vector(0,0,0)));
+  Sim.primaryCellSize = dynamo::Vector(1,1,1);
+
+  double particleDiam = std::cbrt(density / latticeSites.size());
+  Sim.interactions.push_back(dynamo::shared_ptr<dynamo::Interaction>(new dynamo::IHardSphere(&Sim, particleDiam, 1.0, new dynamo::IDPairRangeAll(), "Bulk")));
+  Sim.addSpecies(dynamo::shared_ptr<dynamo::Species>(new dynamo::SpPoint(&Sim, new dynamo::IDRangeAll(&Sim), 1.0, "Bulk", 0)));
+  Sim.units.setUnitLength(particleDiam);
+  Sim.units.setUnitTime(particleDiam);
+
+  unsigned long nParticles = 0;
+  Sim.particles.reserve(latticeSites.size());
+  for (const dynamo::Vector & position : latticeSites)
+    Sim.particles.push_back(dynamo::Particle(position, getRandVelVec() * Sim.units.unitVelocity(), nParticles++));
+
+  Sim.ensemble = dynamo::Ensemble::loadEnsemble(Sim);
+}
+
+std::vector<std::string> splitLines(const std::string& data)
+{
+  std::vector<std::string> lines;
+  std::istringstream is(data);
+  for (std::string line; std::getline(is, line);)
+    lines.push_back(line);
+  return lines;
+}
+
+//The first record with an event counter of at least eventCount, found by a linear search.
+size_t findEventLinear(const dynamo::BinaryTrajectoryReader& reader, uint64_t eventCount)
+{
+  size_t i(0);
+  while ((i < reader.size()) && (reader[i].eventCount < eventCount)) ++i;
+  return i;
+}
+
+BOOST_AUTO_TEST_CASE( Binary_Trajectory )
+{
+  //The record layout is part of the file format
+  BOOST_CHECK_EQUAL(sizeof(dynamo::BinaryTrajectoryRecord), 144);
+  BOOST_CHECK_EQUAL(offsetof(dynamo::BinaryTrajectoryRecord, time), 8);
+  BOOST_CHECK_EQUAL(offsetof(dynamo::BinaryTrajectoryRecord, dt), 16);
+  BOOST_CHECK_EQUAL(offsetof(dynamo::BinaryTrajectoryRecord, ID1), 24);
+  BOOST_CHECK_EQUAL(offsetof(dynamo::BinaryTrajectoryRecord, ID2), 32);
+  BOOST_CHECK_EQUAL(offsetof(dynamo::BinaryTrajectoryRecord, sourceID), 40);
+  BOOST_CHECK_EQUAL(offsetof(dynamo::BinaryTrajectoryRecord, kind), 44);
+  BOOST_CHECK_EQUAL(offsetof(dynamo::BinaryTrajectoryRecord, eventType), 46);
+  BOOST_CHECK_EQUAL(offsetof(dynamo::BinaryTrajectoryRecord, data), 48);
+  BOOST_CHECK_EQUAL(sizeof(dynamo::BinaryTrajectoryIndexEntry), 16);
+
+  {
+    dynamo::Simulation Sim;
+    initHardSpheres(Sim);
+    BOOST_REQUIRE_CLOSE(Sim.units.unitMomentum(), 1.0, 1e-12);
+    Sim.addOutputPlugin("Trajectory");
+    Sim.addOutputPlugin("BinaryTrajectory");
+    Sim.endEventCount = 20000;
+    Sim.initialise();
+    while (Sim.runSimulationStep()) {}
+    //The trajectory files are completed when the plugins are destroyed
+  }
+
+  const std::string data = readFile("trajectory.dtrj");
+  dynamo::BinaryTrajectoryReader reader("trajectory.dtrj");
+  BOOST_REQUIRE(reader.hasIndex());
+  BOOST_REQUIRE(reader.size() > 3 * 4096);
+
+  //The text output is reproduced line for line
+  std::ostringstream os;
+  reader.writeText(os, 0, reader.size());
+  const std::vector<std::string> text = splitLines(readFile("trajectory.out")), binaryText = splitLines(os.str());
+  BOOST_CHECK_EQUAL(text.size(), binaryText.size());
+  for (size_t i(0); i < std::min(text.size(), binaryText.size()); ++i)
+    if (text[i] != binaryText[i])
+      {
+	BOOST_CHECK_EQUAL(text[i], binaryText[i]);
+	break;
+      }
+
+  //The records follow the 16 byte header
+  uint64_t value;
+  std::memcpy(&value, data.data() + 16, sizeof(value));
+  BOOST_CHECK_EQUAL(value, reader[0].eventCount);
+  std::memcpy(&value, data.data() + 16 + 144 * (reader.size() - 1), sizeof(value));
+  BOOST_CHECK_EQUAL(value, reader[reader.size() - 1].eventCount);
+
+  //The trailer gives the offset of the index, the number of index
+  //entries and records, then the magic string
+  uint64_t trailer[3];
+  std::memcpy(trailer, data.data() + data.size() - 32, sizeof(trailer));
+  BOOST_CHECK_EQUAL(std::string(data.data() + data.size() - 8, 8), "DYNTRIDX");
+  BOOST_CHECK_EQUAL(trailer[0], 16 + 144 * reader.size());
+  BOOST_CHECK_EQUAL(trailer[2], reader.size());
+  BOOST_REQUIRE_EQUAL(data.size(), trailer[0] + 16 * trailer[1] + 32);
+
+  //An entry is made for the first event record at least 4096 records
+  //after the previous entry
+  std::vector<dynamo::BinaryTrajectoryIndexEntry> index(trailer[1]);
+  std::memcpy(index.data(), data.data() + trailer[0], 16 * index.size());
+  std::vector<size_t> expectedIndex;
+  for (size_t i(0); i < reader.size(); ++i)
+    if ((reader[i].kind < dynamo::BinaryTrajectoryRecord::PARTICLE_CHANGE)
+	&& (expectedIndex.empty() || (i - expectedIndex.back() >= 4096)))
+      expectedIndex.push_back(i);
+
+  BOOST_REQUIRE_EQUAL(index.size(), expectedIndex.size());
+  BOOST_REQUIRE(index.size() > 3);
+  for (size_t i(0); i < index.size(); ++i)
+    {
+      BOOST_CHECK_EQUAL(index[i].record, expectedIndex[i]);
+      BOOST_CHECK_EQUAL(index[i].eventCount, reader[expectedIndex[i]].eventCount);
+    }
+
+  //Find events before the first record, on, either side of, and
+  //between the index entries, and past the end
+  std::vector<uint64_t> eventCounts{0, reader[0].eventCount, reader[reader.size() - 1].eventCount,
+      reader[reader.size() - 1].eventCount + 1, reader[reader.size() - 1].eventCount + 1000};
+  for (size_t i(0); i < index.size(); ++i)
+    {
+      eventCounts.push_back(index[i].eventCount - 1);
+      eventCounts.push_back(index[i].eventCount);
+      eventCounts.push_back(index[i].eventCount + 1);
+      if (i + 1 < index.size())
+	eventCounts.push_back((index[i].eventCount + index[i + 1].eventCount) / 2);
+    }
+
+  for (const uint64_t eventCount : eventCounts)
+    BOOST_CHECK_EQUAL(reader.findEvent(eventCount), findEventLinear(reader, eventCount));
+  BOOST_CHECK_EQUAL(reader.findEvent(reader[reader.size() - 1].eventCount + 1), reader.size());
+
+  //Without the trailer (or with a partial record) all complete
+  //records are still read, and found by a search of the whole file
+  for (const size_t length : {size_t(trailer[0] + 16 * trailer[1]), size_t(trailer[0]), size_t(trailer[0] - 100)})
+    {
+      writeFile("trajectoryTruncated.dtrj", data.substr(0, length));
+      dynamo::BinaryTrajectoryReader truncated("trajectoryTruncated.dtrj");
+      BOOST_CHECK(!truncated.hasIndex());
+      const size_t records = (length - 16) / 144;
+      BOOST_REQUIRE_EQUAL(truncated.size(), records);
+      BOOST_CHECK(std::memcmp(&truncated[0], &reader[0], 144 * records) == 0);
+      for (const uint64_t eventCount : eventCounts)
+	BOOST_CHECK_EQUAL(truncated.findEvent(eventCount), std::min(reader.findEvent(eventCount), records));
+    }
+}
+
+BOOST_AUTO_TEST_CASE( Overlapping_Species )
+{
+  //The species counts add up to N, but particle 50 belongs to both
+  //species and particles 90 to 99 to neither
+  {
+    dynamo::Simulation Sim;
+    init(Sim);
+    const double particleDiam = Sim.units.unitLength();
+    Sim.species.clear();
+    Sim.addSpecies(dynamo::shared_ptr<dynamo::Species>(new dynamo::SpSphericalTop(&Sim, new dynamo::IDRangeRange(0, 59), 1.0, "A", 0, particleDiam * particleDiam / 12.0)));
+    Sim.addSpecies(dynamo::shared_ptr<dynamo::Species>(new dynamo::SpSphericalTop(&Sim, new dynamo::IDRangeRange(50, 89), 1.0, "B", 1, particleDiam * particleDiam / 12.0)));
+    Sim.writeXMLfile("OverlappingSpecies.xml");
+  }
+
+  dynamo::Simulation Sim;
+  Sim.loadXMLfile("OverlappingSpecies.xml");
+  BOOST_CHECK_EXCEPTION(Sim.initialise(), std::exception, [](const std::exception& err)
+			{ return std::string(err.what()).find("Particle ID=50 has more than one species") != std::string::npos; });
+}
+
+BOOST_AUTO_TEST_CASE( Species_Cache )
+{
+  dynamo::Simulation Sim;
+  init(Sim);
+  Sim.initialise();
+  BOOST_CHECK_EQUAL(Sim.species(Sim.particles[10])->getName(), "Bulk");
+
+  //Replacing the species after initialisation drops the cache
+  const double particleDiam = Sim.units.unitLength();
+  Sim.species.clear();
+  Sim.species.push_back(dynamo::shared_ptr<dynamo::Species>(new dynamo::SpSphericalTop(&Sim, new dynamo::IDRangeRange(0, 49), 1.0, "A", 0, particleDiam * particleDiam / 12.0)));
+  Sim.species.push_back(dynamo::shared_ptr<dynamo::Species>(new dynamo::SpSphericalTop(&Sim, new dynamo::IDRangeRange(50, 99), 1.0, "B", 1, particleDiam * particleDiam / 12.0)));
+  BOOST_CHECK_EQUAL(Sim.species(Sim.particles[10])->getName(), "A");
+  BOOST_CHECK_EQUAL(Sim.species(Sim.particles[60])->getName(), "B");
+
+  //The cache is rebuilt to match
+  Sim.species.buildCache(Sim.particles);
+  BOOST_CHECK_EQUAL(Sim.species(Sim.particles[10])->getName(), "A");
+  BOOST_CHECK_EQUAL(Sim.species(Sim.particles[60])->getName(), "B");
+
+  //Particles added after the cache was built are searched for (and
+  //this one has no species), rather than read past the cache
+  Sim.particles.push_back(dynamo::Particle(dynamo::Vector(0,0,0), dynamo::Vector(0,0,0), 100));
+  BOOST_CHECK_THROW(Sim.species(Sim.particles[100]), std::exception);
+}
+
+BOOST_AUTO_TEST_CASE( Last_MFT )
+{
+  //Without a valid mean free time, the value loaded from the last
+  //run is written, in reduced units
+  {
+    dynamo::Simulation Sim;
+    initHardSpheres(Sim);
+    Sim.lastRunMFT = 0.25 * Sim.units.unitTime();
+    Sim.addOutputPlugin("Misc");
+    Sim.initialise();
+    Sim.writeXMLfile("LastMFT.xml");
+  }
+  {
+    dynamo::Simulation Sim;
+    Sim.loadXMLfile("LastMFT.xml");
+    BOOST_CHECK_CLOSE(Sim.lastRunMFT / Sim.units.unitTime(), 0.25, 1e-10);
+  }
+
+  //Without the Misc plugin nothing is written
+  {
+    dynamo::Simulation Sim;
+    initHardSpheres(Sim);
+    Sim.lastRunMFT = 0.25 * Sim.units.unitTime();
+    Sim.initialise();
+    Sim.writeXMLfile("NoMFT.xml");
+  }
+  std::ifstream file("NoMFT.xml");
+  const std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  BOOST_CHECK(data.find("lastMFT") == std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE( Background_Writes )
+{
+  dynamo::Simulation Sim;
+  initHardSpheres(Sim);
+  Sim.addOutputPlugin("MSD");
+  Sim.endEventCount = 1000;
+  Sim.initialise();
+  while (Sim.runSimulationStep()) {}
+
+  //The background writes must give the same files as the
+  //synchronous writes
+  for (const std::string extension : {".xml", ".xml.bz2", ".dbin"})
+    {
+      Sim.writeXMLfile("SyncConfig" + extension);
+      Sim.writeXMLfile("AsyncConfig" + extension, true, false, true);
+      Sim.waitForBackgroundWrites();
+      BOOST_CHECK(readFile("SyncConfig" + extension) == readFile("AsyncConfig" + extension));
+      BOOST_CHECK(!boost::filesystem::exists("AsyncConfig" + extension + ".part"));
+    }
+
+  for (const std::string extension : {".xml", ".xml.bz2"})
+    {
+      Sim.outputData("SyncOutput" + extension);
+      Sim.outputData("AsyncOutput" + extension, true);
+      Sim.waitForBackgroundWrites();
+      BOOST_CHECK(readFile("SyncOutput" + extension) == readFile("AsyncOutput" + extension));
+      BOOST_CHECK(!boost::filesystem::exists("AsyncOutput" + extension + ".part"));
+    }
+
+  //A write which cannot be started leaves nothing behind
+  BOOST_REQUIRE(!boost::filesystem::exists("MissingDirectory"));
+  Sim.writeXMLfile("MissingDirectory/Config.xml", true, false, true);
+  BOOST_CHECK_THROW(Sim.waitForBackgroundWrites(), std::exception);
+  BOOST_CHECK(!boost::filesystem::exists("MissingDirectory"));
+
+  //If the complete file cannot be renamed into place (here the
+  //target is a directory), the temporary file is removed
+  boost::filesystem::create_directories("BlockedOutput.xml/Child");
+  Sim.outputData("BlockedOutput.xml", true);
+  BOOST_CHECK_THROW(Sim.waitForBackgroundWrites(), std::exception);
+  BOOST_CHECK(!boost::filesystem::exists("BlockedOutput.xml.part"));
+  BOOST_CHECK(boost::filesystem::is_directory("BlockedOutput.xml/Child"));
+  boost::filesystem::remove_all("BlockedOutput.xml");
+
+  boost::filesystem::create_directories("BlockedConfig.dbin/Child");
+  Sim.writeXMLfile("BlockedConfig.dbin", true, false, true);
+  BOOST_CHECK_THROW(Sim.waitForBackgroundWrites(), std::exception);
+  BOOST_CHECK(!boost::filesystem::exists("BlockedConfig.dbin.part"));
+  boost::filesystem::remove_all("BlockedConfig.dbin");
+}
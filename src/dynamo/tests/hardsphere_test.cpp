@@ -7,6 +7,7 @@
 #include <dynamo/ranges/include.hpp>
 #include <dynamo/inputplugins/cells/include.hpp>
 #include <dynamo/species/point.hpp>
+#include <dynamo/species/sphericalTop.hpp>
 #include <dynamo/dynamics/newtonian.hpp>
 #include <dynamo/schedulers/include.hpp>
 #include <dynamo/schedulers/sorters/include.hpp>
@@ -15,6 +16,11 @@
 #include <dynamo/interactions/hardsphere.hpp>
 #include <dynamo/outputplugins/misc.hpp>
 #include <dynamo/outputplugins/msd.hpp>
+#include <dynamo/systems/mortonReorder.hpp>
+#include <dynamo/systems/rescale.hpp>
+#include <dynamo/systems/sleep.hpp>
+#include <dynamo/topology/chain.hpp>
+#include <magnet/thread/threadpool.hpp>
 #include <random>
 
 std::mt19937 RNG;
@@ -123,6 +129,78 @@ BOOST_AUTO_TEST_CASE( Equilibrium_Simulation )
   BOOST_CHECK_MESSAGE(Sim.checkSystem() <= 1, "There are more than two invalid states in the final configuration");
 }
 
+BOOST_AUTO_TEST_CASE( Morton_Reordered_Simulation )
+{
+  dynamo::Simulation Sim;
+  init(Sim, 0.5);
+  Sim.systems.push_back(dynamo::shared_ptr<dynamo::System>(new dynamo::SysMortonReorder(&Sim, "Reorder", 2 * Sim.units.unitTime())));
+
+  Sim.endEventCount = 100000;
+  Sim.addOutputPlugin("Misc");
+  Sim.initialise();
+  while (Sim.runSimulationStep()) {}
+
+  Sim.reset();
+  Sim.endEventCount = 400000;
+  Sim.addOutputPlugin("Misc"); 
+  Sim.addOutputPlugin("MSD");
+  Sim.initialise();
+  while (Sim.runSimulationStep()) {}
+
+  //The reordering must not change the dynamics of the system
+  const double expectedMFT = 0.13031;
+  const double expectedD = 0.247;
+
+  dynamo::OPMisc& opMisc = *Sim.getOutputPlugin<dynamo::OPMisc>();
+  dynamo::OPMSD& opMSD = *Sim.getOutputPlugin<dynamo::OPMSD>();
+
+  BOOST_CHECK_CLOSE(opMisc.getMFT(), expectedMFT, 1);
+
+  double D = opMSD.calcD(*Sim.species[0]->getRange()) / Sim.units.unitDiffusion();
+  BOOST_CHECK_CLOSE(D, expectedD, 6);
+
+  //Check the particles have been reordered, and the original IDs
+  //are still tracked
+  size_t moved = 0;
+  for (size_t ID(0); ID < Sim.N(); ++ID)
+    {
+      BOOST_CHECK_EQUAL(Sim.getInternalID(Sim.getExternalID(ID)), ID);
+      moved += (Sim.getExternalID(ID) != ID);
+    }
+  BOOST_CHECK(moved > 0);
+
+  BOOST_CHECK_MESSAGE(Sim.checkSystem() <= 1, "There are more than two invalid states in the final configuration");
+}
+
+BOOST_AUTO_TEST_CASE( Parallel_Event_List )
+{
+  {
+    dynamo::Simulation Sim;
+    init(Sim, 0.5);
+    Sim.writeXMLfile("HSparallel.xml");
+  }
+
+  //A parallel build of the event list must give exactly the same
+  //trajectory as a serial build
+  magnet::thread::ThreadPool pool;
+  pool.setThreadCount(4);
+
+  dynamo::Simulation serialSim, parallelSim;
+  serialSim.loadXMLfile("HSparallel.xml");
+  parallelSim.loadXMLfile("HSparallel.xml");
+  parallelSim.threadPool = &pool;
+
+  serialSim.endEventCount = parallelSim.endEventCount = 20000;
+  serialSim.initialise();
+  parallelSim.initialise();
+  while (serialSim.runSimulationStep()) {}
+  while (parallelSim.runSimulationStep()) {}
+
+  BOOST_CHECK_EQUAL(serialSim.systemTime, parallelSim.systemTime);
+  for (size_t ID(0); ID < serialSim.N(); ++ID)
+    BOOST_CHECK_EQUAL((serialSim.particles[ID].getPosition() - parallelSim.particles[ID].getPosition()).nrm(), 0);
+}
+
 BOOST_AUTO_TEST_CASE( Compression_Simulation )
 {
   dynamo::Simulation Sim;
@@ -150,3 +228,176 @@ BOOST_AUTO_TEST_CASE( Compression_Simulation )
 
   BOOST_CHECK_MESSAGE(Sim.checkSystem() <= 1, "After compression, there are more than one invalid states in the final configuration");
 }
+
+//Compares the batched hard sphere event predictions against the
+//predictions for each pair.
+void checkBatchedRoots(bool periodic)
+{
+  dynamo::Simulation Sim;
+  Sim.dynamics = dynamo::shared_ptr<dynamo::Dynamics>(new dynamo::DynNewtonian(&Sim));
+  if (periodic)
+    Sim.BCs = dynamo::shared_ptr<dynamo::BoundaryCondition>(new dynamo::BCPeriodic(&Sim));
+  else
+    Sim.BCs = dynamo::shared_ptr<dynamo::BoundaryCondition>(new dynamo::BCNone(&Sim));
+  Sim.primaryCellSize = dynamo::Vector(1, 1.5, 2);
+
+  std::uniform_real_distribution<> uniform(-0.5, 0.5);
+  std::uniform_real_distribution<> diameter(0.05, 0.3);
+  for (size_t ID(0); ID < 100; ++ID)
+    {
+      dynamo::Vector pos;
+      for (size_t iDim(0); iDim < NDIM; ++iDim)
+	pos[iDim] = uniform(RNG) * Sim.primaryCellSize[iDim];
+      Sim.particles.push_back(dynamo::Particle(pos, getRandVelVec(), ID));
+    }
+
+  size_t overlapping(0), receding(0), approaching(0);
+  std::uniform_int_distribution<size_t> pick(0, 99);
+  //Batch sizes which are, and are not, multiples of the vector width
+  for (size_t N(0); N < 14; ++N)
+    for (size_t sample(0); sample < 50; ++sample)
+      {
+	const dynamo::Particle& p1 = Sim.particles[pick(RNG)];
+	std::vector<size_t> ids(N);
+	std::vector<double> d(N), dt(N);
+	for (size_t i(0); i < N; ++i)
+	  {
+	    ids[i] = pick(RNG);
+	    //Some pairs are given a diameter large enough to overlap
+	    d[i] = (i % 4 == 3) ? 1.0 : diameter(RNG);
+	  }
+
+	Sim.dynamics->SphereSphereInRoots(p1, ids.data(), d.data(), N, dt.data());
+
+	for (size_t i(0); i < N; ++i)
+	  {
+	    const double expected = Sim.dynamics->SphereSphereInRoot(p1, Sim.particles[ids[i]], d[i]);
+	    if (std::isinf(expected))
+	      {
+		BOOST_CHECK_EQUAL(dt[i], expected);
+		++receding;
+	      }
+	    else if (expected == 0)
+	      {
+		BOOST_CHECK_EQUAL(dt[i], 0);
+		++overlapping;
+	      }
+	    else
+	      {
+		BOOST_CHECK_CLOSE(dt[i], expected, 1e-10);
+		++approaching;
+	      }
+	  }
+      }
+
+  BOOST_CHECK(overlapping > 10);
+  BOOST_CHECK(receding > 100);
+  BOOST_CHECK(approaching > 10);
+}
+
+BOOST_AUTO_TEST_CASE( Batched_Sphere_Roots )
+{
+  RNG.seed(std::random_device()());
+  checkBatchedRoots(true);
+  checkBatchedRoots(false);
+}
+
+//Checks that initialise refuses to run the MortonReorder System with
+//a feature which depends on the particle IDs.
+void checkMortonRejected(dynamo::Simulation& Sim)
+{
+  Sim.systems.push_back(dynamo::shared_ptr<dynamo::System>(new dynamo::SysMortonReorder(&Sim, "Reorder", 2 * Sim.units.unitTime())));
+  BOOST_CHECK_EXCEPTION(Sim.initialise(), std::exception, [](const std::exception& err)
+			{ return std::string(err.what()).find("The MortonReorder System cannot be used with") != std::string::npos; });
+}
+
+BOOST_AUTO_TEST_CASE( Morton_Reorder_Rejected )
+{
+  {
+    dynamo::Simulation Sim;
+    init(Sim, 0.5);
+    dynamo::shared_ptr<dynamo::Topology> chain(new dynamo::TChain(&Sim, 0, "Chain"));
+    chain->addMolecule(new dynamo::IDRangeRange(0, 9));
+    Sim.topology.push_back(chain);
+    checkMortonRejected(Sim);
+  }
+
+  {
+    dynamo::Simulation Sim;
+    init(Sim, 0.5);
+    const double particleDiam = Sim.interactions[0]->maxIntDist();
+    Sim.interactions.insert(Sim.interactions.begin(), dynamo::shared_ptr<dynamo::Interaction>(new dynamo::IHardSphere(&Sim, particleDiam, 1.0, new dynamo::IDPairRangeChains(0, 9, 10), "Chain")));
+    checkMortonRejected(Sim);
+  }
+
+  {
+    dynamo::Simulation Sim;
+    init(Sim, 0.5);
+    Sim.systems.push_back(dynamo::shared_ptr<dynamo::System>(new dynamo::SSleep(&Sim, "Sleep", new dynamo::IDRangeAll(&Sim), 0.01)));
+    checkMortonRejected(Sim);
+  }
+}
+
+//Gives the first particle an infinite moment of inertia (but a finite
+//mass). Its angular velocity is never rescaled, so if it spins the
+//event times cannot be rescaled either. It does not affect the
+//collisions of the smooth hard spheres.
+void initFixedRotor(dynamo::Simulation& Sim)
+{
+  init(Sim, 0.5);
+  const double particleDiam = Sim.units.unitLength();
+  Sim.species.clear();
+  Sim.addSpecies(dynamo::shared_ptr<dynamo::Species>(new dynamo::SpSphericalTop(&Sim, new dynamo::IDRangeRange(0, 0), 1.0, "Fixed", 0, HUGE_VAL)));
+  Sim.addSpecies(dynamo::shared_ptr<dynamo::Species>(new dynamo::SpSphericalTop(&Sim, new dynamo::IDRangeRange(1, Sim.N() - 1), 1.0, "Bulk", 1, particleDiam * particleDiam / 10.0)));
+  Sim.dynamics->initOrientations();
+  Sim.dynamics->getRotData(0).angularVelocity = dynamo::Vector(0,0,0);
+}
+
+BOOST_AUTO_TEST_CASE( Rescale_Fast_Path )
+{
+  {
+    dynamo::Simulation Sim;
+    initFixedRotor(Sim);
+    Sim.writeXMLfile("rescale.xml");
+  }
+
+  //Run the same system twice. In the second run the particle with
+  //an infinite moment of inertia spins, so the event list is rebuilt
+  //at every rescale instead of being rescaled. The dynamics are
+  //chaotic, so the run is kept short enough for the rounding
+  //differences to remain small.
+  dynamo::Simulation Sims[2];
+  for (size_t i(0); i < 2; ++i)
+    {
+      dynamo::Simulation& Sim = Sims[i];
+      Sim.loadXMLfile("rescale.xml");
+      if (i)
+	Sim.dynamics->getRotData(0).angularVelocity = dynamo::Vector(0, 0, 1 / Sim.units.unitTime());
+      Sim.systems.push_back(dynamo::shared_ptr<dynamo::System>(new dynamo::SysRescale(&Sim, 500, "Thermostat", 2.0 * Sim.units.unitEnergy())));
+      Sim.endEventCount = 5000;
+      Sim.initialise();
+      BOOST_CHECK_EQUAL(static_cast<const dynamo::SysRescale&>(*Sim.systems["Thermostat"]).canRescaleEventTimes(), !i);
+      while (Sim.runSimulationStep()) {}
+    }
+
+  BOOST_CHECK_EQUAL(Sims[0].eventCount, Sims[1].eventCount);
+  BOOST_CHECK_CLOSE(double(Sims[0].systemTime), double(Sims[1].systemTime), 1e-8);
+  BOOST_CHECK_CLOSE(Sims[0].dynamics->getkT() / Sims[0].units.unitEnergy(), 2.0, 1e-6);
+
+  //The spinning particle was never rescaled
+  BOOST_CHECK_CLOSE(Sims[1].dynamics->getRotData(0).angularVelocity[2] * Sims[1].units.unitTime(), 1.0, 1e-10);
+
+  double maxPosError(0), maxVelError(0);
+  for (size_t id(0); id < Sims[0].N(); ++id)
+    {
+      dynamo::Particle& p1 = Sims[0].particles[id];
+      dynamo::Particle& p2 = Sims[1].particles[id];
+      Sims[0].dynamics->updateParticle(p1);
+      Sims[1].dynamics->updateParticle(p2);
+      maxPosError = std::max(maxPosError, (p1.getPosition() - p2.getPosition()).nrm() / Sims[0].units.unitLength());
+      maxVelError = std::max(maxVelError, (p1.getVelocity() - p2.getVelocity()).nrm() / Sims[0].units.unitVelocity());
+    }
+
+  BOOST_CHECK_SMALL(maxPosError, 1e-7);
+  BOOST_CHECK_SMALL(maxVelError, 1e-7);
+}
@@ -0,0 +1,136 @@
+#define BOOST_TEST_MODULE OscillatingPlate_test
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <dynamo/simulation.hpp>
+#include <dynamo/inputplugins/packer.hpp>
+#include <dynamo/inputplugins/inputplugin.hpp>
+#include <dynamo/dynamics/dynamics.hpp>
+#include <dynamo/schedulers/scheduler.hpp>
+#include <dynamo/locals/oscillatingplate.hpp>
+#include <dynamo/locals/localEvent.hpp>
+#include <magnet/xmlwriter.hpp>
+#include <magnet/xmlreader.hpp>
+#include <boost/program_options.hpp>
+#include <random>
+#include <sstream>
+
+namespace po = boost::program_options;
+
+//A plate which records the particles that collide with
+//it. If rebuild is set, the whole event list is recalculated after
+//each collision, as it was before the plate tracked the particles
+//predicted with its motion.
+class TestPlate: public dynamo::LOscillatingPlate
+{
+public:
+  TestPlate(const magnet::xml::Node& XML, dynamo::Simulation* sim, bool rebuild):
+    LOscillatingPlate(XML, sim),
+    _rebuild(rebuild)
+  {}
+
+  virtual void runEvent(dynamo::Particle& part, const dynamo::LocalEvent& iEvent) const
+  {
+    hits.push_back(part.getID());
+    times.push_back(Sim->systemTime);
+
+    LOscillatingPlate::runEvent(part, iEvent);
+
+    if (_rebuild)
+      Sim->ptrScheduler->rebuildList();
+  }
+
+  mutable std::vector<size_t> hits;
+  mutable std::vector<double> times;
+
+private:
+  bool _rebuild;
+};
+
+//Packs the system of "dynamod -m 19", with the plate replaced by a
+//TestPlate. Two unit cells are used, as larger lattices overlap in
+//the default box. The collisions are elastic, as the inelastic
+//collapse of particles against the plate amplifies the round-off
+//differences between runs until their events are reordered.
+TestPlate* init(dynamo::Simulation& Sim, unsigned int seed, bool strongPlate, bool rebuild)
+{
+  std::vector<std::string> args = {"-m", "19", "-C", "2", "--f5", "1", "--f6", "1"};
+  if (strongPlate)
+    args.push_back("--b1");
+
+  po::options_description opts;
+  opts.add(dynamo::IPPacker::getOptions());
+  opts.add(dynamo::IPPacker::getPackerParameters());
+  po::variables_map vm;
+  po::store(po::command_line_parser(args).options(opts).run(), vm);
+  po::notify(vm);
+
+  Sim.ranGenerator.seed(seed);
+  dynamo::IPPacker(vm, &Sim).initialise();
+  dynamo::InputPlugin(&Sim, "Rescaler").zeroMomentum();
+  dynamo::InputPlugin(&Sim, "Rescaler").rescaleVels(1.0);
+
+  //The plate is recreated from its XML, as Locals cannot be copied
+  TestPlate* plate = NULL;
+  for (dynamo::shared_ptr<dynamo::Local>& local : Sim.locals)
+    if (std::dynamic_pointer_cast<dynamo::LOscillatingPlate>(local))
+      {
+	std::ostringstream os;
+	{
+	  magnet::xml::XmlStream XML(os);
+	  XML << magnet::xml::tag("Local") << local << magnet::xml::endtag("Local");
+	}
+
+	magnet::xml::Document doc;
+	doc.getStoredXMLData() = os.str();
+	doc.parseData();
+	plate = new TestPlate(doc.getNode("Local"), &Sim, rebuild);
+	local = dynamo::shared_ptr<dynamo::Local>(plate);
+      }
+
+  BOOST_REQUIRE(plate != NULL);
+  Sim.endEventCount = 300;
+  Sim.initialise();
+  return plate;
+}
+
+BOOST_AUTO_TEST_CASE( Plate_Matches_Full_Rebuild )
+{
+  const unsigned int seed = std::random_device()();
+
+  for (bool strongPlate : {false, true})
+    {
+      dynamo::Simulation Sims[2];
+      TestPlate* plates[2];
+      for (size_t i(0); i < 2; ++i)
+	{
+	  plates[i] = init(Sims[i], seed, strongPlate, i);
+	  while (Sims[i].runSimulationStep()) {}
+	}
+
+      //The plate must be hit often enough for its motion to be
+      //tested
+      BOOST_CHECK(plates[0]->hits.size() > 40);
+      BOOST_CHECK_EQUAL(Sims[0].eventCount, Sims[1].eventCount);
+      BOOST_CHECK_EQUAL_COLLECTIONS(plates[0]->hits.begin(), plates[0]->hits.end(), plates[1]->hits.begin(), plates[1]->hits.end());
+      BOOST_REQUIRE_EQUAL(plates[0]->times.size(), plates[1]->times.size());
+      for (size_t i(0); i < plates[0]->times.size(); ++i)
+	BOOST_CHECK_CLOSE(plates[0]->times[i], plates[1]->times[i], 1e-6);
+      BOOST_CHECK_CLOSE(double(Sims[0].systemTime), double(Sims[1].systemTime), 1e-6);
+
+      const double tolerance = 1e-7 * Sims[0].units.unitLength();
+      const double velTolerance = 1e-6 * Sims[0].units.unitVelocity();
+      BOOST_CHECK_SMALL((plates[0]->getPosition() - plates[1]->getPosition()).nrm(), tolerance);
+      BOOST_CHECK_SMALL((plates[0]->getVelocity() - plates[1]->getVelocity()).nrm(), velTolerance);
+
+      Sims[0].dynamics->updateAllParticles();
+      Sims[1].dynamics->updateAllParticles();
+      for (size_t i(0); i < Sims[0].particles.size(); ++i)
+	{
+	  const dynamo::Particle& p1 = Sims[0].particles[i];
+	  const dynamo::Particle& p2 = Sims[1].particles[i];
+	  BOOST_CHECK_SMALL((p1.getPosition() - p2.getPosition()).nrm(), tolerance);
+	  BOOST_CHECK_SMALL((p1.getVelocity() - p2.getVelocity()).nrm(), velTolerance);
+	}
+    }
+}
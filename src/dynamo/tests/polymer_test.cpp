@@ -98,3 +98,36 @@ BOOST_AUTO_TEST_CASE( Equilibrium_Simulation )
   dynamo::Vector momentum = Sim.getOutputPlugin<dynamo::OPMisc>()->getCurrentMomentum();
   BOOST_CHECK_MESSAGE(Sim.checkSystem() <= 2, "There are more than three invalid states in the final configuration");
 }
+
+//Breaks bonds (0-based IDs 9-10 and 48-49 are stretched and 10-11
+//overlap) and counts the invalid bonds
+size_t countBrokenBonds(dynamo::IDPairRange* bondRange)
+{
+  dynamo::Simulation Sim;
+  init(Sim);
+  Sim.interactions[0] = dynamo::shared_ptr<dynamo::Interaction>(new dynamo::ISquareBond(&Sim, 0.9, 1.1 / 0.9, 1.0, bondRange, "Bonds"));
+  Sim.particles[10].getPosition() = Sim.particles[11].getPosition();
+  Sim.particles[49].getPosition() += dynamo::Vector(0, 10, 0);
+  Sim.initialise();
+  return Sim.interactions["Bonds"]->validateState(false);
+}
+
+BOOST_AUTO_TEST_CASE( Bond_Validation )
+{
+  BOOST_CHECK_EQUAL(countBrokenBonds(new dynamo::IDPairRangeChains(0, 49, 50)), 3);
+
+  //Ranges which list their pairs must give the same result as
+  //testing every pair of particles
+  dynamo::IDPairRangeList* list = new dynamo::IDPairRangeList();
+  for (size_t ID(0); ID < 49; ++ID)
+    list->addPair(ID, ID + 1);
+  BOOST_CHECK_EQUAL(countBrokenBonds(list), 3);
+
+  dynamo::IDPairRangeUnion* bondUnion = new dynamo::IDPairRangeUnion(NULL);
+  bondUnion->addRange(new dynamo::IDPairRangeChains(0, 49, 50));
+  bondUnion->addRange(new dynamo::IDPairRangeChainEnds(0, 49, 50));
+  BOOST_CHECK_EQUAL(countBrokenBonds(bondUnion), 4);
+
+  //Bonds between every particle are only found by testing all pairs
+  BOOST_CHECK_EQUAL(countBrokenBonds(new dynamo::IDPairRangeSingle(new dynamo::IDRangeRange(9, 11))), 3);
+}
@@ -13,6 +13,7 @@
 #include <dynamo/interactions/hardsphere.hpp>
 #include <dynamo/outputplugins/misc.hpp>
 #include <random>
+#include <chrono>
 
 std::mt19937 RNG;
 typedef dynamo::FELBoundedPQ<dynamo::PELMinMax<3> > DefaultSorter;
@@ -67,3 +68,188 @@ BOOST_AUTO_TEST_CASE( Neighbourlist_Scheduler_CBT_Sorter )
 BOOST_AUTO_TEST_CASE( Neighbourlist_Scheduler_BoundedPQ_Sorter )
 { runTest<dynamo::SNeighbourList, dynamo::FELBoundedPQ<dynamo::PELMinMax<3> > >(); }
 
+
+BOOST_AUTO_TEST_CASE( Dumb_Scheduler_Calendar_Sorter )
+{ runTest<dynamo::SDumb, dynamo::FELCalendar<dynamo::PELMinMax<3> > >(); }
+
+BOOST_AUTO_TEST_CASE( Neighbourlist_Scheduler_Calendar_Sorter )
+{ runTest<dynamo::SNeighbourList, dynamo::FELCalendar<dynamo::PELMinMax<3> > >(); }
+
+dynamo::Vector getRandVelVec()
+{
+  //See http://mathworld.wolfram.com/SpherePointPicking.html
+  std::normal_distribution<> normal_dist(0.0, (1.0 / sqrt(double(NDIM))));
+  
+  dynamo::Vector tmpVec;
+  for (size_t iDim = 0; iDim < NDIM; iDim++)
+    tmpVec[iDim] = normal_dist(RNG);
+  
+  return tmpVec;
+}
+
+/* Equilibrates a hard sphere fluid which the sorters are then
+   compared on. */
+void initFluid(const std::string& filename)
+{
+  dynamo::Simulation Sim;
+  RNG.seed(std::random_device()());
+  Sim.ranGenerator.seed(std::random_device()());
+
+  Sim.dynamics = dynamo::shared_ptr<dynamo::Dynamics>(new dynamo::DynNewtonian(&Sim));
+  Sim.BCs = dynamo::shared_ptr<dynamo::BoundaryCondition>(new dynamo::BCPeriodic(&Sim));
+  Sim.ptrScheduler = dynamo::shared_ptr<dynamo::SNeighbourList>(new dynamo::SNeighbourList(&Sim, new DefaultSorter()));
+
+  std::unique_ptr<dynamo::UCell> packptr(new dynamo::CUFCC(std::array<long, 3>{{7,7,7}}, dynamo::Vector(1,1,1), new dynamo::UParticle()));
+  packptr->initialise();
+  std::vector<dynamo::Vector> latticeSites(packptr->placeObjects(dynamo::Vector(0,0,0)));
+  Sim.primaryCellSize = dynamo::Vector(1,1,1);
+
+  const double density = 0.5;
+  double particleDiam = std::cbrt(density / latticeSites.size());
+  Sim.interactions.push_back(dynamo::shared_ptr<dynamo::Interaction>(new dynamo::IHardSphere(&Sim, particleDiam, 1.0, new dynamo::IDPairRangeAll(), "Bulk")));
+  Sim.addSpecies(dynamo::shared_ptr<dynamo::Species>(new dynamo::SpPoint(&Sim, new dynamo::IDRangeAll(&Sim), 1.0, "Bulk", 0)));
+  Sim.units.setUnitLength(particleDiam);
+
+  unsigned long nParticles = 0;
+  Sim.particles.reserve(latticeSites.size());
+  for (const dynamo::Vector & position : latticeSites)
+    Sim.particles.push_back(dynamo::Particle(position, getRandVelVec() * Sim.units.unitVelocity(), nParticles++));
+
+  Sim.ensemble = dynamo::Ensemble::loadEnsemble(Sim);
+  dynamo::InputPlugin(&Sim, "Rescaler").zeroMomentum();
+  dynamo::InputPlugin(&Sim, "Rescaler").rescaleVels(1.0);
+
+  Sim.endEventCount = 100000;
+  Sim.initialise();
+  while (Sim.runSimulationStep()) {}
+  Sim.writeXMLfile(filename);
+}
+
+/* Runs the equilibrated fluid using the passed sorter, returning the
+   mean free time. The events per second are reported for
+   comparison. The invalidation counters of the scheduler are
+   returned through counters, if passed. */
+template<class Sorter>
+double runFluid(const std::string& filename, const std::string& name, bool eager = false, 
+		dynamo::Scheduler::InvalidationCounters* counters = NULL)
+{
+  dynamo::Simulation Sim;
+  Sim.loadXMLfile(filename);
+  Sim.ptrScheduler = dynamo::shared_ptr<dynamo::SNeighbourList>(new dynamo::SNeighbourList(&Sim, new Sorter()));
+  Sim.ptrScheduler->setEagerInvalidation(eager);
+  Sim.endEventCount = 200000;
+  Sim.addOutputPlugin("Misc");
+  Sim.initialise();
+  
+  auto start = std::chrono::steady_clock::now();
+  while (Sim.runSimulationStep()) {}
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  BOOST_TEST_MESSAGE(name << " sorter: " << Sim.endEventCount / seconds << " events/s");
+  BOOST_CHECK_MESSAGE(Sim.checkSystem() <= 1, "There are more than one invalid states in the final configuration");
+
+  //Taken from Lue 2005 DOI:10.1063/1.1834498
+  const double expectedMFT = 0.13031;
+  double MFT = Sim.getOutputPlugin<dynamo::OPMisc>()->getMFT();
+  BOOST_CHECK_CLOSE(MFT, expectedMFT, 2);
+
+  if (counters)
+    *counters = Sim.ptrScheduler->getInvalidationCounters();
+  return MFT;
+}
+
+BOOST_AUTO_TEST_CASE( Sorter_Comparison )
+{
+  initFluid("SorterFluid.xml");
+
+  const double BoundedPQMFT = runFluid<dynamo::FELBoundedPQ<dynamo::PELHeap> >("SorterFluid.xml", "BoundedPQ");
+  const double MinMaxMFT = runFluid<dynamo::FELBoundedPQ<dynamo::PELMinMax<3> > >("SorterFluid.xml", "BoundedPQMinMax3");
+  const double CalendarMFT = runFluid<dynamo::FELCalendar<dynamo::PELMinMax<3> > >("SorterFluid.xml", "CalendarMinMax3");
+  const double CalendarHeapMFT = runFluid<dynamo::FELCalendar<dynamo::PELHeap> >("SorterFluid.xml", "Calendar");
+  const double CompactHeapMFT = runFluid<dynamo::FELBoundedPQ<dynamo::PELCompactHeap> >("SorterFluid.xml", "BoundedPQCompact");
+  const double CompactMinMaxMFT = runFluid<dynamo::FELBoundedPQ<dynamo::PELMinMax<3, dynamo::CompactEvent> > >("SorterFluid.xml", "BoundedPQMinMax3Compact");
+  const double CompactCalendarMFT = runFluid<dynamo::FELCalendar<dynamo::PELMinMax<3, dynamo::CompactEvent> > >("SorterFluid.xml", "CalendarMinMax3Compact");
+
+  //All of the sorters should generate the same dynamics
+  BOOST_CHECK_CLOSE(CalendarMFT, BoundedPQMFT, 2);
+  BOOST_CHECK_CLOSE(CalendarMFT, MinMaxMFT, 2);
+  BOOST_CHECK_CLOSE(CalendarHeapMFT, BoundedPQMFT, 2);
+  BOOST_CHECK_CLOSE(CompactHeapMFT, BoundedPQMFT, 2);
+  BOOST_CHECK_CLOSE(CompactMinMaxMFT, MinMaxMFT, 2);
+  BOOST_CHECK_CLOSE(CompactCalendarMFT, CalendarMFT, 2);
+}
+
+BOOST_AUTO_TEST_CASE( Compact_Event_Encoding )
+{
+  BOOST_CHECK_EQUAL(sizeof(dynamo::CompactEvent), 16u);
+
+  const dynamo::EEventType types[] = {dynamo::INTERACTION, dynamo::GLOBAL, dynamo::LOCAL, dynamo::SYSTEM, dynamo::RECALCULATE};
+  for (const dynamo::EEventType type : types)
+    {
+      const dynamo::Event event(0.5, type, dynamo::CompactEvent::maxID, 123456789);
+      const dynamo::Event decoded = dynamo::CompactEvent(event);
+      BOOST_CHECK_EQUAL(decoded.dt, event.dt);
+      BOOST_CHECK_EQUAL(decoded.type, event.type);
+      BOOST_CHECK_EQUAL(decoded.extraID, event.extraID);
+      BOOST_CHECK_EQUAL(decoded.collCounter2, event.collCounter2);
+    }
+
+  //Changing the type must not disturb the partner ID
+  dynamo::CompactEvent event(dynamo::Event(1.0, dynamo::INTERACTION, 42, 7));
+  event.setType(dynamo::RECALCULATE);
+  BOOST_CHECK_EQUAL(event.getType(), dynamo::RECALCULATE);
+  BOOST_CHECK_EQUAL(event.getParticle2ID(), 42u);
+
+  BOOST_CHECK_THROW(dynamo::CompactEvent(dynamo::Event(1.0, dynamo::INTERACTION, dynamo::CompactEvent::maxID + 1, 0)), std::exception);
+}
+
+BOOST_AUTO_TEST_CASE( Eager_Invalidation )
+{
+  initFluid("InvalidationFluid.xml");
+
+  dynamo::Scheduler::InvalidationCounters lazy, eager, lazyHeap, eagerHeap;
+  const double lazyMFT = runFluid<DefaultSorter>("InvalidationFluid.xml", "Lazy BoundedPQMinMax3", false, &lazy);
+  const double eagerMFT = runFluid<DefaultSorter>("InvalidationFluid.xml", "Eager BoundedPQMinMax3", true, &eager);
+  const double lazyHeapMFT = runFluid<dynamo::FELCalendar<dynamo::PELHeap> >("InvalidationFluid.xml", "Lazy Calendar", false, &lazyHeap);
+  const double eagerHeapMFT = runFluid<dynamo::FELCalendar<dynamo::PELHeap> >("InvalidationFluid.xml", "Eager Calendar", true, &eagerHeap);
+
+  BOOST_CHECK_CLOSE(lazyMFT, eagerMFT, 2);
+  BOOST_CHECK_CLOSE(lazyHeapMFT, eagerHeapMFT, 2);
+
+  //Eager invalidation should remove the invalid events before they
+  //reach the top of the queue
+  BOOST_CHECK(lazy.stalePops > 0);
+  BOOST_CHECK_EQUAL(lazy.eagerRemovals, 0u);
+  BOOST_CHECK(eager.eagerRemovals > 0);
+  BOOST_CHECK_EQUAL(eager.stalePops, 0u);
+  BOOST_CHECK_EQUAL(eagerHeap.stalePops, 0u);
+  BOOST_CHECK(eagerHeap.peakOccupancy < lazyHeap.peakOccupancy);
+}
+
+BOOST_AUTO_TEST_CASE( Scheduler_Counters )
+{
+  if (!dynamo::SchedulerCounters::enabled) return;
+
+  initFluid("CountersFluid.xml");
+
+  //A short run, where the initial build of the event list would
+  //dominate the timers if it were counted
+  dynamo::Simulation Sim;
+  Sim.loadXMLfile("CountersFluid.xml");
+  Sim.endEventCount = 200;
+  Sim.addOutputPlugin("Misc");
+  Sim.initialise();
+  while (Sim.runSimulationStep()) {}
+
+  typedef dynamo::SchedulerCounters Counters;
+  const Counters& counters = Sim.ptrScheduler->getCounters();
+  const double loop = counters.getTime(Counters::EVENTLOOP);
+  const double prediction = counters.getTime(Counters::PREDICTION);
+  const double plugins = counters.getTime(Counters::PLUGINS);
+  
+  BOOST_CHECK(loop > 0);
+  BOOST_CHECK(prediction >= 0);
+  BOOST_CHECK(plugins >= 0);
+  BOOST_CHECK(counters.getExecutionTime() >= 0);
+  BOOST_CHECK(prediction + plugins <= loop);
+}
@@ -0,0 +1,192 @@
+#define BOOST_TEST_MODULE TriangleMesh_test
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <dynamo/simulation.hpp>
+#include <dynamo/BC/include.hpp>
+#include <dynamo/ranges/include.hpp>
+#include <dynamo/species/point.hpp>
+#include <dynamo/dynamics/newtonian.hpp>
+#include <dynamo/schedulers/include.hpp>
+#include <dynamo/schedulers/sorters/include.hpp>
+#include <dynamo/interactions/hardsphere.hpp>
+#include <dynamo/locals/trianglemesh.hpp>
+#include <dynamo/locals/localEvent.hpp>
+#include <random>
+
+std::mt19937 RNG;
+
+//A mesh which can be built by hand, and which records the events it
+//executes.
+class TestMesh: public dynamo::LTriangleMesh
+{
+public:
+  TestMesh(dynamo::Simulation* sim, double diameter):
+    LTriangleMesh(sim, 1.0, diameter, "Mesh", new dynamo::IDRangeAll(sim)),
+    virtualEvents(0)
+  {}
+
+  void addTriangle(const dynamo::Vector& A, const dynamo::Vector& B, const dynamo::Vector& C)
+  {
+    _elements.push_back(TriangleElements(_vertices.size(), _vertices.size() + 1, _vertices.size() + 2));
+    _vertices.push_back(A);
+    _vertices.push_back(B);
+    _vertices.push_back(C);
+  }
+
+  bool hasBVH() const { return !_bvh.empty(); }
+
+  void disableBVH() { _bvh.clear(); }
+
+  //The earliest event of the particle, found by testing every
+  //triangle, and its extra data
+  std::pair<double, size_t> bruteForceEvent(const dynamo::Particle& part) const
+  {
+    std::pair<double, size_t> tmin(HUGE_VAL, 0);
+    size_t triangleid = 0;
+    for (size_t id(0); id < _elements.size(); ++id)
+      {
+	std::pair<double, size_t> t = getTriangleEvent(part, id, 0.5 * _diameter->getProperty(part));
+	if (t < tmin) { tmin = t; triangleid = id; }
+      }
+    return std::make_pair(tmin.first, 8 * triangleid + tmin.second);
+  }
+
+  virtual void runEvent(dynamo::Particle& part, const dynamo::LocalEvent& iEvent) const
+  {
+    if (iEvent.getType() == dynamo::VIRTUAL)
+      ++virtualEvents;
+    else
+      hits.push_back(iEvent.getExtraData());
+
+    LTriangleMesh::runEvent(part, iEvent);
+  }
+
+  mutable size_t virtualEvents;
+  mutable std::vector<size_t> hits;
+};
+
+void init(dynamo::Simulation& Sim, dynamo::BoundaryCondition* BC, const double diameter)
+{
+  Sim.ranGenerator.seed(std::random_device()());
+  Sim.dynamics = dynamo::shared_ptr<dynamo::Dynamics>(new dynamo::DynNewtonian(&Sim));
+  Sim.BCs = dynamo::shared_ptr<dynamo::BoundaryCondition>(BC);
+  Sim.ptrScheduler = dynamo::shared_ptr<dynamo::SDumb>(new dynamo::SDumb(&Sim, new dynamo::FELCBT()));
+  Sim.primaryCellSize = dynamo::Vector(20, 20, 20);
+  Sim.interactions.push_back(dynamo::shared_ptr<dynamo::Interaction>(new dynamo::IHardSphere(&Sim, diameter, 1.0, new dynamo::IDPairRangeAll(), "Bulk")));
+  Sim.addSpecies(dynamo::shared_ptr<dynamo::Species>(new dynamo::SpPoint(&Sim, new dynamo::IDRangeAll(&Sim), 1.0, "Bulk", 0)));
+}
+
+BOOST_AUTO_TEST_CASE( BVH_Matches_Brute_Force )
+{
+  RNG.seed(std::random_device()());
+  std::uniform_real_distribution<> position(-10, 10);
+  std::uniform_real_distribution<> offset(-1, 1);
+  std::normal_distribution<> velocity;
+
+  for (size_t trial(0); trial < 4; ++trial)
+    {
+      dynamo::Simulation Sim;
+      const double diameter = 0.5;
+      if (trial % 2)
+	init(Sim, new dynamo::BCPeriodic(&Sim), diameter);
+      else
+	init(Sim, new dynamo::BCNone(&Sim), diameter);
+
+      //A soup of randomly placed and oriented triangles
+      TestMesh* mesh = new TestMesh(&Sim, diameter);
+      for (size_t i(0); i < 500; ++i)
+	{
+	  const dynamo::Vector centre(position(RNG), position(RNG), position(RNG));
+	  mesh->addTriangle(centre + dynamo::Vector(offset(RNG), offset(RNG), offset(RNG)),
+			    centre + dynamo::Vector(offset(RNG), offset(RNG), offset(RNG)),
+			    centre + dynamo::Vector(offset(RNG), offset(RNG), offset(RNG)));
+	}
+      Sim.locals.push_back(dynamo::shared_ptr<dynamo::Local>(mesh));
+
+      for (size_t i(0); i < 200; ++i)
+	Sim.particles.push_back(dynamo::Particle(dynamo::Vector(position(RNG), position(RNG), position(RNG)),
+						 dynamo::Vector(velocity(RNG), velocity(RNG), velocity(RNG)), i));
+
+      Sim.ensemble = dynamo::Ensemble::loadEnsemble(Sim);
+      Sim.initialise();
+      BOOST_REQUIRE(mesh->hasBVH());
+
+      //The BVH must give the same event as the brute force search if
+      //it occurs before the particle leaves its search box
+      size_t walls(0), virtuals(0);
+      for (const dynamo::Particle& part : Sim.particles)
+	{
+	  const dynamo::LocalEvent event = mesh->getEvent(part);
+	  const std::pair<double, size_t> expected = mesh->bruteForceEvent(part);
+	  if (event.getType() == dynamo::VIRTUAL)
+	    {
+	      ++virtuals;
+	      BOOST_CHECK(expected.first >= event.getdt());
+	    }
+	  else
+	    {
+	      ++walls;
+	      BOOST_CHECK_EQUAL(event.getdt(), expected.first);
+	      BOOST_CHECK_EQUAL(event.getExtraData(), expected.second);
+	    }
+	}
+
+      BOOST_CHECK(walls > 0);
+      BOOST_CHECK(virtuals > 0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE( Search_Box_Recentring )
+{
+  //A particle bouncing between the two sides of a periodic floor,
+  //crossing many search boxes between each collision. The same run
+  //is made with and without the BVH.
+  dynamo::Simulation Sims[2];
+  TestMesh* meshes[2];
+  for (size_t i(0); i < 2; ++i)
+    {
+      dynamo::Simulation& Sim = Sims[i];
+      const double diameter = 0.5;
+      init(Sim, new dynamo::BCPeriodic(&Sim), diameter);
+
+      meshes[i] = new TestMesh(&Sim, diameter);
+      for (int x(-10); x < 10; ++x)
+	for (int y(-10); y < 10; ++y)
+	  {
+	    meshes[i]->addTriangle(dynamo::Vector(x, y, 0), dynamo::Vector(x + 1, y, 0), dynamo::Vector(x + 1, y + 1, 0));
+	    meshes[i]->addTriangle(dynamo::Vector(x, y, 0), dynamo::Vector(x + 1, y + 1, 0), dynamo::Vector(x, y + 1, 0));
+	  }
+      Sim.locals.push_back(dynamo::shared_ptr<dynamo::Local>(meshes[i]));
+
+      Sim.particles.push_back(dynamo::Particle(dynamo::Vector(0.3, 0.7, 5), dynamo::Vector(1, 0.37, -0.05), 0));
+      Sim.ensemble = dynamo::Ensemble::loadEnsemble(Sim);
+      Sim.endEventCount = 20;
+      Sim.initialise();
+
+      BOOST_REQUIRE(meshes[i]->hasBVH());
+      if (i)
+	{
+	  meshes[i]->disableBVH();
+	  Sim.ptrScheduler->rebuildList();
+	}
+
+      while (Sim.runSimulationStep()) {}
+    }
+
+  //The particle must have been re-predicted several times between
+  //each collision
+  BOOST_CHECK(meshes[0]->virtualEvents > 10 * meshes[0]->hits.size());
+  BOOST_CHECK_EQUAL(meshes[1]->virtualEvents, 0);
+
+  BOOST_CHECK_EQUAL(meshes[0]->hits.size(), 20);
+  BOOST_CHECK_EQUAL_COLLECTIONS(meshes[0]->hits.begin(), meshes[0]->hits.end(), meshes[1]->hits.begin(), meshes[1]->hits.end());
+  BOOST_CHECK_CLOSE(double(Sims[0].systemTime), double(Sims[1].systemTime), 1e-8);
+
+  dynamo::Particle& p1 = Sims[0].particles[0];
+  dynamo::Particle& p2 = Sims[1].particles[0];
+  Sims[0].dynamics->updateParticle(p1);
+  Sims[1].dynamics->updateParticle(p2);
+  BOOST_CHECK_SMALL((p1.getPosition() - p2.getPosition()).nrm(), 1e-8);
+  BOOST_CHECK_SMALL((p1.getVelocity() - p2.getVelocity()).nrm(), 1e-8);
+}
@@ -0,0 +1,103 @@
+/*  dynamo:- Event driven molecular dynamics simulator 
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#ifdef __AVX2__
+# include <immintrin.h>
+#endif
+
+namespace magnet {
+  namespace intersection {
+    /*! \brief A batch of ray-sphere intersection tests.
+
+      This calculates \ref ray_sphere for \a N rays, with the ray
+      origins and directions stored as a structure of arrays so the
+      tests can be vectorised. When compiled with AVX2 support, four
+      rays are tested at once.
+
+      \param T The components of the origins of the rays relative to
+      the sphere centres.
+      \param D The components of the directions/velocities of the rays.
+      \param r The radius of each sphere.
+      \param L If not null, the side lengths of a periodic box. The
+      minimum image of each origin is then taken first (as in the
+      periodic boundary conditions of dynamo).
+      \param dt Output array for the time until each intersection, or
+      HUGE_VAL if there is no intersection.
+    */
+    inline void ray_spheres(const double* const T[3], const double* const D[3], const double* r, 
+			    const double* L, size_t N, double* dt)
+    {
+      size_t i(0);
+#ifdef __AVX2__
+      //Both branches of ray_sphere are evaluated and the result is
+      //selected with a mask.
+      const __m256d zero = _mm256_setzero_pd();
+      const __m256d huge = _mm256_set1_pd(HUGE_VAL);
+      for (; i + 4 <= N; i += 4)
+	{
+	  __m256d TD = zero, T2 = zero, D2 = zero;
+	  for (size_t iDim(0); iDim < 3; ++iDim)
+	    {
+	      __m256d Ti = _mm256_loadu_pd(T[iDim] + i);
+	      if (L)
+		{
+		  const __m256d Li = _mm256_set1_pd(L[iDim]);
+		  const __m256d image = _mm256_round_pd(_mm256_div_pd(Ti, Li), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+		  Ti = _mm256_sub_pd(Ti, _mm256_mul_pd(Li, image));
+		}
+	      const __m256d Di = _mm256_loadu_pd(D[iDim] + i);
+	      TD = _mm256_add_pd(TD, _mm256_mul_pd(Ti, Di));
+	      T2 = _mm256_add_pd(T2, _mm256_mul_pd(Ti, Ti));
+	      D2 = _mm256_add_pd(D2, _mm256_mul_pd(Di, Di));
+	    }
+
+	  const __m256d ri = _mm256_loadu_pd(r + i);
+	  const __m256d c = _mm256_sub_pd(T2, _mm256_mul_pd(ri, ri));
+	  const __m256d arg = _mm256_sub_pd(_mm256_mul_pd(TD, TD), _mm256_mul_pd(D2, c));
+	  const __m256d root = _mm256_max_pd(zero, _mm256_div_pd(_mm256_sub_pd(zero, c), _mm256_sub_pd(TD, _mm256_sqrt_pd(arg))));
+	  const __m256d valid = _mm256_and_pd(_mm256_cmp_pd(TD, zero, _CMP_LT_OQ), _mm256_cmp_pd(arg, zero, _CMP_GE_OQ));
+	  _mm256_storeu_pd(dt + i, _mm256_blendv_pd(huge, root, valid));
+	}
+#endif
+
+      for (; i < N; ++i)
+	{
+	  double TD(0), T2(0), D2(0);
+	  for (size_t iDim(0); iDim < 3; ++iDim)
+	    {
+	      double Ti = T[iDim][i];
+	      if (L) Ti -= L[iDim] * std::rint(Ti / L[iDim]);
+	      const double Di = D[iDim][i];
+	      TD += Ti * Di;
+	      T2 += Ti * Ti;
+	      D2 += Di * Di;
+	    }
+
+	  dt[i] = HUGE_VAL;
+	  if (TD >= 0) continue;
+	  const double c = T2 - r[i] * r[i];
+	  const double arg = TD * TD - D2 * c;
+	  if (arg < 0) continue;
+	  dt[i] = std::max(0.0, - c / (TD - std::sqrt(arg)));
+	}
+    }
+  }
+}
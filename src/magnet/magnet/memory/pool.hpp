@@ -20,8 +20,18 @@
 #define MAX_SMALL_OBJECT_SIZE 64
 #endif
 
+#ifndef MAX_THREAD_POOL_OBJECT_SIZE
+#define MAX_THREAD_POOL_OBJECT_SIZE 512
+#endif
+
 #include <boost/pool/pool.hpp>
 #include <mutex>
+#include <atomic>
+#include <vector>
+#include <new>
+#include <cstdlib>
+#include <cstdint>
+#include <algorithm>
 
 namespace magnet {
   /*! \brief Namespace for memory management classes.*/
@@ -54,7 +64,7 @@ namespace magnet {
 	/*! \brief Request some memory from a suitable pool. */
 	inline void* allocateMemory(size_t size) 
 	{
-	  thread::ScopedLock lock(PoolManager::getLock());
+	  std::lock_guard<std::mutex> lock(PoolManager::getLock());
 	  
 	  if (size > MAX_SMALL_OBJECT_SIZE)
 	    return ::operator new(size);
@@ -67,7 +77,7 @@ namespace magnet {
 	 */
 	inline void releaseMemory(void* deletable, size_t size) 
 	{
-	  thread::ScopedLock lock(PoolManager::getLock());
+	  std::lock_guard<std::mutex> lock(PoolManager::getLock());
 	  
 	  if (size > MAX_SMALL_OBJECT_SIZE) 
 	    ::operator delete(deletable);
@@ -96,6 +106,195 @@ namespace magnet {
 	/// memory pool array. m_pools[n] corresponds to pool with objectSize==n+1.
 	boost::pool<>* m_pools[MAX_SMALL_OBJECT_SIZE];
       };
+
+      /*! \brief A per-thread cache of small object free lists.
+
+        Memory is carved out of aligned chunks of chunkSize bytes,
+        each holding blocks of a single size class. The start of each
+        chunk records the owning cache, so any block can be traced
+        back to its owner by masking its address.
+
+        The owning thread allocates and releases through a plain
+        free list. Other threads release blocks onto a lock-free
+        "remote" list, which the owner reclaims in one exchange when
+        its local list runs dry. As only the owner ever pops from the
+        remote list there is no ABA problem.
+       */
+      class ThreadCache
+      {
+      public:
+	static const size_t chunkSize = 64 * 1024;
+	static const size_t granularity = 16;
+	static const size_t classes = (MAX_THREAD_POOL_OBJECT_SIZE + granularity - 1) / granularity;
+
+	struct Block { Block* next; };
+
+	struct alignas(64) ChunkHeader
+	{
+	  ThreadCache* owner;
+	  size_t sizeClass;
+	};
+
+	inline ThreadCache() 
+	{
+	  for (size_t i(0); i < classes; ++i)
+	    {
+	      _free[i] = NULL;
+	      _remote[i] = NULL;
+	    }
+	}
+
+	inline static size_t sizeClass(size_t size) 
+	{ return (std::max(size, size_t(1)) + granularity - 1) / granularity - 1; }
+
+	inline static ChunkHeader& chunkOf(void* ptr)
+	{ return *reinterpret_cast<ChunkHeader*>(reinterpret_cast<std::uintptr_t>(ptr) & ~std::uintptr_t(chunkSize - 1)); }
+
+	inline void* allocate(size_t sc)
+	{
+	  if (!_free[sc])
+	    {
+	      //Reclaim everything released by other threads
+	      _free[sc] = _remote[sc].exchange(NULL, std::memory_order_acquire);
+	      if (!_free[sc]) newChunk(sc);
+	    }
+
+	  Block* block = _free[sc];
+	  _free[sc] = block->next;
+	  return block;
+	}
+
+	//! \brief Release a block owned by this cache, from its owning thread.
+	inline void release(void* ptr, size_t sc)
+	{
+	  Block* block = static_cast<Block*>(ptr);
+	  block->next = _free[sc];
+	  _free[sc] = block;
+	}
+
+	//! \brief Release a block owned by this cache, from any thread.
+	inline void remoteRelease(void* ptr, size_t sc)
+	{
+	  Block* block = static_cast<Block*>(ptr);
+	  block->next = _remote[sc].load(std::memory_order_relaxed);
+	  while (!_remote[sc].compare_exchange_weak(block->next, block, std::memory_order_release, std::memory_order_relaxed)) {}
+	}
+
+      private:
+	ThreadCache(const ThreadCache&);
+	ThreadCache& operator=(const ThreadCache&);
+
+	inline void newChunk(size_t sc)
+	{
+	  void* mem = NULL;
+	  if (posix_memalign(&mem, chunkSize, chunkSize))
+	    throw std::bad_alloc();
+
+	  ChunkHeader* header = new (mem) ChunkHeader;
+	  header->owner = this;
+	  header->sizeClass = sc;
+
+	  const size_t blockSize = (sc + 1) * granularity;
+	  char* const begin = static_cast<char*>(mem) + sizeof(ChunkHeader);
+	  //Push in reverse, so the blocks are handed out in address order
+	  for (size_t i = (chunkSize - sizeof(ChunkHeader)) / blockSize; i-- > 0;)
+	    release(begin + i * blockSize, sc);
+	}
+
+	Block* _free[classes];
+	std::atomic<Block*> _remote[classes];
+      };
+
+      /*! \brief Lock-free manager of the per-thread memory pools.
+
+	Each thread allocates from its own ThreadCache, and may release
+	memory allocated by any thread. When a thread exits its cache
+	is handed over to the next thread which starts allocating, so
+	blocks released after the owner has gone are still reused. The
+	caches themselves are never freed.
+       */
+      class ThreadLocalPoolManager {
+      public:
+	/*! \brief Request some memory from the current thread's pools. */
+	inline static void* allocateMemory(size_t size) 
+	{
+	  if (size > MAX_THREAD_POOL_OBJECT_SIZE)
+	    return ::operator new(size);
+	  
+	  return localCache()->allocate(ThreadCache::sizeClass(size));
+	}
+	
+	/*! \brief Release some allocated memory to the pool it came
+	  from.
+	 */
+	inline static void releaseMemory(void* deletable, size_t size) 
+	{
+	  if (size > MAX_THREAD_POOL_OBJECT_SIZE) 
+	    return ::operator delete(deletable);
+
+	  //Don't delete null pointers
+	  if (!deletable) return;
+
+	  ThreadCache::ChunkHeader& chunk = ThreadCache::chunkOf(deletable);
+	  if (chunk.owner == handle().cache)
+	    chunk.owner->release(deletable, chunk.sizeClass);
+	  else
+	    chunk.owner->remoteRelease(deletable, chunk.sizeClass);
+	}
+
+      private:
+	/*! \brief Owns the current thread's cache and returns it to
+	  the orphan list when the thread exits.
+	 */
+	struct CacheHandle
+	{
+	  CacheHandle(): cache(NULL) {}
+	  ~CacheHandle() 
+	  {
+	    if (!cache) return;
+	    std::lock_guard<std::mutex> lock(orphanLock());
+	    orphans().push_back(cache);
+	    cache = NULL;
+	  }
+
+	  ThreadCache* cache;
+	};
+
+	inline static CacheHandle& handle()
+	{
+	  static thread_local CacheHandle h;
+	  return h;
+	}
+
+	inline static ThreadCache* localCache()
+	{
+	  CacheHandle& h = handle();
+	  if (!h.cache)
+	    {
+	      std::lock_guard<std::mutex> lock(orphanLock());
+	      if (orphans().empty())
+		h.cache = new ThreadCache;
+	      else
+		{
+		  h.cache = orphans().back();
+		  orphans().pop_back();
+		}
+	    }
+	  return h.cache;
+	}
+
+	inline static std::vector<ThreadCache*>& orphans()
+	{
+	  static std::vector<ThreadCache*>* list = new std::vector<ThreadCache*>;
+	  return *list;
+	}
+
+	inline static std::mutex& orphanLock()
+	{
+	  static std::mutex* lock = new std::mutex;
+	  return *lock;
+	}
+      };
     }
     
     /*! \brief Base class for derived classes which want to be
@@ -124,5 +323,50 @@ namespace magnet {
       
       virtual ~PoolAllocated() {}
     };
+
+    /*! \brief Base class for derived classes which want to be
+      allocated from a thread-local memory pool.
+
+      This is identical to \ref PoolAllocated, except no lock is
+      taken. Objects may be deleted by a different thread to the one
+      which allocated them. See \ref detail::ThreadLocalPoolManager.
+     */
+    class ThreadLocalPoolAllocated {
+    public:
+      inline static void* operator new(size_t size) {
+	return detail::ThreadLocalPoolManager::allocateMemory(size);
+      }
+
+      inline static void operator delete(void* deletable, size_t size) {
+	detail::ThreadLocalPoolManager::releaseMemory(deletable, size);
+      }
+      
+      virtual ~ThreadLocalPoolAllocated() {}
+    };
+
+    /*! \brief A standard library allocator which uses the
+      thread-local memory pools.
+
+      This is intended for node based containers (e.g., std::list)
+      holding small objects, where every insertion would otherwise
+      call the global allocator.
+     */
+    template<class T>
+    class PoolAllocator {
+    public:
+      typedef T value_type;
+
+      PoolAllocator() noexcept {}
+      template<class U> PoolAllocator(const PoolAllocator<U>&) noexcept {}
+
+      inline T* allocate(size_t n)
+      { return static_cast<T*>(detail::ThreadLocalPoolManager::allocateMemory(n * sizeof(T))); }
+
+      inline void deallocate(T* p, size_t n)
+      { detail::ThreadLocalPoolManager::releaseMemory(p, n * sizeof(T)); }
+
+      template<class U> bool operator==(const PoolAllocator<U>&) const { return true; }
+      template<class U> bool operator!=(const PoolAllocator<U>&) const { return false; }
+    };
   }
 }
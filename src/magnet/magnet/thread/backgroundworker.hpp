@@ -0,0 +1,157 @@
+/*  dynamo:- Event driven molecular dynamics simulator 
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*! \file backgroundworker.hpp
+ * \brief Contains the definition of BackgroundWorker
+ */
+
+#pragma once
+
+#include <magnet/exception.hpp>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <deque>
+#include <string>
+#include <iostream>
+
+namespace magnet {
+  namespace thread {
+    /*! \brief A single background thread which runs tasks in the
+      order they are queued.
+
+      The queue is bounded, so when the background thread falls
+      behind the queueing thread is made to wait (back-pressure)
+      rather than letting the queued work, and the memory it holds,
+      grow without limit. The thread is only started when the first
+      task is queued.
+
+      If a task throws, the exception message is reported by the next
+      call to queueTask() or wait().
+     */
+    class BackgroundWorker
+    {
+    public:
+      /*! \brief Constructor
+	\param maxQueued The number of tasks which may be waiting to
+	run, in addition to the one currently running.
+       */
+      inline BackgroundWorker(size_t maxQueued = 1):
+	_maxQueued(maxQueued),
+	_running(false),
+	_stop(false)
+      {}
+
+      /*! \brief Destructor, completes all queued tasks. */
+      inline ~BackgroundWorker() throw()
+      {
+	try { wait(); } catch (std::exception& cep) 
+			  { std::cerr << cep.what() << std::endl; }
+
+	{
+	  std::lock_guard<std::mutex> lock(_mutex);
+	  _stop = true;
+	}
+	_condition.notify_all();
+	if (_thread.joinable()) _thread.join();
+      }
+
+      /*! \brief Queue a task to run on the background thread.
+
+	This blocks while the queue is full.
+       */
+      inline void queueTask(std::function<void()>&& task)
+      {
+	std::unique_lock<std::mutex> lock(_mutex);
+	checkError();
+
+	if (!_thread.joinable())
+	  _thread = std::thread(&BackgroundWorker::run, this);
+
+	while (_tasks.size() >= _maxQueued)
+	  _condition.wait(lock);
+
+	_tasks.push_back(std::move(task));
+	_condition.notify_all();
+      }
+
+      /*! \brief Wait until all queued tasks have completed. */
+      inline void wait()
+      {
+	std::unique_lock<std::mutex> lock(_mutex);
+	while (!_tasks.empty() || _running)
+	  _condition.wait(lock);
+	checkError();
+      }
+
+    private:
+      BackgroundWorker(const BackgroundWorker&);
+      BackgroundWorker& operator=(const BackgroundWorker&);
+
+      inline void checkError()
+      {
+	if (_error.empty()) return;
+	std::string error;
+	std::swap(error, _error);
+	M_throw() << "Background task threw an exception:-" << error;
+      }
+
+      inline void run()
+      {
+	std::unique_lock<std::mutex> lock(_mutex);
+	while (true)
+	  {
+	    while (_tasks.empty() && !_stop)
+	      _condition.wait(lock);
+
+	    if (_tasks.empty()) return;
+
+	    std::function<void()> task = std::move(_tasks.front());
+	    _tasks.pop_front();
+	    _running = true;
+	    //Let any thread blocked on a full queue continue
+	    _condition.notify_all();
+	    lock.unlock();
+
+	    try { task(); }
+	    catch (std::exception& cep)
+	      {
+		lock.lock();
+		_error += std::string("\n") + cep.what();
+		lock.unlock();
+	      }
+
+	    //Release the task's resources before reporting completion
+	    task = std::function<void()>();
+
+	    lock.lock();
+	    _running = false;
+	    _condition.notify_all();
+	  }
+      }
+
+      const size_t _maxQueued;
+      std::deque<std::function<void()> > _tasks;
+      std::thread _thread;
+      std::mutex _mutex;
+      std::condition_variable _condition;
+      std::string _error;
+      bool _running;
+      bool _stop;
+    };
+  }
+}
@@ -24,96 +24,167 @@
 #include <iostream>
 
 #include <magnet/thread/threadgroup.hpp>
-#include <magnet/thread/taskQueue.hpp>
 #include <mutex>
 #include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <functional>
 
 namespace magnet {
   namespace thread {
     /*! \brief A class providing a pool of worker threads that will
       execute "tasks" pushed to it.
       
+      Each worker thread owns a deque of tasks. Tasks queued from
+      inside a worker are pushed onto its own deque and are executed
+      in LIFO order, which keeps recursively generated work hot in
+      the cache, while idle workers steal the oldest tasks from the
+      other deques. Tasks queued from outside the pool are dealt out
+      to the deques in turn. Workers only sleep (and are only woken)
+      when there is no work anywhere in the pool.
+
+      Tasks may be collected into a TaskGroup, which can be waited on
+      independently of the other tasks in the pool. Workers waiting
+      on a group execute queued tasks while they wait, so groups may
+      be waited on from inside a task.
+
       This class will also run in 0 thread mode, where the controlling
       process will execute the tasks when it enters the
       ThreadPool::wait() function.
      */
-    class ThreadPool : public TaskQueue
-    {	
-    private:
-      volatile bool _exception_flag;
-      std::ostringstream _exception_data;
-      
-      ThreadPool (const ThreadPool&);
-      ThreadPool& operator = (const ThreadPool&);
-  
-      /*! \brief This mutex is to control access to write that an exception has occurred.
-       */
-      std::mutex _exception_mutex;
+    class ThreadPool
+    {
+    public:
+      /*! \brief A set of tasks which can be waited on independently
+	of the other tasks in a ThreadPool.
 
-      /*! \brief Triggered every time a thread becomes available, to
-        notify the mother thread stuck in the wait() function.
+	The destructor waits for any outstanding tasks in the group.
        */
-      std::condition_variable _threadAvailable_condition;
+      class TaskGroup
+      {
+      public:
+	inline TaskGroup(ThreadPool& pool):
+	  _pool(pool),
+	  _pending(0),
+	  _exception_flag(false)
+	{}
 
-      /*! \brief Triggered to wake threads when jobs are added to the queue.
-       */
-      std::condition_variable _need_thread_mutex;
+	inline ~TaskGroup() 
+	{ 
+	  try { wait(); } catch (...) {}
+	}
 
-      magnet::thread::ThreadGroup _threads;
+	//! \brief Queue a task in this group.
+	inline void queueTask(std::function<void()>&& threadfunc)
+	{ _pool.submit(std::move(threadfunc), this); }
 
-      volatile size_t _idlingThreads;
-      volatile bool _stop_flag;
+	/*! \brief Wait for all tasks in this group to complete.
+
+	  This may be called from inside a task, in which case the
+	  worker executes other tasks while it waits. If any task in
+	  the group threw, an exception is thrown once all of the
+	  group's tasks have finished.
+	 */
+	inline void wait()
+	{
+	  _pool.waitFor(_pending);
+	  
+	  if (_exception_flag)
+	    {
+	      _exception_flag = false;
+	      std::string data = _exception_data.str();
+	      _exception_data.str("");
+	      M_throw() << "Thread Exception found while waiting for task group to finish"
+			<< data;
+	    }
+	}
+
+	//! \brief The number of queued or running tasks in the group.
+	inline size_t pending() const { return _pending; }
+
+      private:
+	friend class ThreadPool;
+
+	TaskGroup(const TaskGroup&);
+	TaskGroup& operator=(const TaskGroup&);
+
+	ThreadPool& _pool;
+	std::atomic<size_t> _pending;
+	volatile bool _exception_flag;
+	std::ostringstream _exception_data;
+	std::mutex _exception_mutex;
+      };
 
-    public:  
       /*! \brief Default Constructor
        
         This initialises the pool to 0 threads
        */
       inline ThreadPool():
 	_exception_flag(false),
+	_pending(0),
+	_queued(0),
+	_nextDeque(0),
 	_idlingThreads(0),
-	_stop_flag(false)
-      {}
+	_waitingThreads(0),
+	_stop_flag(false),
+	_pinThreads(false)
+      { _deques.emplace_back(new TaskDeque); }
       
       /*! \brief Set the number of threads in the pool
        
         This creates the specified amount of threads to populate the
-        pool. When lowering the number of threads this pool kills ALL
-        threads, but waits for all their current tasks to complete
-        first, then repopulates the pool.
+        pool. Changing the number of threads stops ALL threads, waits
+        for their current tasks to complete, then repopulates the
+        pool. Tasks still queued are kept and shared out among the
+        new threads.
        */
       inline void setThreadCount(size_t x)
       { 
 	if (x == _threads.size()) return;
 	
-	if (x < _threads.size())
-	  {
-	    //Stop all threads as we're shrinking our thread pool size
-	    stop();
-	    //All threads are dead, reset the kill switch
-	    _stop_flag = false;
-	  }
-	
-	//Add the required number of threads
-	for (size_t i=_threads.size(); i < x; ++i)
-	  _threads.create_thread(std::function<void()>(std::bind(&ThreadPool::beginThread, this)));
+	stop();
+	_stop_flag = false;
+
+	//Collect the remaining tasks, then share them out again
+	std::deque<Task> tasks;
+	for (auto& deque : _deques)
+	  for (Task& task : deque->tasks)
+	    tasks.push_back(std::move(task));
+
+	_deques.clear();
+	for (size_t i(0); i < std::max(x, size_t(1)); ++i)
+	  _deques.emplace_back(new TaskDeque);
+
+	for (size_t i(0); i < tasks.size(); ++i)
+	  _deques[i % _deques.size()]->tasks.push_back(std::move(tasks[i]));
+
+	for (size_t i(0); i < x; ++i)
+	  _threads.create_thread(std::function<void()>(std::bind(&ThreadPool::beginThread, this, i)));
       }
 
       /*! \brief The current number of threads in the pool */
       inline size_t getThreadCount() const { return _threads.size(); }
 
+      /*! \brief Pin each worker thread to a single CPU.
+
+	Worker i is bound to CPU i modulo the number of hardware
+	threads. This only takes effect when the threads are next
+	created (see setThreadCount()), and is ignored on platforms
+	without thread affinity support.
+       */
+      inline void setThreadPinning(bool pin) { _pinThreads = pin; }
+
       //Actual queuer
       inline void queueTask(std::function<void()>&& threadfunc)
-      {
-	TaskQueue::queueTask(threadfunc);
-	_need_thread_mutex.notify_all();
-      }
+      { submit(std::move(threadfunc), NULL); }
 
       //Actual queuer
       inline void queueTasks(std::vector<std::function<void()> >& threadfuncs)
       {
-	TaskQueue::queueTasks(threadfuncs);
-	_need_thread_mutex.notify_all();
+	for (auto& func : threadfuncs)
+	  submit(std::move(func), NULL);
+	threadfuncs.clear();
       }
   
       /*! \brief Destructor
@@ -125,29 +196,13 @@ namespace magnet {
 
       /*! \brief Wait for all tasks to complete.
        
-        If there are no threads in the pool then this function will
-        actually make the waiting/mother process perform the tasks.
+        This includes the tasks of every TaskGroup. If there are no
+        threads in the pool then this function will actually make the
+        waiting/mother process perform the tasks.
        */
       inline void wait()
       {
-	if (_threads.size())
-	  {
-	    //We are in threaded mode! Wait until all tasks are gone
-	    //and all threads are idling
-	    std::unique_lock<std::mutex> lock1(_queue_mutex);      
-	    while (!_waitingFunctors.empty() 
-		   || (_idlingThreads != _threads.size()))
-	      _threadAvailable_condition.wait(lock1);
-	  }
-	else
-	  {
-	    //Non threaded mode
-	    while (!_waitingFunctors.empty())
-	      {
-		_waitingFunctors.front()();
-		_waitingFunctors.pop();
-	      }
-	  }
+	waitFor(_pending);
 	
 	if (_exception_flag) 
 	  M_throw() << "Thread Exception found while waiting for tasks/threads to finish"
@@ -157,44 +212,215 @@ namespace magnet {
       inline size_t getIdleThreadCount() { return _idlingThreads; }
   
     private:
+      ThreadPool (const ThreadPool&);
+      ThreadPool& operator = (const ThreadPool&);
+
+      struct Task
+      {
+	std::function<void()> func;
+	TaskGroup* group;
+      };
+
+      /*! \brief The tasks owned by a single worker.
+
+	The owner pushes and pops at the back, thieves take from the
+	front. Each deque has its own lock so the workers only contend
+	when stealing.
+       */
+      struct TaskDeque
+      {
+	std::mutex mutex;
+	std::deque<Task> tasks;
+      };
+
+      /*! \brief The pool and deque index of the current thread, if it
+	is a worker.
+       */
+      struct WorkerID
+      {
+	ThreadPool* pool;
+	size_t index;
+      };
+
+      static inline WorkerID& currentWorker()
+      {
+	static thread_local WorkerID id = {NULL, 0};
+	return id;
+      }
+
+      inline void submit(std::function<void()>&& func, TaskGroup* group)
+      {
+	++_pending;
+	if (group) ++(group->_pending);
+
+	const WorkerID& self = currentWorker();
+	const size_t index = (self.pool == this) ? self.index 
+	  : (_nextDeque++ % _deques.size());
+	
+	{
+	  TaskDeque& deque = *_deques[index];
+	  std::lock_guard<std::mutex> lock(deque.mutex);
+	  Task task = {std::move(func), group};
+	  deque.tasks.push_back(std::move(task));
+	}
+
+	++_queued;
+
+	//Taking the lock orders this notification after any sleeper
+	//has tested _queued, so the wake up cannot be lost
+	if (_idlingThreads || _waitingThreads)
+	  {
+	    { std::lock_guard<std::mutex> lock(_sleep_mutex); }
+	    _need_thread_condition.notify_one();
+	    if (_waitingThreads)
+	      _threadAvailable_condition.notify_all();
+	  }
+      }
+
+      /*! \brief Fetch a task for a thread.
+
+	Workers take from the back of their own deque, then steal from
+	the front of the others. The controlling process only runs
+	tasks in 0 thread mode, where it takes the newest task so that
+	recursively generated work is executed depth first.
+       */
+      inline bool getTask(size_t index, bool isWorker, Task& task)
+      {
+	if (!_queued) return false;
+
+	if (isWorker)
+	  {
+	    TaskDeque& deque = *_deques[index];
+	    std::lock_guard<std::mutex> lock(deque.mutex);
+	    if (!deque.tasks.empty())
+	      {
+		task = std::move(deque.tasks.back());
+		deque.tasks.pop_back();
+		--_queued;
+		return true;
+	      }
+	  }
+
+	for (size_t i(0); i < _deques.size(); ++i)
+	  {
+	    TaskDeque& deque = *_deques[(index + i) % _deques.size()];
+	    std::lock_guard<std::mutex> lock(deque.mutex);
+	    if (deque.tasks.empty()) continue;
+
+	    if (isWorker)
+	      {
+		task = std::move(deque.tasks.front());
+		deque.tasks.pop_front();
+	      }
+	    else
+	      {
+		task = std::move(deque.tasks.back());
+		deque.tasks.pop_back();
+	      }
+	    --_queued;
+	    return true;
+	  }
+
+	return false;
+      }
+
+      inline void runTask(Task& task)
+      {
+	try { task.func(); }
+	catch(std::exception& cep)
+	  {
+	    //Mark the waiting process to throw an exception as soon as possible
+	    if (task.group)
+	      {
+		std::lock_guard<std::mutex> lock(task.group->_exception_mutex);
+		task.group->_exception_data << "\nTHREAD: Task threw an exception:-"
+					    << cep.what();
+		task.group->_exception_flag = true;
+	      }
+	    else
+	      {
+		std::lock_guard<std::mutex> lock(_exception_mutex);
+		_exception_data << "\nTHREAD: Task threw an exception:-"
+				<< cep.what();
+		_exception_flag = true;
+	      }
+	  }
+
+	//Release the functor's resources before signalling completion
+	task.func = std::function<void()>();
+
+	bool finished = (--_pending == 0);
+	if (task.group)
+	  finished |= (--(task.group->_pending) == 0);
+
+	if (finished && _waitingThreads)
+	  {
+	    { std::lock_guard<std::mutex> lock(_sleep_mutex); }
+	    _threadAvailable_condition.notify_all();
+	  }
+      }
+
+      /*! \brief Wait until the counter reaches zero.
+
+	Workers execute tasks while they wait, so that tasks may wait
+	on the tasks they create. Other threads only execute tasks if
+	there are no workers. If they helped alongside the workers,
+	each task they picked up could itself wait and pick up an
+	unrelated task, nesting without bound on their stack.
+       */
+      inline void waitFor(const std::atomic<size_t>& counter)
+      {
+	const WorkerID& self = currentWorker();
+	const bool isWorker = (self.pool == this);
+	const bool help = isWorker || _threads.size() == 0;
+	size_t index = isWorker ? self.index : 0;
+
+	while (counter)
+	  {
+	    Task task;
+	    if (help && getTask(index, isWorker, task))
+	      {
+		runTask(task);
+		continue;
+	      }
+
+	    //Nothing to take, the remaining tasks are running on other
+	    //threads. Sleep until one finishes or new work arrives.
+	    std::unique_lock<std::mutex> lock(_sleep_mutex);
+	    ++_waitingThreads;
+	    while (counter && !(help && _queued))
+	      _threadAvailable_condition.wait(lock);
+	    --_waitingThreads;
+	  }
+      }
+
       /*! \brief Thread worker loop, called by the threads beginThreadFunc.
        */
-      inline void beginThread()
+      inline void beginThread(size_t index)
       {
+	currentWorker().pool = this;
+	currentWorker().index = index;
+	pinThread(index);
+
 	try
 	  {
-	    std::unique_lock<std::mutex> lock1(_queue_mutex);
-	    
 	    while (!_stop_flag)
 	      {
-		if (_waitingFunctors.empty())
+		Task task;
+		if (getTask(index, true, task))
 		  {
-		    ++_idlingThreads;
-		    //Let whoever is waiting know that the thread is now available
-		    _threadAvailable_condition.notify_all();
-		    //And send it to sleep
-		    _need_thread_mutex.wait(lock1);
-		    --_idlingThreads;
+		    runTask(task);
 		    continue;
 		  }
-		
-		std::function<void()> func = _waitingFunctors.front();
-		_waitingFunctors.pop();
-		
-		lock1.unlock();
-		
-		try { func(); }
-		catch(std::exception& cep)
-		  {
-		    //Mark the main process to throw an exception as soon as possible
-		    std::lock_guard<std::mutex> lock2(_exception_mutex);
-		    
-		    _exception_data << "\nTHREAD: Task threw an exception:-"
-				    << cep.what();
-		    
-		    _exception_flag = true;
-		  }
-		lock1.lock();
+
+		std::unique_lock<std::mutex> lock(_sleep_mutex);
+		++_idlingThreads;
+		//Let whoever is waiting know that the thread is now available
+		if (_waitingThreads) _threadAvailable_condition.notify_all();
+		//And send it to sleep
+		while (!_queued && !_stop_flag)
+		  _need_thread_condition.wait(lock);
+		--_idlingThreads;
 	      }
 	  }
 	catch (std::exception& p)
@@ -204,6 +430,18 @@ namespace magnet {
 	    throw;
 	  }
       }
+
+      inline void pinThread(size_t index)
+      {
+#ifdef __linux__
+	if (!_pinThreads) return;
+	const size_t cpus = std::max(1u, std::thread::hardware_concurrency());
+	cpu_set_t cpuset;
+	CPU_ZERO(&cpuset);
+	CPU_SET(index % cpus, &cpuset);
+	pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+#endif
+      }
       
       /*! \brief Halt the threadpool and terminate all the threads.
        */
@@ -213,14 +451,52 @@ namespace magnet {
 	// it is possible for a thread to miss notify_all and never
 	// terminate.
 	{
-	  std::unique_lock<std::mutex> lock1(_queue_mutex);
+	  std::unique_lock<std::mutex> lock1(_sleep_mutex);
 	  _stop_flag = true;       
 	}
 	
-	_need_thread_mutex.notify_all();
+	_need_thread_condition.notify_all();
 	_threads.join_all();
       }
 
+      volatile bool _exception_flag;
+      std::ostringstream _exception_data;
+      
+      /*! \brief This mutex is to control access to write that an exception has occurred.
+       */
+      std::mutex _exception_mutex;
+
+      //! \brief One task deque per worker thread (at least one).
+      std::vector<std::unique_ptr<TaskDeque> > _deques;
+
+      //! \brief Tasks queued or running, over all groups.
+      std::atomic<size_t> _pending;
+
+      //! \brief Tasks sitting in the deques.
+      std::atomic<size_t> _queued;
+
+      //! \brief Round robin counter for tasks queued from outside the pool.
+      std::atomic<size_t> _nextDeque;
+
+      /*! \brief Guards the sleeping of the worker and waiting threads.
+       */
+      std::mutex _sleep_mutex;
+
+      /*! \brief Triggered every time a task finishes or work
+        arrives, to notify the threads stuck in a wait() function.
+       */
+      std::condition_variable _threadAvailable_condition;
+
+      /*! \brief Triggered to wake threads when jobs are added to the queue.
+       */
+      std::condition_variable _need_thread_condition;
+
+      magnet::thread::ThreadGroup _threads;
+
+      std::atomic<size_t> _idlingThreads;
+      std::atomic<size_t> _waitingThreads;
+      std::atomic<bool> _stop_flag;
+      bool _pinThreads;
     };
   }
 }
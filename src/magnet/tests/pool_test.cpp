@@ -0,0 +1,143 @@
+#include <iostream>
+#include <vector>
+#include <list>
+#include <thread>
+#include <chrono>
+#include <stdexcept>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <magnet/memory/pool.hpp>
+
+struct Plain
+{
+  virtual ~Plain() {}
+  double data[4];
+};
+
+struct Locked : public magnet::memory::PoolAllocated
+{ double data[4]; };
+
+struct ThreadLocal : public magnet::memory::ThreadLocalPoolAllocated
+{ double data[4]; };
+
+//! Each thread repeatedly allocates a batch of objects then frees them
+template<class T>
+double contendedAllocation(size_t threads)
+{
+  const size_t batch = 64;
+  const size_t rounds = 20000;
+
+  auto worker = []()
+    {
+      std::vector<T*> objects(batch);
+      for (size_t r = 0; r < rounds; ++r)
+	{
+	  for (size_t i = 0; i < batch; ++i)
+	    objects[i] = new T;
+	  for (size_t i = 0; i < batch; ++i)
+	    delete objects[i];
+	}
+    };
+
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> pool;
+  for (size_t i = 0; i < threads; ++i)
+    pool.push_back(std::thread(worker));
+  for (auto& thread : pool)
+    thread.join();
+
+  //Nanoseconds per allocation/release pair
+  return 1e9 * std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() 
+    / (threads * batch * rounds);
+}
+
+void testCrossThreadRelease()
+{
+  const size_t N = 100000;
+  const size_t capacity = 256;
+
+  for (size_t loop = 0; loop < 3; ++loop)
+    {
+      //Objects are allocated on one thread and released on another
+      //while the first is still allocating. The queue is bounded, so
+      //the two threads must run concurrently.
+      std::deque<ThreadLocal*> queue;
+      std::mutex mutex;
+      std::condition_variable notFull, notEmpty;
+      std::atomic<size_t> waiting(2);
+
+      auto barrier = [&]() 
+	{
+	  --waiting;
+	  while (waiting) std::this_thread::yield();
+	};
+
+      std::thread producer([&]() 
+			   { 
+			     barrier();
+			     for (size_t i = 0; i < N; ++i) 
+			       {
+				 ThreadLocal* obj = new ThreadLocal;
+				 obj->data[0] = i;
+				 std::unique_lock<std::mutex> lock(mutex);
+				 notFull.wait(lock, [&]() { return queue.size() < capacity; });
+				 queue.push_back(obj);
+				 notEmpty.notify_one();
+			       }
+			   });
+
+      bool corrupted = false;
+      std::thread consumer([&]() 
+			   {
+			     barrier();
+			     for (size_t i = 0; i < N; ++i)
+			       {
+				 ThreadLocal* obj;
+				 {
+				   std::unique_lock<std::mutex> lock(mutex);
+				   notEmpty.wait(lock, [&]() { return !queue.empty(); });
+				   obj = queue.front();
+				   queue.pop_front();
+				   notFull.notify_one();
+				 }
+				 corrupted = corrupted || (obj->data[0] != i);
+				 delete obj;
+			       }
+			   });
+
+      producer.join();
+      consumer.join();
+
+      if (corrupted)
+	throw std::runtime_error("Pool memory was corrupted");
+    }
+
+  //Containers using the pool allocator
+  std::list<size_t, magnet::memory::PoolAllocator<size_t> > list;
+  for (size_t i = 0; i < N; ++i)
+    list.push_back(i);
+
+  size_t sum = 0;
+  for (const size_t& val : list)
+    sum += val;
+  if (sum != N * (N - 1) / 2)
+    throw std::runtime_error("Pool allocated list was corrupted");
+}
+
+int main()
+{
+  testCrossThreadRelease();
+
+  std::cerr << "Threads   new/delete (ns)   PoolAllocated (ns)   ThreadLocalPoolAllocated (ns)\n";
+  for (size_t threads : {1, 2, 4, 8})
+    std::cerr << threads 
+	      << "   " << contendedAllocation<Plain>(threads)
+	      << "   " << contendedAllocation<Locked>(threads)
+	      << "   " << contendedAllocation<ThreadLocal>(threads)
+	      << "\n";
+
+  std::cerr << "Finished\n";
+  return 0;
+}
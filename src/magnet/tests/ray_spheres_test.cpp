@@ -0,0 +1,104 @@
+#define BOOST_TEST_MODULE Ray_spheres_test
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include <magnet/intersection/ray_sphere.hpp>
+#include <magnet/intersection/ray_spheres.hpp>
+#include <magnet/math/vector.hpp>
+#include <random>
+#include <vector>
+
+//This test is also built with -mavx2, to test the vectorised path
+bool canRun()
+{
+#ifdef __AVX2__
+  __builtin_cpu_init();
+  if (!__builtin_cpu_supports("avx2"))
+    {
+      BOOST_TEST_MESSAGE("The CPU does not support AVX2, skipping the test");
+      return false;
+    }
+#endif
+  return true;
+}
+
+void checkRaySpheres(const double* L)
+{
+  std::mt19937 RNG(1);
+  std::normal_distribution<> normal(0.0, 1.0);
+  std::uniform_real_distribution<> uniform(-1.0, 1.0);
+  std::uniform_real_distribution<> radius(0.05, 0.6);
+
+  size_t overlapping(0), receding(0), approaching(0);
+  //Batch sizes which are, and are not, multiples of the vector width
+  for (size_t N(0); N < 14; ++N)
+    for (size_t sample(0); sample < 200; ++sample)
+      {
+	std::vector<double> T[3], D[3];
+	std::vector<double> r(N), dt(N);
+	for (size_t iDim(0); iDim < 3; ++iDim)
+	  {
+	    T[iDim].resize(N);
+	    D[iDim].resize(N);
+	  }
+
+	for (size_t i(0); i < N; ++i)
+	  {
+	    r[i] = radius(RNG);
+	    //Origins up to three box lengths away test the periodic
+	    //images, and every fourth ray starts inside its sphere
+	    const double scale = (i % 4 == 3) ? 0.5 * r[i] : (L ? 3.0 : 2.0);
+	    for (size_t iDim(0); iDim < 3; ++iDim)
+	      {
+		T[iDim][i] = uniform(RNG) * scale * (L ? L[iDim] : 1.0);
+		D[iDim][i] = normal(RNG);
+	      }
+	  }
+
+	const double* Tptr[3] = {T[0].data(), T[1].data(), T[2].data()};
+	const double* Dptr[3] = {D[0].data(), D[1].data(), D[2].data()};
+	magnet::intersection::ray_spheres(Tptr, Dptr, r.data(), L, N, dt.data());
+
+	for (size_t i(0); i < N; ++i)
+	  {
+	    magnet::math::Vector Ti(T[0][i], T[1][i], T[2][i]), Di(D[0][i], D[1][i], D[2][i]);
+	    if (L)
+	      for (size_t iDim(0); iDim < 3; ++iDim)
+		Ti[iDim] -= L[iDim] * lrint(Ti[iDim] / L[iDim]);
+
+	    const double expected = magnet::intersection::ray_sphere(Ti, Di, r[i]);
+	    if (std::isinf(expected))
+	      {
+		BOOST_CHECK_EQUAL(dt[i], expected);
+		++receding;
+	      }
+	    else
+	      {
+		BOOST_CHECK_CLOSE(dt[i], expected, 1e-10);
+		if (Ti.nrm() < r[i])
+		  {
+		    BOOST_CHECK_EQUAL(dt[i], 0);
+		    ++overlapping;
+		  }
+		else
+		  ++approaching;
+	      }
+	  }
+      }
+
+  BOOST_CHECK(overlapping > 100);
+  BOOST_CHECK(receding > 1000);
+  BOOST_CHECK(approaching > 100);
+}
+
+BOOST_AUTO_TEST_CASE( ray_spheres_free )
+{
+  if (!canRun()) return;
+  checkRaySpheres(NULL);
+}
+
+BOOST_AUTO_TEST_CASE( ray_spheres_periodic )
+{
+  if (!canRun()) return;
+  const double L[3] = {1.0, 1.5, 2.0};
+  checkRaySpheres(L);
+}
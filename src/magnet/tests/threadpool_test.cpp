@@ -1,6 +1,9 @@
 #include <iostream>
 #include <vector>
 #include <stdexcept>
+#include <atomic>
+#include <chrono>
+#include <thread>
 #include <magnet/thread/threadpool.hpp>
 
 std::vector<float> sums;
@@ -33,6 +36,106 @@ struct A
   { std::cerr << "Inside memberfunc3, i=" << i << ", j=" << j << "\n"; }
 };
 
+//! Recursive parallel sum of [begin, end) using nested task groups
+long recursiveSum(magnet::thread::ThreadPool& pool, long begin, long end)
+{
+  if (end - begin < 64)
+    {
+      long sum = 0;
+      for (long i = begin; i < end; ++i)
+	sum += i;
+      return sum;
+    }
+
+  const long mid = begin + (end - begin) / 2;
+  long left = 0;
+  magnet::thread::ThreadPool::TaskGroup group(pool);
+  group.queueTask([&]() { left = recursiveSum(pool, begin, mid); });
+  const long right = recursiveSum(pool, mid, end);
+  group.wait();
+  return left + right;
+}
+
+double elapsed(std::chrono::steady_clock::time_point start)
+{ return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(); }
+
+void testTaskGroups(magnet::thread::ThreadPool& pool)
+{
+  //A group can be waited on while another group is still busy. This
+  //needs a worker to run the busy group's task.
+  if (pool.getThreadCount())
+    {
+      std::atomic<bool> started(false), release(false);
+      magnet::thread::ThreadPool::TaskGroup slow(pool);
+      slow.queueTask([&]() { started = true; while (!release) std::this_thread::yield(); });
+      while (!started) std::this_thread::yield();
+
+      std::atomic<int> count(0);
+      magnet::thread::ThreadPool::TaskGroup fast(pool);
+      for (int i = 0; i < 100; ++i)
+	fast.queueTask([&]() { ++count; });
+      fast.wait();
+
+      if ((count != 100) || (slow.pending() != 1))
+	throw std::runtime_error("Task group did not complete independently");
+
+      release = true;
+      slow.wait();
+    }
+
+  //Exceptions are reported to the waiting group
+  magnet::thread::ThreadPool::TaskGroup throwing(pool);
+  throwing.queueTask([]() { throw std::runtime_error("Expected exception"); });
+  bool caught = false;
+  try { throwing.wait(); } catch (std::exception&) { caught = true; }
+  if (!caught)
+    throw std::runtime_error("Task group did not rethrow a task exception");
+
+  //Nested groups, waited on from inside the tasks
+  const long N = 1 << 20;
+  if (recursiveSum(pool, 0, N) != N * (N - 1) / 2)
+    throw std::runtime_error("Muck up in the recursive sum");
+}
+
+void benchmark()
+{
+  const size_t hw = std::max(1u, std::thread::hardware_concurrency());
+  std::vector<size_t> threadCounts = {0, 1, 2, 4};
+  if (hw > 4) threadCounts.push_back(hw);
+
+  std::cerr << "Threads   Fine grained (us/task)   Recursive sum (ms)\n";
+  for (size_t threads : threadCounts)
+    for (bool pinned : {false, true})
+      {
+	if (pinned && !threads) continue;
+	magnet::thread::ThreadPool pool;
+	pool.setThreadPinning(pinned);
+	pool.setThreadCount(threads);
+
+	//Many tiny tasks queued from the main thread
+	const size_t tasks = 200000;
+	std::atomic<size_t> counter(0);
+	auto start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < tasks; ++i)
+	  pool.queueTask([&counter]() { ++counter; });
+	pool.wait();
+	const double fine = elapsed(start);
+	if (counter != tasks)
+	  throw std::runtime_error("Lost a task in the benchmark");
+
+	//Recursively generated work, which is stolen between workers
+	start = std::chrono::steady_clock::now();
+	const long N = 1 << 24;
+	if (recursiveSum(pool, 0, N) != N * (N - 1) / 2)
+	  throw std::runtime_error("Muck up in the recursive sum");
+	const double recursive = elapsed(start);
+
+	std::cerr << threads << (pinned ? " pinned" : "       ") 
+		  << "   " << 1e6 * fine / tasks
+		  << "   " << 1e3 * recursive << "\n";
+      }
+}
+
 int main()
 {
   int N = 1000;
@@ -94,6 +197,13 @@ int main()
 	}
     }
 
+  testTaskGroups(pool);
+
+  magnet::thread::ThreadPool serialPool;
+  testTaskGroups(serialPool);
+
+  benchmark();
+
   std::cerr << "Finished\n";
 
   return 0;